@@ -19,6 +19,9 @@
 #include "hap_resource.h"
 #include "res_desc.h"
 #include "lock.h"
+#include "utils/startup_profile.h"
+
+#include <atomic>
 
 #ifdef SUPPORT_GRAPHICS
 #include <unicode/plurrule.h>
@@ -29,6 +32,13 @@ namespace Global {
 namespace Resource {
 class HapManager {
 public:
+    /**
+     * The resources in the lookup order. A published list is not changed, the updates publish new ones, and a
+     * resource is released when the last list holding it is dropped, so the values found in a list stay valid
+     * while the list is held.
+     */
+    using Resources = std::vector<std::shared_ptr<const HapResource>>;
+
     /**
      * The constructor of HapManager
      */
@@ -61,41 +71,80 @@ public:
 
     /**
      * Add resource path to overlay paths
-     * @param path the resource path
+     * @param targetPath the resource path
      * @param overlayPaths the exist overlay resource path
      * @return true if add resource path success, else false
      */
-    bool AddResource(const std::string &path, const std::vector<std::string> &overlayPaths);
+    bool AddResource(const std::string &targetPath, const std::vector<std::string> &overlayPaths);
+
+    /**
+     * Add several resource paths to hap paths, the indexes are loaded in parallel
+     * @param paths the resource paths, the order of them is kept in the lookup order
+     * @return true if all the resource paths are added success, else false
+     */
+    bool AddResources(const std::vector<std::string> &paths);
+
+    /**
+     * Add an overlay to a loaded resource path, only the values of the ids in the overlay are resolved again
+     * @param targetPath the resource path the overlay applies to, it must be loaded
+     * @param overlayPath the overlay resource path
+     * @return true if the overlay is added success, else false
+     */
+    bool AddOverlay(const std::string &targetPath, const std::string &overlayPath);
+
+    /**
+     * Remove an overlay from a loaded resource path, only the values of the ids in the overlay are resolved again
+     * @param targetPath the resource path the overlay applies to
+     * @param overlayPath the overlay resource path
+     * @return true if the overlay is removed success, else false
+     */
+    bool RemoveOverlay(const std::string &targetPath, const std::string &overlayPath);
+
+    /**
+     * Get the resources published last
+     */
+    std::shared_ptr<const Resources> GetResources();
 
     /**
      * Find resource by resource id
      * @param id the resource id
+     * @param resources the resources to look up in, the current ones are set to it if it is null,
+     *                  the result is valid while it is held
      * @return the resources related to resource id
      */
-    const IdItem *FindResourceById(uint32_t id);
+    const IdItem *FindResourceById(uint32_t id, std::shared_ptr<const Resources> &resources);
 
     /**
      * Find resource by resource name
      * @param name the resource name
      * @param resType the resource type
+     * @param resources the resources to look up in, the current ones are set to it if it is null,
+     *                  the result is valid while it is held
      * @return the resources related to resource name
      */
-    const IdItem *FindResourceByName(const char *name, const ResType resType);
+    const IdItem *FindResourceByName(const char *name, const ResType resType,
+        std::shared_ptr<const Resources> &resources);
 
     /**
      * Find best resource path by resource id
      * @param id the resource id
+     * @param resources the resources to look up in, the current ones are set to it if it is null,
+     *                  the result is valid while it is held
      * @return the best resource path
      */
-    const HapResource::ValueUnderQualifierDir *FindQualifierValueById(uint32_t id);
-    
+    const HapResource::ValueUnderQualifierDir *FindQualifierValueById(uint32_t id,
+        std::shared_ptr<const Resources> &resources);
+
     /**
      * Find best resource path by resource name
      * @param name the resource name
      * @param resType the resource type
+     * @param resources the resources to look up in, the current ones are set to it if it is null,
+     *                  the result is valid while it is held
      * @return the best resource path
      */
-    const HapResource::ValueUnderQualifierDir *FindQualifierValueByName(const char *name, const ResType resType);
+    const HapResource::ValueUnderQualifierDir *FindQualifierValueByName(const char *name, const ResType resType,
+        std::shared_ptr<const Resources> &resources);
 
     /**
      * Find the raw file path
@@ -105,6 +154,54 @@ public:
      */
     RState FindRawFile(const std::string &name, std::string &outValue);
 
+    struct RawFileLocation {
+        // the raw file path, or the hap path when the raw file is an entry of a hap
+        std::string path;
+
+        // the offset where the raw file data starts in path
+        uint64_t offset = 0;
+
+        // the length of the raw file
+        uint64_t length = 0;
+
+        // the hap and its entry, nullptr when the raw file is on the disk
+        std::shared_ptr<ZipArchive> archive;
+
+        const ZipArchive::Entry *entry = nullptr;
+    };
+
+    /**
+     * Find the raw file on the disk or inside the loaded haps, a raw file not in the indexes is looked up again after
+     * the indexes of the changed directories on the disk are rebuilt
+     * @param name the resource name
+     * @param location where the raw file is
+     * @return SUCCESS if find the raw file success, else NOT_FOUND
+     */
+    RState FindRawFile(const std::string &name, RawFileLocation &location);
+
+    /**
+     * Find several raw files in one pass over the loaded resources
+     * @param names the raw file names
+     * @param locations where the raw files are, the path is empty for the ones not found
+     * @return SUCCESS if all raw files are found, else NOT_FOUND
+     */
+    RState FindRawFiles(const std::vector<std::string> &names, std::vector<RawFileLocation> &locations);
+
+    /**
+     * List the raw files of a directory in the loaded resources, from the indexes of the raw files. The indexes of
+     * the changed directories on the disk are rebuilt first
+     * @param dirName the directory name, relative to the rawfile directory
+     * @param recursive whether the files of the sub directories are listed
+     * @param names the file names, such as "rawfile/sub/a.txt"
+     * @return SUCCESS if the directory is found, else NOT_FOUND
+     */
+    RState ListRawFiles(const std::string &dirName, bool recursive, std::vector<std::string> &names);
+
+    /**
+     * Rebuild the indexes of the raw files, a file removed from the disk is still found until then
+     */
+    void RescanRawFiles();
+
     /**
      * Get the language pluralRule related to quantity
      * @param quantity the language quantity
@@ -117,6 +214,49 @@ public:
      */
     std::vector<std::string> GetResourcePaths();
 
+    /**
+     * Get the heap bytes held by the loaded resources and the caches of the manager
+     * @param report the usage of each resource is appended to it, and the total is added to
+     */
+    void GetMemoryUsage(MemoryReport &report);
+
+    /**
+     * Drop the caches of the manager and of the loaded resources
+     * @param level the trim level
+     */
+    void Trim(TrimLevel level);
+
+    /**
+     * Check the loaded files when the resources are looked up, at most once a second, the changed ones are
+     * reloaded as by ReloadChanged(). A lookup skips the check while an update is in progress
+     * @param enabled whether the files are checked
+     */
+    void SetAutoReload(bool enabled);
+
+    /**
+     * Reload the resources whose files were changed after they were loaded, a target is reloaded with its
+     * overlays, only the resolved values of the ids whose values changed are dropped
+     * @return true if any resource is reloaded
+     */
+    bool ReloadChanged();
+
+    /**
+     * Get the profile the lookups of the start are recorded in
+     */
+    inline StartupProfile &GetStartupProfile()
+    {
+        return startupProfile_;
+    }
+
+    /**
+     * Get the generation of the resources, it changes whenever the resources or the config are changed,
+     * so the values resolved at the same generation are still valid
+     */
+    inline uint32_t GetGeneration() const
+    {
+        return generation_.load(std::memory_order_acquire);
+    }
+
 private:
     void UpdateResConfigImpl(ResConfigImpl &resConfig);
 
@@ -126,10 +266,49 @@ private:
 
     std::vector<const HapResource::IdValues *> GetResourceListByName(const char *name, const ResType resType) const;
 
+    static std::vector<const HapResource::IdValues *> GetResourceList(const Resources &resources, uint32_t ident);
+
+    static std::vector<const HapResource::IdValues *> GetResourceListByName(const Resources &resources,
+        const char *name, const ResType resType);
+
+    // the value of an overlay wins over the values of its target, called with lock_ held
+    const HapResource::ValueUnderQualifierDir *FindBestQualifierValue(
+        const std::vector<const HapResource::IdValues *> &candidates) const;
+
     bool AddResourcePath(const char *path);
 
-    // when resConfig_ updated we must call ReloadAll()
-    RState ReloadAll();
+    // drop the resolved values of the ids of resource, called with lock_ held
+    void InvalidateIds(const HapResource *resource);
+
+    // replace the resources, the old ones are returned so they are released out of lock_, called with lock_ held
+    std::shared_ptr<const Resources> Publish(std::shared_ptr<const Resources> resources);
+
+    // called on the lookups, reload the changed files if the auto reload is enabled and it is time to check
+    void CheckChanged();
+
+    // the body of ReloadChanged(), called with updateLock_ held
+    bool ReloadChangedLocked();
+
+    std::vector<std::string> GetLoadOrder() const;
+
+    RState FindRawFileLocation(const std::string &name, RawFileLocation &location, bool includeHap);
+
+    static bool LookupRawFile(const Resources &resources, const std::string &rawFileName, RawFileLocation &location,
+        bool includeHap);
+
+    static void LookupRawFiles(const Resources &resources, const std::vector<std::string> &rawFileNames,
+        std::vector<bool> &pending, size_t &remaining, std::vector<RawFileLocation> &locations);
+
+    // the stat of the directories of an index is only paid on a miss or a list
+    static bool RescanChangedRawFiles(const Resources &resources);
+
+    static std::string GetRawFileName(const std::string &name);
+
+    static bool GetRawFileLocation(const HapResource *resource, const RawFileIndex &index, const std::string &name,
+        const RawFileIndex::File &file, RawFileLocation &location);
+
+    // when resConfig_ updated we must call ReloadAll(), the caller publishes newResources
+    RState ReloadAll(const ResConfigImpl *resConfig, Resources &newResources);
 
     static bool Init();
 
@@ -138,18 +317,37 @@ private:
     // app res config
     ResConfigImpl *resConfig_;
 
-    // set of hap Resources
-    std::vector<HapResource *> hapResources_;
+    // set of hap Resources, the readers hold the list they look up in
+    std::shared_ptr<const Resources> hapResources_;
 
-    // set of loaded hap path
+    // set of loaded hap path, keyed by the canonical path of the target
     std::unordered_map<std::string, std::vector<std::string>> loadedHapPaths_;
 
+    // the best value of an id in hapResources_ under resConfig_, cleared whenever they are published
+    std::unordered_map<uint32_t, const HapResource::ValueUnderQualifierDir *> idValueCache_;
+
 #ifdef SUPPORT_GRAPHICS
     // key is language
     std::vector<std::pair<std::string, icu::PluralRules *>> plurRulesCache_;
 #endif
 
+    // guards resConfig_, hapResources_, loadedHapPaths_ and idValueCache_, held only to read or publish them
     Lock lock_;
+
+    // serializes the updates, loading is done under this lock only so readers are not blocked
+    Lock updateLock_;
+
+    // increased after the resources or the config are published
+    std::atomic<uint32_t> generation_{0};
+
+    // whether CheckChanged() looks at the files
+    std::atomic<bool> autoReload_{false};
+
+    // the steady clock time of the last check in milliseconds
+    std::atomic<int64_t> lastCheckTime_{0};
+
+    // the ids and names looked up after the start, it records nothing until it is started
+    StartupProfile startupProfile_;
 };
 } // namespace Resource
 } // namespace Global
@@ -21,6 +21,7 @@
 #include <string>
 #include "res_desc.h"
 #include "res_config_impl.h"
+#include "utils/zip_archive.h"
 
 namespace OHOS {
 namespace Global {
@@ -50,16 +51,35 @@ public:
     static int32_t ReadIndexFromFile(const char *zipFile, void **buffer,
                                      size_t &bufLen, std::string &errInfo);
 
+    /**
+     * Read resource.index in hap without copy, the hap is opened and its directory parsed only once
+     * @param zipFile hap file path
+     * @param errInfo the error info when failed
+     * @return the content of resource.index if success, else nullptr. The caller should delete it
+     */
+    static ZipArchive::View *ReadIndexFromFile(const char *zipFile, std::string &errInfo);
+
+    /**
+     * Get the name of resource.index inside the hap, the module name is read from config.json
+     * @param archive the hap
+     * @param name the entry name, such as "assets/entry/resources.index"
+     * @param errInfo the error info when failed
+     * @return OK if success, else UNKNOWN_ERROR
+     */
+    static int32_t GetIndexEntryName(const ZipArchive &archive, std::string &name, std::string &errInfo);
+
     /**
      * Parse resource hex to resDesc
      * @param buffer the resource bytes
      * @param bufLen length in bytes
-     * @param resDesc index file in hap
+     * @param resDesc index file in hap, the long strings are compressed when its longStrings_ is set. The strings
+     *                of a version 2 index are read in place, buffer must be kept while resDesc is used
      * @param defaultConfig the default config
+     * @param parallel parse the IDSS blocks of different keys on the thread pool
      * @return OK if the resource hex parse success, else SYS_ERROR
      */
     static int32_t ParseResHex(const char *buffer, const size_t bufLen, ResDesc &resDesc,
-                               const ResConfigImpl *defaultConfig = nullptr);
+                               const ResConfigImpl *defaultConfig = nullptr, bool parallel = false);
 
     /**
      * Create resource config from KeyParams
@@ -112,6 +132,8 @@ public:
 
 private:
     static const char *RES_FILE_NAME;
+
+    static int32_t CopyView(const ZipArchive::View &view, void **buffer, size_t &bufLen, std::string &errInfo);
 };
 } // namespace Resource
 } // namespace Global
@@ -16,11 +16,17 @@
 #define RESOURCE_MANAGER_HAPRESOURCE_H
 
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <time.h>
 #include <unordered_map>
 #include "res_desc.h"
+#include "lock.h"
 #include "res_config_impl.h"
+#include "utils/memory_usage.h"
+#include "utils/raw_file_index.h"
+#include "utils/zip_archive.h"
 
 namespace OHOS {
 namespace Global {
@@ -34,7 +40,7 @@ public:
     /**
      * Creates an HapResource.
      *
-     * @param path resources.index file path
+     * @param path resources.index file path, a path ending with ".hap" is loaded by LoadFromHap
      * @param defaultConfig  match defaultConfig to keys of index file, only parse the matched keys.
      *                       'null' means parse all keys.
      * @param system If `system` is true, the package is marked as a system package, and allows some functions to
@@ -43,6 +49,16 @@ public:
      */
     static const HapResource *LoadFromIndex(const char *path, const ResConfigImpl *defaultConfig, bool system = false);
 
+    /**
+     * Creates an HapResource from the resources.index inside a hap file, the index is not copied out of the hap.
+     *
+     * @param path hap file path
+     * @param defaultConfig  match defaultConfig to keys of index file, only parse the matched keys.
+     *                       'null' means parse all keys.
+     * @return the HapResource if success, else nullptr
+     */
+    static const HapResource *LoadFromHap(const char *path, const ResConfigImpl *defaultConfig);
+
     /**
      * Load overlay resources
      * @param path the resources.index file path
@@ -53,6 +69,54 @@ public:
     static const std::unordered_map<std::string, HapResource *> LoadOverlays(const std::string &path,
         const std::vector<std::string> &overlayPath, const ResConfigImpl *defaultConfig);
 
+    /**
+     * Load a HapResource shared in the process. The loads of the same file, not modified since, with the
+     * same locale get the same HapResource, it is deleted when the last of them releases it.
+     *
+     * @param path resources.index file path or hap file path
+     * @param defaultConfig match defaultConfig to keys of index file, only the locale of it is used
+     * @return the HapResource if success, else nullptr, it must be released by Release()
+     */
+    static const HapResource *Acquire(const char *path, const ResConfigImpl *defaultConfig);
+
+    /**
+     * Load an overlay of target, its ids are remapped to the ids of the same name and type in target
+     * @param path the resources.index file path of the overlay
+     * @param target the target of the overlay
+     * @param defaultConfig the default config
+     * @return the overlay if success, else nullptr, it must be released by Release()
+     */
+    static const HapResource *LoadOverlay(const std::string &path, const HapResource &target,
+        const ResConfigImpl *defaultConfig);
+
+    /**
+     * Release a HapResource got by Acquire, the ones not shared, such as the overlays, are deleted
+     *
+     * @param resource the HapResource
+     */
+    static void Release(const HapResource *resource);
+
+    /**
+     * Get the number of the HapResources shared in the process
+     */
+    static size_t GetSharedCount();
+
+    /**
+     * Get the canonical path of a file, the paths of the same file get the same one
+     *
+     * @param path the file path
+     * @return the canonical path, or path if it can not be resolved
+     */
+    static std::string GetCanonicalPath(const std::string &path);
+
+    /**
+     * Keep the string values of at least threshold bytes compressed, they are inflated when read. It applies to
+     * the indexes loaded afterwards, the ones already loaded, such as the shared ones, are kept as they are.
+     *
+     * @param threshold the min length of the values to compress, 0 to not compress
+     */
+    static void SetLongStringThreshold(size_t threshold);
+
     /**
      * The destructor of HapResource
      */
@@ -66,6 +130,61 @@ public:
         return indexPath_;
     }
 
+    /**
+     * Get the last modification time of the file when it was loaded
+     */
+    inline time_t GetLastModTime() const
+    {
+        return lastModTime_;
+    }
+
+    /**
+     * Whether the file was changed on the disk after it was loaded, the check is a stat of the file. The mod time
+     * with the nanoseconds, the size and the inode are compared
+     */
+    bool IsChanged() const;
+
+    /**
+     * Whether the resources are read from a hap file, then GetIndexPath() is the hap path
+     */
+    inline bool IsHap() const
+    {
+        return archive_ != nullptr;
+    }
+
+    /**
+     * Get the hap the resources are read from, nullptr if they are on the disk
+     */
+    inline const std::shared_ptr<ZipArchive> &GetZipArchive() const
+    {
+        return archive_;
+    }
+
+    /**
+     * Get the prefix of the resource entries inside the hap, such as "assets/entry/resources/"
+     */
+    inline const std::string &GetResourcesEntryPrefix() const
+    {
+        return resourcesEntryPrefix_;
+    }
+
+    /**
+     * Get the index of the raw files, it is built on the first call and kept until RescanRawFiles()
+     * @return the index, nullptr if out of memory
+     */
+    std::shared_ptr<const RawFileIndex> GetRawFileIndex() const;
+
+    /**
+     * Rebuild the index of the raw files, the ones got before stay valid
+     */
+    void RescanRawFiles() const;
+
+    /**
+     * Rebuild the index of the raw files if its directories on the disk have changed
+     * @return true if the index is rebuilt
+     */
+    bool RescanRawFilesIfChanged() const;
+
     /**
      * Get the resource path
      */
@@ -114,6 +233,13 @@ public:
             return isOverlay_;
         }
 
+        /**
+         * Get the value of the IdItem, a compressed one is inflated by the HapResource it belongs to
+         * @param holder holds the inflated value
+         * @return the value, a compressed one is valid while holder is held
+         */
+        std::string_view GetValue(std::shared_ptr<const std::string> &holder) const;
+
         ValueUnderQualifierDir(const std::vector<KeyParam *> &keyParams, IdItem *idItem,
             HapResource *hapResource, bool isOverlay = false);
 
@@ -194,12 +320,40 @@ public:
         return idValuesMap_.size();
     }
 
+    /**
+     * Get the ids of the resources
+     * @param ids the ids are appended to it
+     */
+    void GetIds(std::vector<uint32_t> &ids) const;
+
+    /**
+     * Get the heap bytes held by the resources, the parsed index is measured once as it does not change
+     * @param usage the bytes are added to it
+     */
+    void GetMemoryUsage(MemoryUsage &usage) const;
+
+    /**
+     * Drop the caches of the resources, such as the inflated long strings
+     */
+    void TrimCaches() const;
+
+    /**
+     * Get the store the long string values are compressed by, nullptr if they are not
+     */
+    const LongStringStore *GetLongStrings() const;
+
 private:
     HapResource(const std::string path, time_t lastModTime, const ResConfig *defaultConfig, ResDesc *resDes);
 
-    std::unordered_map<std::string, std::unordered_map<ResType, uint32_t>> BuildNameTypeIdMapping() const;
+    // owner holds buffer, it is kept by a version 2 index which is read in place
+    static HapResource *LoadFromBuffer(const std::string &path, const char *buffer, size_t bufLen,
+        const ResConfigImpl *defaultConfig, std::shared_ptr<const void> owner);
 
-    void UpdateOverlayInfo(std::unordered_map<std::string, std::unordered_map<ResType, uint32_t>> &nameTypeId);
+    // the values of a name, from the names table of a version 2 index or from idValuesNameMap_
+    const IdValues *FindIdValuesByName(const std::string &name, ResType resType) const;
+
+    // remap the ids of this overlay to the ids of the same name and type in target
+    void UpdateOverlayInfo(const HapResource &target);
 
     // must call Init() after constructor
     bool Init();
@@ -207,26 +361,56 @@ private:
     // step of Init(), called in Init()
     bool InitIdList();
 
+    // called with rawFileIndexLock_ held
+    void RescanRawFilesLocked() const;
+
+    // measure the parsed index, except the raw file index
+    MemoryUsage MeasureIndex() const;
+
     // resources.index file path
     const std::string indexPath_;
 
     // resource path , calculated from indexPath_
     std::string resourcePath_;
 
-    // last mod time of hap file
+    // last mod time of the index or hap file, taken when it is loaded
     time_t lastModTime_;
 
+    // the mod time with the nanoseconds, the size and the inode of the file, taken when it is loaded
+    std::string fileStamp_;
+
     // resource information stored in resDesc_
     ResDesc *resDesc_;
 
     std::map<uint32_t, IdValues *> idValuesMap_;
 
+    // the values of an overlay which are not in its target, removed from idValuesMap_ by UpdateOverlayInfo
+    std::vector<IdValues *> unmatchedIdValues_;
+
     // the key is name, each restype holds one map
     // name may conflict in same restype !
     std::vector<std::map<std::string, IdValues *> *> idValuesNameMap_;
 
+    // the names are found by the names table of the version 2 index, idValuesNameMap_ is empty
+    bool namesInIndex_ = false;
+
     // default resconfig
     const ResConfig *defaultConfig_;
+
+    // the hap file when loaded by LoadFromHap, it holds the fd the raw files are read from
+    std::shared_ptr<ZipArchive> archive_;
+
+    std::string resourcesEntryPrefix_;
+
+    // guards rawFileIndex_
+    mutable Lock rawFileIndexLock_;
+
+    mutable std::shared_ptr<const RawFileIndex> rawFileIndex_;
+
+    // the usage of the parsed index, measured by the first GetMemoryUsage()
+    mutable std::once_flag indexUsageOnce_;
+
+    mutable MemoryUsage indexUsage_;
 };
 } // namespace Resource
 } // namespace Global
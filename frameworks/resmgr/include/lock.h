@@ -27,6 +27,9 @@ public:
 
     bool lock();
 
+    // lock it if no one holds it, else return false without waiting
+    bool try_lock();
+
     bool unlock();
 
 private:
@@ -18,9 +18,11 @@
 
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 #include "res_common.h"
+#include "utils/string_pool.h"
 
 namespace OHOS {
 namespace Global {
@@ -44,6 +46,8 @@ typedef struct ResHeader {
     uint32_t keyCount_;
 } ResHeader;
 
+class LongStringStore;
+
 class IdItem {
 public:
     static const uint32_t HEADER_LEN = 12;
@@ -83,18 +87,31 @@ public:
      * @param id      when return true, set id. as sample : 16777225
      * @return        true: value is ref
      */
-    static bool IsRef(const std::string &value, ResType &resType, int &id);
+    static bool IsRef(std::string_view value, ResType &resType, int &id);
 
     std::string ToString() const;
 
+    /**
+     * Get the value, a compressed one is inflated
+     * @param longStrings the store of the ResDesc the IdItem is in, the compressed values are inflated by it
+     * @param holder holds the inflated value
+     * @return the value, a compressed one is valid while holder is held
+     */
+    std::string_view GetValue(const LongStringStore *longStrings, std::shared_ptr<const std::string> &holder) const;
+
     uint32_t size_;
     ResType resType_;
     uint32_t id_;
     uint16_t valueLen_;
     bool isArray_ = false;
-    std::string value_;
-    std::vector<std::string> values_;
-    std::string name_;
+
+    // value_ is compressed by the LongStringStore of the ResDesc, valueLen_ is the length of the value
+    bool isCompressed_ = false;
+
+    // the strings are interned in the pool of the ResDesc, they are null terminated
+    std::string_view value_;
+    std::vector<std::string_view> values_;
+    std::string_view name_;
 
 private:
     static bool sInit;
@@ -187,6 +204,9 @@ public:
     // the resource ID data
     ResId *resId_;
 };
+
+class IndexV2;
+
 /**
  * a ResDesc means a index file in hap zip
  */
@@ -201,6 +221,18 @@ public:
     ResHeader *resHeader_;
 
     std::vector<ResKey *> keys_;
+
+    // the names and values of the IdItems, each distinct string is stored once
+    StringPool stringPool_;
+
+    // the long string values are compressed by it, nullptr if they are not
+    LongStringStore *longStrings_;
+
+    // the version 2 index the strings are read in place from, nullptr for version 1
+    IndexV2 *indexV2_;
+
+    // keeps the buffer of indexV2_
+    std::shared_ptr<const void> buffer_;
 };
 } // namespace Resource
 } // namespace Global
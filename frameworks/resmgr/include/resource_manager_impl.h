@@ -15,11 +15,15 @@
 #ifndef OHOS_RESOURCE_MANAGER_RESOURCEMANAGERIMPL_H
 #define OHOS_RESOURCE_MANAGER_RESOURCEMANAGERIMPL_H
 
+#include <condition_variable>
 #include <map>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
 #include "hap_manager.h"
 #include "resource_manager.h"
+#include "utils/raw_file_descriptor_cache.h"
 
 namespace OHOS {
 namespace Global {
@@ -34,7 +38,8 @@ public:
 
     /**
      * Add resource path to hap paths
-     * @param path the resource path
+     * @param path the resource path, the index file or a hap file. The media and profiles of a hap file are not
+     *     files on the disk, GetMediaById and the like fail on them, the raw files are read in place
      * @return true if add resource path success, else false
      */
     virtual bool AddResource(const char *path);
@@ -47,6 +52,55 @@ public:
      */
     virtual bool AddResource(const std::string &path, const std::vector<std::string> &overlayPaths);
 
+    /**
+     * Add an overlay to a loaded resource path without reloading the other resources
+     * @param path the resource path the overlay applies to, it must be loaded
+     * @param overlayPath the overlay resource path
+     * @return true if the overlay is added success, else false
+     */
+    virtual bool AddOverlay(const std::string &path, const std::string &overlayPath);
+
+    /**
+     * Remove an overlay from a loaded resource path without reloading the other resources
+     * @param path the resource path the overlay applies to
+     * @param overlayPath the overlay resource path
+     * @return true if the overlay is removed success, else false
+     */
+    virtual bool RemoveOverlay(const std::string &path, const std::string &overlayPath);
+
+    /**
+     * Get the heap bytes held by the resources and the caches, it is cheap enough to be called periodically
+     * @param report the usage of each loaded resource and the total
+     */
+    virtual void GetMemoryUsage(MemoryReport &report);
+
+    /**
+     * Shrink the manager, such as when the app goes to the background or under memory pressure, the dropped
+     * caches are filled again by the lookups
+     * @param level the trim level, TRIM_ALL also returns the free heap to the system. The resources replaced
+     *        by the updates are released by the last reader holding them, not by it
+     */
+    virtual void Trim(TrimLevel level);
+
+    /**
+     * Check the loaded files when the resources are looked up, at most once a second, and reload the changed ones
+     * @param enabled whether the files are checked
+     */
+    virtual void SetAutoReload(bool enabled);
+
+    /**
+     * Reload the resources whose files were changed after they were loaded
+     * @return true if any resource is reloaded
+     */
+    virtual bool ReloadChanged();
+
+    /**
+     * Add several resource paths to hap paths, the indexes are loaded in parallel
+     * @param paths the resource paths
+     * @return true if all the resource paths are added success, else false
+     */
+    virtual bool AddResources(const std::vector<std::string> &paths);
+
     /**
      * Update the resConfig
      * @param resConfig the resource config
@@ -54,6 +108,34 @@ public:
      */
     virtual RState UpdateResConfig(ResConfig &resConfig);
 
+    /**
+     * Add resource path to hap paths on a background thread
+     * @param path the resource path
+     * @return the future of the result, true if add resource path success, else false
+     */
+    virtual std::future<bool> AddResourceAsync(const std::string &path);
+
+    /**
+     * Add resource path to hap paths on a background thread
+     * @param path the resource path
+     * @param callback called on the background thread with the result, it must not delete this manager
+     */
+    virtual void AddResourceAsync(const std::string &path, const std::function<void(bool)> &callback);
+
+    /**
+     * Update the resConfig on a background thread, the old resources are readable until the new ones are ready
+     * @param resConfig the resource config, it is copied before return
+     * @return the future of the result, SUCCESS if the resConfig updated success, else HAP_INIT_FAILED
+     */
+    virtual std::future<RState> UpdateResConfigAsync(ResConfig &resConfig);
+
+    /**
+     * Update the resConfig on a background thread, the old resources are readable until the new ones are ready
+     * @param resConfig the resource config, it is copied before return
+     * @param callback called on the background thread with the result, it must not delete this manager
+     */
+    virtual void UpdateResConfigAsync(ResConfig &resConfig, const std::function<void(RState)> &callback);
+
     /**
      * Get the resConfig
      * @param resConfig the resource config
@@ -278,7 +360,8 @@ public:
      * Get the PROF resource by resource id
      * @param id the resource id
      * @param outValue the obtain resource path write to
-     * @return SUCCESS if resource exist, else NOT_FOUND
+     * @return SUCCESS if resource exist, ERROR if it is in a hap added by the hap path, it has no file path, else
+     *     NOT_FOUND
      */
     virtual RState GetProfileById(uint32_t id, std::string &outValue);
 
@@ -286,7 +369,8 @@ public:
      * Get the PROF resource by resource name
      * @param name the resource name
      * @param outValue the obtain resource path write to
-     * @return SUCCESS if resource exist, else NOT_FOUND
+     * @return SUCCESS if resource exist, ERROR if it is in a hap added by the hap path, it has no file path, else
+     *     NOT_FOUND
      */
     virtual RState GetProfileByName(const char *name, std::string &outValue);
 
@@ -294,7 +378,8 @@ public:
      * Get the MEDIA resource by resource id
      * @param id the resource id
      * @param outValue the obtain resource path write to
-     * @return SUCCESS if resource exist, else NOT_FOUND
+     * @return SUCCESS if resource exist, ERROR if it is in a hap added by the hap path, it has no file path, else
+     *     NOT_FOUND
      */
     virtual RState GetMediaById(uint32_t id, std::string &outValue);
 
@@ -302,7 +387,8 @@ public:
      * Get the PROF resource by resource name
      * @param name the resource name
      * @param outValue the obtain resource path write to
-     * @return SUCCESS if resource exist, else NOT_FOUND
+     * @return SUCCESS if resource exist, ERROR if it is in a hap added by the hap path, it has no file path, else
+     *     NOT_FOUND
      */
     virtual RState GetMediaByName(const char *name, std::string &outValue);
 
@@ -315,7 +401,40 @@ public:
     virtual RState GetRawFilePathByName(const std::string &name, std::string &outValue);
 
     /**
-     * Get the rawFile descriptor by resource name
+     * Get where the raw file is, it may be a file on the disk or an entry inside a hap
+     * @param name the raw file name
+     * @param location the raw file path, offset and length
+     * @return SUCCESS if the raw file is found, else NOT_FOUND
+     */
+    RState GetRawFileLocation(const std::string &name, HapManager::RawFileLocation &location);
+
+    /**
+     * Get where several raw files are, they are looked up together
+     * @param names the raw file names
+     * @param locations the raw file locations, the path is empty for the ones not found
+     * @return SUCCESS if all raw files are found, else NOT_FOUND
+     */
+    RState GetRawFileLocations(const std::vector<std::string> &names,
+        std::vector<HapManager::RawFileLocation> &locations);
+
+    /**
+     * Get the raw file names of a directory, only the mod times of the directories on the disk are checked once the
+     * directory was listed
+     * @param dirName the directory name, relative to the rawfile directory
+     * @param recursive whether the files of the sub directories are listed
+     * @param names the raw file names, such as "rawfile/sub/a.txt"
+     * @return SUCCESS if the directory is found, else NOT_FOUND
+     */
+    RState GetRawFileList(const std::string &dirName, bool recursive, std::vector<std::string> &names);
+
+    /**
+     * Scan the raw files again. The added files are found without it, the removed ones are still found until then
+     */
+    void RescanRawFiles();
+
+    /**
+     * Get the rawFile descriptor by resource name, a raw file stored uncompressed in a hap gets
+     * the fd of the hap with the offset and length of the entry
      * @param name the resource name
      * @param descriptor the obtain raw file member fd, length, offet write to
      * @return SUCCESS if resource exist, else ERROR
@@ -323,20 +442,48 @@ public:
     virtual RState GetRawFileDescriptor(const std::string &name, RawFileDescriptor &descriptor);
 
     /**
-     * Close rawFile descriptor by resource name
+     * Close rawFile descriptor by resource name, it releases one get of the name. The fd is shared by the
+     * holders of the raw files in the same file, it stays open while anyone holds it
      * @param name the resource name
      * @return SUCCESS if close the rawFile descriptor, else ERROR
      */
     virtual RState CloseRawFileDescriptor(const std::string &name);
 
+    /**
+     * Set the limits of the raw file descriptors, the descriptors no one holds are closed to meet them
+     * @param maxOpenFiles the max number of files open at the same time
+     * @param maxEntries the max number of raw file names whose descriptors are kept
+     */
+    void SetRawFileDescriptorLimits(size_t maxOpenFiles, size_t maxEntries);
+
+    /**
+     * Record the ids, names and raw files looked up in the next durationMs, and save them to profilePath on a
+     * worker thread after the first lookup past that time, or when the manager is destroyed before any. The
+     * profile saved by the last start is replayed first on a worker thread: the values are read from the indexes
+     * and resolved into the cache, and the raw file descriptors are opened, so the lookups of the start find them
+     * ready. Call it once after the resources of the app are added
+     * @param profilePath the profile file, such as in the data directory of the app
+     * @param durationMs how long the lookups are recorded
+     * @return false if it is already started
+     */
+    bool StartStartupProfile(const std::string &profilePath, uint32_t durationMs);
+
     /**
      * Get all resource paths
      * @return The vector of resource paths
      */
     std::vector<std::string> GetResourcePaths();
 
+    /**
+     * Get the generation of the resources and the config, the values got at the same generation
+     * are the same
+     * @param generation the generation, it changes after each AddResource and UpdateResConfig
+     * @return true, the generation is always tracked
+     */
+    virtual bool GetGeneration(uint32_t &generation);
+
 private:
-    RState GetString(const IdItem *idItem, std::string &outValue);
+    RState GetString(const HapResource::ValueUnderQualifierDir *vuqd, std::string &outValue);
 
     RState GetStringArray(const IdItem *idItem, std::vector<std::string> &outValue);
 
@@ -346,7 +493,7 @@ private:
 
     RState GetPluralString(const HapResource::ValueUnderQualifierDir *vuqd, int quantity, std::string &outValue);
 
-    RState ResolveReference(const std::string value, std::string &outValue);
+    RState ResolveReference(std::string_view value, std::string &outValue);
 
     RState GetBoolean(const IdItem *idItem, bool &outValue);
 
@@ -366,8 +513,22 @@ private:
 
     RState ResolveParentReference(const IdItem *idItem, std::map<std::string, std::string> &outValue);
 
+    void PostTask(const std::function<void()> &task);
+
+    void ReplayStartupProfile(const std::vector<StartupProfile::Entry> &entries);
+
+    // read the value of vuqd with the values it refers to
+    void PrewarmValue(const HapResource::ValueUnderQualifierDir *vuqd);
+
     HapManager *hapManager_;
 
+    // the number of async tasks not finished yet, the destructor waits for them
+    size_t pendingTasks_ = 0;
+
+    std::mutex pendingMutex_;
+
+    std::condition_variable pendingCond_;
+
     float fontRatio_ = 0.0f;
 
     const std::string VIRTUAL_PIXEL = "vp";
@@ -376,7 +537,8 @@ private:
 
     const float DEFAULT_DENSITY = 160.0f;
 
-    std::unordered_map<std::string, RawFileDescriptor> rawFileDescriptor_;
+    // the descriptors handed out by GetRawFileDescriptor, shared by the holders of a name
+    RawFileDescriptorCache rawFileDescriptors_;
 };
 } // namespace Resource
 } // namespace Global
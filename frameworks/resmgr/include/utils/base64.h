@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_RESOURCE_MANAGER_BASE64_H
+#define OHOS_RESOURCE_MANAGER_BASE64_H
+
+#include <cstddef>
+#include <string>
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+/**
+ * The standard base64 encoding with padding. The bulk of the input is encoded with the SIMD
+ * instructions the cpu supports, chosen at runtime on x86, and the tail with the scalar code.
+ */
+class Base64 {
+public:
+    /**
+     * Get the length of the encoding of len bytes
+     */
+    static size_t EncodedLength(size_t len);
+
+    /**
+     * Encode data to dst
+     * @param data the input
+     * @param len the length of data
+     * @param dst the output, at least EncodedLength(len) chars, it is not null terminated
+     * @return the number of chars written
+     */
+    static size_t Encode(const char *data, size_t len, char *dst);
+
+    /**
+     * Append the encoding of data to out
+     * @param data the input
+     * @param len the length of data
+     * @param out the string appended to
+     */
+    static void Encode(const char *data, size_t len, std::string &out);
+
+    /**
+     * Encode data with the scalar code only, for the test of the SIMD code
+     */
+    static size_t EncodeScalar(const char *data, size_t len, char *dst);
+};
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
+#endif
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_RESOURCE_MANAGER_INDEX_V2_H
+#define OHOS_RESOURCE_MANAGER_INDEX_V2_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "res_desc.h"
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+/**
+ * The version 2 of resources.index, it is read in place. It starts with the ResHeader of version 1, its
+ * version_ starts with VERSION_PREFIX, then the Header of version 2 locating the tables. Every table and
+ * every string is 4 bytes aligned, the numbers are in the byte order of the device.
+ *
+ * - keys: the qualifier directories, each is a range of the key params, its packed signature
+ * - ids: sorted by id, each has the range of its variants
+ * - variants: the value of an id under a qualifier directory
+ * - arrays: the string offsets of the values of the array variants
+ * - names: a hash table of (type, name) to the index in ids, open addressing with linear probing
+ * - strings: each is its uint32_t length, the bytes and '\0', padded to 4 bytes, they are referred by offset
+ */
+class IndexV2 {
+public:
+    static constexpr const char *VERSION_PREFIX = "ResIndex 2.";
+
+    static constexpr const char *VERSION = "ResIndex 2.0";
+
+    static constexpr uint32_t ALIGNMENT = 4;
+
+    // a bucket of the names table which is empty
+    static constexpr uint32_t EMPTY_BUCKET = 0xFFFFFFFF;
+
+    struct Header {
+        uint32_t keyCount;
+        uint32_t keysOffset;
+        uint32_t keyParamCount;
+        uint32_t keyParamsOffset;
+        uint32_t idCount;
+        uint32_t idsOffset;
+        uint32_t variantCount;
+        uint32_t variantsOffset;
+        uint32_t arrayCount;
+        uint32_t arraysOffset;
+        // a power of 2
+        uint32_t bucketCount;
+        uint32_t bucketsOffset;
+        uint32_t stringsOffset;
+        uint32_t stringsSize;
+    };
+
+    struct Key {
+        uint32_t firstParam;
+        uint32_t paramCount;
+    };
+
+    struct KeyParam {
+        uint32_t type;
+        uint32_t value;
+    };
+
+    struct Id {
+        uint32_t id;
+        uint32_t resType;
+        // offset of the name in strings
+        uint32_t name;
+        uint32_t firstVariant;
+        uint32_t variantCount;
+    };
+
+    struct Variant {
+        uint32_t key;
+        // offset of the value in strings, or the index of the first value in arrays for an array type
+        uint32_t value;
+        // the number of the values of an array type, else 0
+        uint32_t valueCount;
+    };
+
+    /**
+     * Whether the buffer starts with the header of version 2
+     */
+    static bool IsIndexV2(const char *buffer, size_t bufLen);
+
+    /**
+     * Check the header and the bounds of the tables, the offsets in the tables are checked by the getters
+     * @param buffer the index, 4 bytes aligned
+     * @param bufLen the length of the index
+     * @return OK if the index is valid, else SYS_ERROR
+     */
+    int32_t Init(const char *buffer, size_t bufLen);
+
+    inline const Header &GetHeader() const
+    {
+        return *header_;
+    }
+
+    inline const Key *GetKeys() const
+    {
+        return keys_;
+    }
+
+    inline const KeyParam *GetKeyParams() const
+    {
+        return keyParams_;
+    }
+
+    inline const Id *GetIds() const
+    {
+        return ids_;
+    }
+
+    inline const Variant *GetVariants() const
+    {
+        return variants_;
+    }
+
+    inline const uint32_t *GetArrays() const
+    {
+        return arrays_;
+    }
+
+    /**
+     * Get a string of the strings table
+     * @param offset the offset of the string
+     * @param str the string, null terminated
+     * @return false if the offset or the length is out of the table
+     */
+    bool GetString(uint32_t offset, std::string_view &str) const;
+
+    /**
+     * Find an id by its type and name in the names table
+     * @return the index in ids, or -1 if not found
+     */
+    int32_t FindId(uint32_t resType, std::string_view name) const;
+
+    /**
+     * Write the resources of resDesc as version 2, the values of an id are sorted by qualifier directory
+     * @param resDesc the resources parsed from an index
+     * @param out the index
+     * @return OK if success, else SYS_ERROR
+     */
+    static int32_t Write(const ResDesc &resDesc, std::string &out);
+
+    /**
+     * Write the resources of some qualifier directories as version 2
+     * @param resKeys the qualifier directories parsed from an index
+     * @param longStrings the store the long string values are compressed by, nullptr if they are not
+     * @param out the index
+     * @return OK if success, else SYS_ERROR
+     */
+    static int32_t Write(const std::vector<ResKey *> &resKeys, const LongStringStore *longStrings, std::string &out);
+
+    /**
+     * The bucket of (resType, name) in a names table of bucketCount buckets
+     */
+    static uint32_t HashName(uint32_t resType, std::string_view name, uint32_t bucketCount);
+
+private:
+    const char *buffer_ = nullptr;
+
+    size_t bufLen_ = 0;
+
+    const Header *header_ = nullptr;
+
+    const Key *keys_ = nullptr;
+
+    const KeyParam *keyParams_ = nullptr;
+
+    const Id *ids_ = nullptr;
+
+    const Variant *variants_ = nullptr;
+
+    const uint32_t *arrays_ = nullptr;
+
+    const uint32_t *buckets_ = nullptr;
+};
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
+#endif
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_RESOURCE_MANAGER_LONG_STRING_STORE_H
+#define OHOS_RESOURCE_MANAGER_LONG_STRING_STORE_H
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "utils/string_pool.h"
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+/**
+ * The long string values of an index kept deflated, with a dictionary sampled from them. A value is inflated
+ * when it is read, the recently read ones are kept in a LRU cache of the store.
+ */
+class LongStringStore {
+public:
+    // the max size of the dictionary, it is at most 1/8 of the long strings
+    static constexpr size_t MAX_DICTIONARY_SIZE = 16 * 1024;
+
+    static constexpr size_t DEFAULT_CACHE_SIZE = 64 * 1024;
+
+    /**
+     * @param threshold the min length of the values to compress
+     * @param cacheSize the max bytes of the inflated values cached
+     */
+    explicit LongStringStore(size_t threshold, size_t cacheSize = DEFAULT_CACHE_SIZE);
+
+    size_t GetThreshold() const
+    {
+        return threshold_;
+    }
+
+    /**
+     * Sample the dictionary from the values to compress, it is called once before Compress()
+     * @param values the values to compress
+     */
+    void BuildDictionary(const std::vector<std::string_view> &values);
+
+    /**
+     * Compress a value, it may be called by several threads at the same time
+     * @param value the value
+     * @param pool the compressed value is stored in it
+     * @param compressed the compressed value
+     * @return false if the value does not get smaller
+     */
+    bool Compress(std::string_view value, StringPool &pool, std::string_view &compressed) const;
+
+    /**
+     * Inflate a value compressed by the store
+     * @param compressed the compressed value
+     * @param len the length of the value
+     * @return the value, nullptr if failed. It stays valid while held, also when the cache drops it
+     */
+    std::shared_ptr<const std::string> Decode(std::string_view compressed, size_t len) const;
+
+    /**
+     * Drop the inflated values cached
+     */
+    void ClearCache();
+
+    /**
+     * Get the heap bytes of the dictionary
+     */
+    size_t GetMemoryUsage() const;
+
+    /**
+     * Get the heap bytes of the inflated values cached
+     */
+    size_t GetCacheUsage() const;
+
+private:
+    std::shared_ptr<const std::string> Inflate(std::string_view compressed, size_t len) const;
+
+    size_t threshold_;
+
+    size_t cacheSize_;
+
+    std::string dictionary_;
+
+    typedef std::pair<const char *, std::shared_ptr<const std::string>> CacheEntry;
+
+    // the inflated values by the address of the compressed ones, the most recently used first
+    mutable std::list<CacheEntry> cache_;
+
+    mutable std::unordered_map<const char *, std::list<CacheEntry>::iterator> cacheIndex_;
+
+    mutable size_t cacheBytes_ = 0;
+
+    mutable std::mutex lock_;
+
+    LongStringStore(const LongStringStore &src) = delete;
+
+    LongStringStore &operator=(const LongStringStore &src) = delete;
+};
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
+#endif
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_RESOURCE_MANAGER_MAPPED_FILE_H
+#define OHOS_RESOURCE_MANAGER_MAPPED_FILE_H
+
+#include <cstddef>
+#include <ctime>
+#include <memory>
+#include <string>
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+/**
+ * A whole file mapped read only. The mappings in use are shared, opening a file which is mapped
+ * and not modified since returns the same mapping, it is unmapped when the last user releases it.
+ * A private mapping is writable and owned by one user, its writes are copied on write and never
+ * reach the file or the other mappings.
+ */
+class MappedFile {
+public:
+    /**
+     * Map a file, or share the mapping of it in use
+     * @param path the file path
+     * @return the mapping if success, else nullptr
+     */
+    static std::shared_ptr<const MappedFile> Open(const std::string &path);
+
+    /**
+     * Map a file writable for one user, it is not shared
+     * @param path the file path
+     * @return the mapping if success, else nullptr
+     */
+    static std::shared_ptr<MappedFile> OpenPrivate(const std::string &path);
+
+    /**
+     * Get the number of the mappings in use
+     */
+    static size_t GetSharedCount();
+
+    /**
+     * Drop the registry entries of the mappings no longer in use
+     */
+    static void ReleaseCache();
+
+    ~MappedFile();
+
+    inline const char *Data() const
+    {
+        return data_;
+    }
+
+    inline char *Data()
+    {
+        return data_;
+    }
+
+    inline size_t Size() const
+    {
+        return size_;
+    }
+
+    /**
+     * Whether the content is mapped, else it is a copy in the heap
+     */
+    inline bool IsMapped() const
+    {
+        return mapped_;
+    }
+
+private:
+    MappedFile() = default;
+
+    // map or read the file of size bytes
+    bool Load(const std::string &path, size_t size, bool writable);
+
+    char *data_ = nullptr;
+
+    size_t size_ = 0;
+
+    bool mapped_ = false;
+
+    time_t modTime_ = 0;
+
+    MappedFile(const MappedFile &src) = delete;
+
+    MappedFile &operator=(const MappedFile &src) = delete;
+};
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
+#endif
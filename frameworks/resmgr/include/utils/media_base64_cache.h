@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_RESOURCE_MANAGER_MEDIA_BASE64_CACHE_H
+#define OHOS_RESOURCE_MANAGER_MEDIA_BASE64_CACHE_H
+
+#include <ctime>
+#include <list>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <unordered_map>
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+/**
+ * The data uris of the media encoded recently, keyed by the media path. An entry is valid while the file
+ * keeps the modification time and the size it was encoded at. The least recently used entries are dropped
+ * when the total length of the values exceeds the max size.
+ */
+class MediaBase64Cache {
+public:
+    explicit MediaBase64Cache(size_t maxSize);
+
+    /**
+     * Get the value of a media, the entry of a modified file is dropped
+     * @param path the media path
+     * @param modTime the modification time of the file now
+     * @param fileSize the size of the file now
+     * @param value the data uri
+     * @return true if the value is cached and the file is not modified since
+     */
+    bool Get(const std::string &path, time_t modTime, off_t fileSize, std::string &value);
+
+    /**
+     * Cache the value of a media, a value longer than the max size is not cached
+     * @param path the media path
+     * @param modTime the modification time of the file it is encoded from
+     * @param fileSize the size of the file it is encoded from
+     * @param value the data uri
+     */
+    void Put(const std::string &path, time_t modTime, off_t fileSize, const std::string &value);
+
+    void Clear();
+
+    /**
+     * Get the total length of the cached values
+     */
+    size_t GetSize() const;
+
+    size_t GetEntryCount() const;
+
+private:
+    struct Entry {
+        std::string path;
+
+        time_t modTime;
+
+        off_t fileSize;
+
+        std::string value;
+    };
+
+    // drop an entry, called with lock_ held
+    void Erase(std::unordered_map<std::string, std::list<Entry>::iterator>::iterator iter);
+
+    // the most recently used first
+    std::list<Entry> lru_;
+
+    std::unordered_map<std::string, std::list<Entry>::iterator> entries_;
+
+    size_t size_ = 0;
+
+    size_t maxSize_;
+
+    mutable std::mutex lock_;
+
+    MediaBase64Cache(const MediaBase64Cache &src) = delete;
+
+    MediaBase64Cache &operator=(const MediaBase64Cache &src) = delete;
+};
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
+#endif
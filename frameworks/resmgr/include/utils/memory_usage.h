@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_RESOURCE_MANAGER_MEMORY_USAGE_H
+#define OHOS_RESOURCE_MANAGER_MEMORY_USAGE_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+/**
+ * The heap bytes held by the resources, by category. They are estimated from the sizes of the objects
+ * and the capacities of the containers, the allocator overhead is not counted.
+ */
+struct MemoryUsage {
+    // the ResDesc tree of the index, the ResKey, KeyParam, ResId and IdParam objects
+    size_t resDesc = 0;
+
+    // the IdItem objects and the string pool of their names and values
+    size_t idItems = 0;
+
+    // the IdValues and ValueUnderQualifierDir objects
+    size_t values = 0;
+
+    // the ResConfigImpl objects of the qualifier directories
+    size_t configs = 0;
+
+    // the id map and the name maps
+    size_t maps = 0;
+
+    // the index of the raw files
+    size_t rawFileIndex = 0;
+
+    // the resolved values cached by id
+    size_t valueCache = 0;
+
+    // the cached plural rules
+    size_t pluralRules = 0;
+
+    // the cached raw file descriptors
+    size_t rawFileDescriptors = 0;
+
+    size_t Total() const
+    {
+        return resDesc + idItems + values + configs + maps + rawFileIndex + valueCache + pluralRules +
+            rawFileDescriptors;
+    }
+
+    MemoryUsage &operator+=(const MemoryUsage &other)
+    {
+        resDesc += other.resDesc;
+        idItems += other.idItems;
+        values += other.values;
+        configs += other.configs;
+        maps += other.maps;
+        rawFileIndex += other.rawFileIndex;
+        valueCache += other.valueCache;
+        pluralRules += other.pluralRules;
+        rawFileDescriptors += other.rawFileDescriptors;
+        return *this;
+    }
+
+    /**
+     * The heap bytes of a string, 0 when it is stored inline
+     */
+    static size_t Of(const std::string &str)
+    {
+        static const size_t inlineCapacity = std::string().capacity();
+        return (str.capacity() > inlineCapacity) ? str.capacity() + 1 : 0;
+    }
+
+    /**
+     * The heap bytes of the buffer of a vector, the heap of the elements is not counted
+     */
+    template<typename T>
+    static size_t Of(const std::vector<T> &vec)
+    {
+        return vec.capacity() * sizeof(T);
+    }
+
+    /**
+     * The heap bytes of the nodes of a map, the heap of the keys and values is not counted
+     */
+    template<typename K, typename V>
+    static size_t Of(const std::map<K, V> &map)
+    {
+        // the color and the parent, left and right links of a red black tree node
+        constexpr size_t nodeLinks = 4 * sizeof(void *);
+        return map.size() * (sizeof(std::pair<const K, V>) + nodeLinks);
+    }
+
+    /**
+     * The heap bytes of the nodes and buckets of a hash map, the heap of the keys and values is not counted
+     */
+    template<typename K, typename V>
+    static size_t Of(const std::unordered_map<K, V> &map)
+    {
+        // the next link and the cached hash of a node
+        constexpr size_t nodeLinks = 2 * sizeof(void *);
+        return map.size() * (sizeof(std::pair<const K, V>) + nodeLinks) + map.bucket_count() * sizeof(void *);
+    }
+};
+
+/**
+ * The memory usage of a resource manager
+ */
+struct MemoryReport {
+    // the usage of each loaded HapResource by its path, a shared one is counted by every manager using it
+    std::vector<std::pair<std::string, MemoryUsage>> resources;
+
+    // the sum of the resources and the caches of the manager
+    MemoryUsage total;
+};
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
+#endif
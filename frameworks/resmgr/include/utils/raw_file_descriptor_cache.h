@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_RESOURCE_MANAGER_RAW_FILE_DESCRIPTOR_CACHE_H
+#define OHOS_RESOURCE_MANAGER_RAW_FILE_DESCRIPTOR_CACHE_H
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+/**
+ * The descriptors of the raw files handed out by name. Every get of a name takes a reference and every
+ * close releases one. The names of one file, such as the raw files stored in one hap, share one fd.
+ * The names no one holds are kept in a LRU list, they are dropped when the limits are exceeded, and a
+ * fd is closed with the last name of its file.
+ */
+class RawFileDescriptorCache {
+public:
+    static const size_t DEFAULT_MAX_OPEN_FILES = 64;
+
+    static const size_t DEFAULT_MAX_ENTRIES = 256;
+
+    struct Descriptor {
+        int fd = -1;
+
+        // the range of the raw file in the file of fd
+        long offset = 0;
+
+        long length = 0;
+    };
+
+    RawFileDescriptorCache(size_t maxOpenFiles = DEFAULT_MAX_OPEN_FILES, size_t maxEntries = DEFAULT_MAX_ENTRIES);
+
+    ~RawFileDescriptorCache();
+
+    /**
+     * Take a reference of a cached name
+     * @param name the raw file name
+     * @param descriptor the descriptor of the raw file
+     * @return true if the name is cached
+     */
+    bool Acquire(const std::string &name, Descriptor &descriptor);
+
+    /**
+     * Take a reference of a name, the file is opened unless another name of it is cached
+     * @param name the raw file name
+     * @param path the file the raw file is in
+     * @param offset the offset of the raw file in path
+     * @param length the length of the raw file
+     * @param descriptor the descriptor of the raw file
+     * @return false if the file can not be opened, or max open files are held
+     */
+    bool Open(const std::string &name, const std::string &path, long offset, long length, Descriptor &descriptor);
+
+    /**
+     * Release a reference of a name
+     * @param name the raw file name
+     * @return false if the name is not held
+     */
+    bool Release(const std::string &name);
+
+    /**
+     * Change the limits, the names no one holds are dropped until the new limits are met
+     * @param maxOpenFiles the max number of files open at the same time, at least 1
+     * @param maxEntries the max number of names kept, the held ones always are
+     */
+    void SetLimits(size_t maxOpenFiles, size_t maxEntries);
+
+    /**
+     * Drop the names no one holds, and close their files
+     */
+    void ReleaseIdle();
+
+    size_t GetOpenFileCount() const;
+
+    size_t GetEntryCount() const;
+
+    /**
+     * Get the heap bytes of the cache
+     */
+    size_t GetMemoryUsage() const;
+
+private:
+    struct File {
+        int fd = -1;
+
+        // the number of names of the file, held or not
+        size_t names = 0;
+    };
+
+    struct Entry {
+        std::string path;
+
+        long offset = 0;
+
+        long length = 0;
+
+        size_t refs = 0;
+
+        // the position in idle_, valid when refs is 0
+        std::list<std::string>::iterator idle;
+    };
+
+    // take a reference of a cached name, called with lock_ held
+    bool AcquireLocked(const std::string &name, Descriptor &descriptor);
+
+    // name is copied, it may be an element of idle_
+    void Evict(const std::string name);
+
+    void Trim();
+
+    std::unordered_map<std::string, File> files_;
+
+    std::unordered_map<std::string, Entry> entries_;
+
+    // the names no one holds, the most recently used first
+    std::list<std::string> idle_;
+
+    size_t maxOpenFiles_;
+
+    size_t maxEntries_;
+
+    mutable std::mutex lock_;
+
+    RawFileDescriptorCache(const RawFileDescriptorCache &src) = delete;
+
+    RawFileDescriptorCache &operator=(const RawFileDescriptorCache &src) = delete;
+};
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
+#endif
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_RESOURCE_MANAGER_RAW_FILE_INDEX_H
+#define OHOS_RESOURCE_MANAGER_RAW_FILE_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/zip_archive.h"
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+/**
+ * The in-memory tree of the rawfile directory of a resources directory or a hap. The names are
+ * relative to the resources directory, such as "rawfile/sub/a.txt", the root directory is "rawfile".
+ */
+class RawFileIndex {
+public:
+    static const std::string ROOT_DIR;
+
+    struct File {
+        uint64_t size = 0;
+
+        // the entry inside the hap, nullptr when the file is on the disk
+        const ZipArchive::Entry *entry = nullptr;
+    };
+
+    /**
+     * Scan the rawfile directory on the disk
+     * @param resourcesDir the resources directory, ending with the separator
+     * @return the index, it is empty when there is no rawfile directory. nullptr if out of memory
+     */
+    static RawFileIndex *BuildFromDirectory(const std::string &resourcesDir);
+
+    /**
+     * Index the rawfile entries of a hap, the archive must outlive the index
+     * @param archive the hap
+     * @param prefix the prefix of the resources entries, such as "assets/entry/resources/"
+     * @return the index, nullptr if out of memory
+     */
+    static RawFileIndex *BuildFromZip(const ZipArchive &archive, const std::string &prefix);
+
+    /**
+     * Normalize a raw file name, the empty and "." segments are removed
+     * @param name the raw file name
+     * @param outName the normalized name
+     * @return false if the name has ".." segments
+     */
+    static bool Normalize(const std::string &name, std::string &outName);
+
+    /**
+     * Find a raw file
+     * @param name the normalized name
+     * @return the file if found, else nullptr
+     */
+    const File *Find(const std::string &name) const;
+
+    /**
+     * List the raw files of a directory
+     * @param dir the normalized directory name
+     * @param recursive whether the files of the sub directories are listed
+     * @param names the file names are appended to it, the files come before the sub directories
+     * @return false if the directory is not found
+     */
+    bool List(const std::string &dir, bool recursive, std::vector<std::string> &names) const;
+
+    /**
+     * Check whether a directory scanned from the disk has changed since the scan, a file added, removed or renamed
+     * changes the mod time of its directory. Always false for a hap
+     * @return true if the index should be built again
+     */
+    bool IsChanged() const;
+
+    /**
+     * Get the directory the index was scanned from, empty for a hap
+     */
+    inline const std::string &GetRoot() const
+    {
+        return root_;
+    }
+
+    inline size_t GetFileCount() const
+    {
+        return files_.size();
+    }
+
+    /**
+     * Get the heap bytes of the index, measured when it is built
+     */
+    inline size_t GetMemoryUsage() const
+    {
+        return memoryUsage_;
+    }
+
+private:
+    struct Dir {
+        std::vector<std::string> files;
+
+        std::vector<std::string> subDirs;
+    };
+
+    RawFileIndex() = default;
+
+    void ScanDirectory(const std::string &path, const std::string &name, const std::string &realRoot, int depth);
+
+    void AddDir(const std::string &name);
+
+    void AddFile(const std::string &name, const File &file);
+
+    void Sort();
+
+    size_t MeasureMemory() const;
+
+    void ListDir(const Dir &dir, bool recursive, std::vector<std::string> &names) const;
+
+    std::string root_;
+
+    std::unordered_map<std::string, File> files_;
+
+    std::unordered_map<std::string, Dir> dirs_;
+
+    // the path and the mod time of each directory scanned from the disk, including the missing rawfile directory
+    std::vector<std::pair<std::string, std::string>> dirStamps_;
+
+    size_t memoryUsage_ = 0;
+};
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
+#endif
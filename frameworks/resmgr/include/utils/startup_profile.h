@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_RESOURCE_MANAGER_STARTUP_PROFILE_H
+#define OHOS_RESOURCE_MANAGER_STARTUP_PROFILE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "res_common.h"
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+/**
+ * The ids, names and raw files looked up in a window after an app starts, in the order they are first looked up.
+ * It is saved as text, one entry a line, and replayed by the next start to warm up the caches before the lookups.
+ */
+class StartupProfile {
+public:
+    // the max entries recorded, the lookups after it is full are not recorded
+    static const size_t MAX_ENTRIES = 4096;
+
+    enum EntryType : char {
+        ID = 'i',
+        NAME = 'n',
+        RAW_FILE = 'r',
+    };
+
+    struct Entry {
+        EntryType type;
+
+        uint32_t id;
+
+        // the type of a name
+        ResType resType;
+
+        // the name of a resource or a raw file
+        std::string name;
+    };
+
+    // called once with the entries recorded when the recording ends
+    typedef std::function<void(const std::vector<Entry> &entries)> EndCallback;
+
+    /**
+     * Start recording the lookups
+     * @param durationMs the lookups in the next durationMs are recorded
+     * @param onEnd called by the first lookup after the window, or by Stop() if it is called earlier
+     * @return false if it is already started
+     */
+    bool Start(uint32_t durationMs, const EndCallback &onEnd);
+
+    /**
+     * Stop recording before the window ends, onEnd is called by it
+     */
+    void Stop();
+
+    inline void RecordId(uint32_t id)
+    {
+        if (recording_.load(std::memory_order_relaxed)) {
+            Record(ID, id, VALUES, nullptr);
+        }
+    }
+
+    inline void RecordName(const char *name, ResType resType)
+    {
+        if (recording_.load(std::memory_order_relaxed)) {
+            Record(NAME, 0, resType, name);
+        }
+    }
+
+    inline void RecordRawFile(const std::string &name)
+    {
+        if (recording_.load(std::memory_order_relaxed)) {
+            Record(RAW_FILE, 0, VALUES, name.c_str());
+        }
+    }
+
+    /**
+     * Get the entries recorded
+     */
+    std::vector<Entry> GetEntries() const;
+
+    /**
+     * Save entries to a file, it is written to a temporary file first and renamed
+     * @param path the file
+     * @param entries the entries
+     * @return OK if success, else SYS_ERROR
+     */
+    static int32_t Save(const std::string &path, const std::vector<Entry> &entries);
+
+    /**
+     * Load the entries saved in a file
+     * @param path the file
+     * @param entries the entries
+     * @return OK if success, else SYS_ERROR if the file can not be read or is not a profile
+     */
+    static int32_t Load(const std::string &path, std::vector<Entry> &entries);
+
+    /**
+     * The lookups of the current thread are not recorded while it lives, such as the ones of a replay
+     */
+    class ReplayScope {
+    public:
+        ReplayScope();
+
+        ~ReplayScope();
+    };
+
+private:
+    void Record(EntryType type, uint32_t id, ResType resType, const char *name);
+
+    // stop recording and call onEnd_ out of the lock, lock is unlocked after it
+    void End(std::unique_lock<std::mutex> &lock);
+
+    std::atomic<bool> recording_{false};
+
+    bool started_ = false;
+
+    std::chrono::steady_clock::time_point deadline_;
+
+    EndCallback onEnd_;
+
+    std::vector<Entry> entries_;
+
+    std::unordered_set<uint32_t> ids_;
+
+    // the type and the name of the names and raw files recorded
+    std::unordered_set<std::string> names_;
+
+    mutable std::mutex lock_;
+};
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
+#endif
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_RESOURCE_MANAGER_STRING_POOL_H
+#define OHOS_RESOURCE_MANAGER_STRING_POOL_H
+
+#include <cstddef>
+#include <mutex>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+/**
+ * The strings of an index, each distinct one is stored once in a few large blocks. The interned strings are
+ * null terminated and stay at the same address until the pool is destroyed, so the equal strings of a pool
+ * have the same data(). Intern() may be called by several threads at the same time.
+ */
+class StringPool {
+public:
+    StringPool() = default;
+
+    ~StringPool();
+
+    /**
+     * Get the string of the pool equal to str, it is added if there is none
+     * @param str the string
+     * @return the interned string, or an empty one if out of memory
+     */
+    std::string_view Intern(std::string_view str);
+
+    /**
+     * Get the number of the distinct strings
+     */
+    size_t GetCount() const;
+
+    /**
+     * Get the heap bytes of the blocks and the lookup tables
+     */
+    size_t GetMemoryUsage() const;
+
+private:
+    // the strings are spread on the shards by hash, so the parsing threads seldom wait for each other
+    static constexpr size_t SHARD_COUNT = 16;
+
+    // the blocks of a shard grow from the min size to the max size, the small indexes use little memory
+    static constexpr size_t MIN_BLOCK_SIZE = 512;
+
+    static constexpr size_t MAX_BLOCK_SIZE = 16 * 1024;
+
+    struct Shard {
+        mutable std::mutex lock;
+
+        std::unordered_set<std::string_view> strings;
+
+        std::vector<char *> blocks;
+
+        // the free space of the current block
+        char *next = nullptr;
+
+        size_t left = 0;
+
+        size_t blockSize = MIN_BLOCK_SIZE;
+
+        size_t blockBytes = 0;
+    };
+
+    char *Allocate(Shard &shard, size_t len);
+
+    Shard shards_[SHARD_COUNT];
+
+    StringPool(const StringPool &src) = delete;
+
+    StringPool &operator=(const StringPool &src) = delete;
+};
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
+#endif
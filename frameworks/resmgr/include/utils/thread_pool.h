@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_RESOURCE_MANAGER_THREAD_POOL_H
+#define OHOS_RESOURCE_MANAGER_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+/**
+ * A bounded pool of worker threads shared by the resource manager.
+ */
+class ThreadPool {
+public:
+    /**
+     * Get the process wide pool, the number of workers is bounded by the cpu count
+     */
+    static ThreadPool &GetInstance();
+
+    /**
+     * The constructor of ThreadPool
+     * @param threadCount the max number of worker threads, workers are started on demand
+     */
+    explicit ThreadPool(size_t threadCount);
+
+    /**
+     * The destructor of ThreadPool, the queued tasks are finished before workers quit
+     */
+    ~ThreadPool();
+
+    /**
+     * Queue a task to run on a worker thread
+     * @param task the task
+     */
+    void Post(const std::function<void()> &task);
+
+    /**
+     * Run func(0) .. func(count - 1) concurrently and wait until all of them return.
+     * The calling thread runs tasks too, so it is safe to call from inside a worker.
+     * @param count the number of tasks
+     * @param func the task body, called with the task index
+     */
+    void ParallelFor(size_t count, const std::function<void(size_t)> &func);
+
+    /**
+     * Get the max number of worker threads
+     */
+    inline size_t GetThreadCount() const
+    {
+        return threadCount_;
+    }
+
+private:
+    void WorkerLoop();
+
+    size_t threadCount_;
+
+    std::vector<std::thread> workers_;
+
+    std::deque<std::function<void()>> tasks_;
+
+    size_t idleCount_ = 0;
+
+    bool stopped_ = false;
+
+    std::mutex mutex_;
+
+    std::condition_variable cond_;
+
+    ThreadPool(const ThreadPool &src) = delete;
+
+    ThreadPool &operator=(const ThreadPool &src) = delete;
+};
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
+#endif
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_RESOURCE_MANAGER_ZIP_ARCHIVE_H
+#define OHOS_RESOURCE_MANAGER_ZIP_ARCHIVE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+/**
+ * A read only hap (zip) file. The central directory is parsed once into a hashed
+ * name index, the entries are read with positioned reads on one open fd.
+ */
+class ZipArchive {
+public:
+    static const uint16_t METHOD_STORED = 0;
+
+    static const uint16_t METHOD_DEFLATED = 8;
+
+    struct Entry {
+        // offset of the local file header in the zip file
+        uint64_t localHeaderOffset = 0;
+
+        uint64_t compressedSize = 0;
+
+        uint64_t uncompressedSize = 0;
+
+        uint32_t crc32 = 0;
+
+        uint16_t method = METHOD_STORED;
+    };
+
+    /**
+     * The content of an entry. STORED entries are mapped from the zip file without copy,
+     * the others are inflated into heap memory.
+     */
+    class View {
+    public:
+        ~View();
+
+        inline const char *Data() const
+        {
+            return data_;
+        }
+
+        inline size_t Size() const
+        {
+            return size_;
+        }
+
+        inline bool IsMapped() const
+        {
+            return mapped_;
+        }
+
+    private:
+        friend class ZipArchive;
+
+        View() = default;
+
+        const char *data_ = nullptr;
+
+        size_t size_ = 0;
+
+        // the mapping or the heap buffer which holds data_
+        void *base_ = nullptr;
+
+        size_t baseLen_ = 0;
+
+        bool mapped_ = false;
+
+        View(const View &src) = delete;
+
+        View &operator=(const View &src) = delete;
+    };
+
+    /**
+     * Open a zip file, the opened ones are shared while they are in use and not modified
+     * @param path the zip file path
+     * @param errInfo the error info when failed
+     * @return the zip archive if success, else nullptr
+     */
+    static std::shared_ptr<ZipArchive> Open(const std::string &path, std::string &errInfo);
+
+    /**
+     * Release the registry of the opened zip files, the ones still in use are closed when the last user releases
+     * them
+     */
+    static void ReleaseCache();
+
+    ~ZipArchive();
+
+    /**
+     * Find an entry by the name inside the zip
+     * @param name the entry name
+     * @return the entry if found, else nullptr
+     */
+    const Entry *GetEntry(const std::string &name) const;
+
+    /**
+     * Get all entries, keyed by the name
+     */
+    inline const std::unordered_map<std::string, Entry> &GetEntries() const
+    {
+        return entries_;
+    }
+
+    /**
+     * Get the offset where the data of the entry starts in the zip file
+     * @param entry the entry
+     * @param offset the data offset
+     * @return OK if success, else UNKNOWN_ERROR
+     */
+    int32_t GetDataOffset(const Entry &entry, uint64_t &offset) const;
+
+    /**
+     * Read the content of an entry
+     * @param name the entry name
+     * @param errInfo the error info when failed
+     * @return the content view if success, else nullptr. The caller should delete it
+     */
+    View *ReadEntry(const std::string &name, std::string &errInfo) const;
+
+    /**
+     * Read bytes at offset of the zip file
+     * @param offset the offset in the zip file
+     * @param buf the output buffer
+     * @param len the number of bytes to read
+     * @return true if all len bytes were read
+     */
+    bool ReadAt(uint64_t offset, void *buf, size_t len) const;
+
+    inline const std::string &GetPath() const
+    {
+        return path_;
+    }
+
+    inline int GetFd() const
+    {
+        return fd_;
+    }
+
+    inline uint64_t GetFileSize() const
+    {
+        return fileSize_;
+    }
+
+private:
+    ZipArchive(const std::string &path, int fd, uint64_t fileSize, time_t modTime, long modTimeNsec,
+        uint64_t inode);
+
+    int32_t ParseCentralDirectory(std::string &errInfo);
+
+    int32_t LocateCentralDirectory(uint64_t &cdOffset, uint64_t &cdSize, uint64_t &count, std::string &errInfo);
+
+    bool Map(uint64_t offset, size_t len, View *view) const;
+
+    bool Inflate(const Entry &entry, uint64_t dataOffset, View *view) const;
+
+    std::string path_;
+
+    int fd_;
+
+    uint64_t fileSize_;
+
+    time_t modTime_;
+
+    // the nanoseconds of the mod time and the inode, a rewrite within the same second or a replace changes them
+    long modTimeNsec_;
+
+    uint64_t inode_;
+
+    std::unordered_map<std::string, Entry> entries_;
+
+#ifdef __WINNT__
+    // no positioned read, the file offset is shared
+    mutable std::mutex readLock_;
+#endif
+
+    ZipArchive(const ZipArchive &src) = delete;
+
+    ZipArchive &operator=(const ZipArchive &src) = delete;
+};
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
+#endif
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_RESOURCE_MANAGER_ZIP_ENTRY_READER_H
+#define OHOS_RESOURCE_MANAGER_ZIP_ENTRY_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <zlib.h>
+
+#include "utils/zip_archive.h"
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+/**
+ * Random access reader of a deflated zip entry. The entry is inflated on demand, the inflate
+ * states at some block boundaries are kept as checkpoints, so a seek resumes from the nearest
+ * checkpoint before the target instead of inflating from the beginning.
+ */
+class ZipEntryReader {
+public:
+    // the distance in uncompressed bytes between two checkpoints
+    static const uint64_t DEFAULT_SPAN = 1024 * 1024;
+
+    /**
+     * The constructor of ZipEntryReader
+     * @param archive the hap
+     * @param entry the deflated entry
+     * @param dataOffset where the compressed data starts in the hap
+     * @param span the min distance in uncompressed bytes between two checkpoints
+     */
+    ZipEntryReader(const std::shared_ptr<ZipArchive> &archive, const ZipArchive::Entry &entry, uint64_t dataOffset,
+        uint64_t span = DEFAULT_SPAN);
+
+    ~ZipEntryReader();
+
+    /**
+     * Prepare the inflate stream
+     * @return true if success
+     */
+    bool Init();
+
+    /**
+     * Read the uncompressed bytes at position
+     * @param position the position in the uncompressed entry
+     * @param buf the output buffer
+     * @param len the max number of bytes to read
+     * @return the number of bytes read, less than len only at the end of the entry or on error
+     */
+    size_t Read(uint64_t position, void *buf, size_t len);
+
+    inline uint64_t GetSize() const
+    {
+        return entry_.uncompressedSize;
+    }
+
+    inline size_t GetCheckpointCount() const
+    {
+        return checkpoints_.size();
+    }
+
+private:
+    struct Checkpoint {
+        // the position in the uncompressed data
+        uint64_t out;
+
+        // the position in the compressed data, the first byte not fully consumed
+        uint64_t in;
+
+        // the number of bits of the byte before in which are not consumed yet, 0 to 7
+        int bits;
+
+        // the last 32K of uncompressed data before out, it is the dictionary to resume from
+        std::vector<unsigned char> window;
+    };
+
+    bool Restore(const Checkpoint &checkpoint);
+
+    size_t Produce(unsigned char *out, size_t len);
+
+    void AddCheckpoint();
+
+    std::shared_ptr<ZipArchive> archive_;
+
+    ZipArchive::Entry entry_;
+
+    uint64_t dataOffset_;
+
+    uint64_t span_;
+
+    z_stream stream_;
+
+    bool streamInited_ = false;
+
+    bool broken_ = false;
+
+    // position of the next uncompressed byte the stream produces
+    uint64_t outPos_ = 0;
+
+    // position of the next compressed byte to read into inBuf_
+    uint64_t inPos_ = 0;
+
+    std::vector<unsigned char> inBuf_;
+
+    // circular buffer of the last uncompressed bytes, the stream inflates into it
+    std::vector<unsigned char> window_;
+
+    size_t winPos_ = 0;
+
+    bool windowFull_ = false;
+
+    std::vector<Checkpoint> checkpoints_;
+
+    ZipEntryReader(const ZipEntryReader &src) = delete;
+
+    ZipEntryReader &operator=(const ZipEntryReader &src) = delete;
+};
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
+#endif
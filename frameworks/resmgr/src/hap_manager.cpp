@@ -15,7 +15,8 @@
 #include "hap_manager.h"
 
 #include <algorithm>
-#include <fstream>
+#include <chrono>
+#include <unordered_set>
 #ifdef SUPPORT_GRAPHICS
 #include <ohos/init_data.h>
 #endif
@@ -23,6 +24,8 @@
 #include "auto_mutex.h"
 #include "hilog_wrapper.h"
 #include "locale_matcher.h"
+#include "utils/errors.h"
+#include "utils/thread_pool.h"
 
 #ifdef __WINNT__
 #include <shlwapi.h>
@@ -37,8 +40,19 @@ namespace Resource {
 #ifdef SUPPORT_GRAPHICS
 constexpr uint32_t PLURAL_CACHE_MAX_COUNT = 3;
 #endif
+
+namespace {
+// the files are checked at most once in it when the auto reload is enabled
+constexpr int64_t AUTO_RELOAD_INTERVAL_MS = 1000;
+
+std::shared_ptr<const HapResource> Hold(const HapResource *resource)
+{
+    return std::shared_ptr<const HapResource>(resource, HapResource::Release);
+}
+} // namespace
+
 HapManager::HapManager(ResConfigImpl *resConfig)
-    : resConfig_(resConfig)
+    : resConfig_(resConfig), hapResources_(std::make_shared<const Resources>())
 {
 }
 
@@ -129,18 +143,25 @@ std::string HapManager::GetPluralRulesAndSelect(int quantity)
 #endif
 }
 
-const IdItem *HapManager::FindResourceById(uint32_t id)
+std::shared_ptr<const HapManager::Resources> HapManager::GetResources()
+{
+    AutoMutex mutex(this->lock_);
+    return hapResources_;
+}
+
+const IdItem *HapManager::FindResourceById(uint32_t id, std::shared_ptr<const Resources> &resources)
 {
-    auto qualifierValue = FindQualifierValueById(id);
+    auto qualifierValue = FindQualifierValueById(id, resources);
     if (qualifierValue == nullptr) {
         return nullptr;
     }
     return qualifierValue->GetIdItem();
 }
 
-const IdItem *HapManager::FindResourceByName(const char *name, const ResType resType)
+const IdItem *HapManager::FindResourceByName(const char *name, const ResType resType,
+    std::shared_ptr<const Resources> &resources)
 {
-    auto qualifierValue = FindQualifierValueByName(name, resType);
+    auto qualifierValue = FindQualifierValueByName(name, resType, resources);
     if (qualifierValue == nullptr) {
         return nullptr;
     }
@@ -148,45 +169,52 @@ const IdItem *HapManager::FindResourceByName(const char *name, const ResType res
 }
 
 const HapResource::ValueUnderQualifierDir *HapManager::FindQualifierValueByName(
-    const char *name, const ResType resType)
+    const char *name, const ResType resType, std::shared_ptr<const Resources> &resources)
 {
-    std::vector<const HapResource::IdValues *> candidates = this->GetResourceListByName(name, resType);
+    startupProfile_.RecordName(name, resType);
+    CheckChanged();
+    AutoMutex mutex(this->lock_);
+    if (resources == nullptr) {
+        resources = hapResources_;
+    }
+    std::vector<const HapResource::IdValues *> candidates = GetResourceListByName(*resources, name, resType);
     if (candidates.size() == 0) {
         return nullptr;
     }
-    const ResConfigImpl *bestResConfig = nullptr;
-    const HapResource::ValueUnderQualifierDir *result = nullptr;
-    for (auto iter = candidates.begin(); iter != candidates.end(); iter++) {
-        const std::vector<HapResource::ValueUnderQualifierDir *> paths = (*iter)->GetLimitPathsConst();
-        size_t len = paths.size();
-        size_t i = 0;
-        const ResConfigImpl *currentResConfig = this->resConfig_;
-        for (i = 0; i < len; i++) {
-            HapResource::ValueUnderQualifierDir *path = paths[i];
-            const ResConfigImpl *resConfig = path->GetResConfig();
-            if (!this->resConfig_->Match(resConfig)) {
-                continue;
-            }
-            if (bestResConfig == nullptr) {
-                bestResConfig = resConfig;
-                result = paths[i];
-                continue;
-            }
-            if (!bestResConfig->IsMoreSuitable(resConfig, currentResConfig)) {
-                bestResConfig = resConfig;
-                result = paths[i];
-            }
-        }
-    }
-    return result;
+    return this->FindBestQualifierValue(candidates);
 }
 
-const HapResource::ValueUnderQualifierDir *HapManager::FindQualifierValueById(uint32_t id)
+const HapResource::ValueUnderQualifierDir *HapManager::FindQualifierValueById(uint32_t id,
+    std::shared_ptr<const Resources> &resources)
 {
-    std::vector<const HapResource::IdValues *> candidates = this->GetResourceList(id);
+    startupProfile_.RecordId(id);
+    CheckChanged();
+    AutoMutex mutex(this->lock_);
+    if (resources == nullptr) {
+        resources = hapResources_;
+    }
+    // the cache only holds the values of the current resources
+    bool isCurrent = (resources == hapResources_);
+    if (isCurrent) {
+        auto cached = idValueCache_.find(id);
+        if (cached != idValueCache_.end()) {
+            return cached->second;
+        }
+    }
+    std::vector<const HapResource::IdValues *> candidates = GetResourceList(*resources, id);
     if (candidates.size() == 0) {
         return nullptr;
     }
+    const HapResource::ValueUnderQualifierDir *result = this->FindBestQualifierValue(candidates);
+    if (result != nullptr && isCurrent) {
+        idValueCache_[id] = result;
+    }
+    return result;
+}
+
+const HapResource::ValueUnderQualifierDir *HapManager::FindBestQualifierValue(
+    const std::vector<const HapResource::IdValues *> &candidates) const
+{
     const ResConfigImpl *bestResConfig = nullptr;
     const HapResource::ValueUnderQualifierDir *result = nullptr;
     bool isOverlayChange = false;
@@ -226,58 +254,204 @@ const HapResource::ValueUnderQualifierDir *HapManager::FindQualifierValueById(ui
 
 RState HapManager::FindRawFile(const std::string &name, std::string &outValue)
 {
-#ifdef __WINNT__
-    char seperator = '\\';
-#else
-    char seperator = '/';
-#endif
-    for (auto iter = hapResources_.rbegin(); iter != hapResources_.rend(); iter++) {
-        std::string indexPath = (*iter)->GetIndexPath();
-        auto index = indexPath.rfind(seperator);
-        if (index == std::string::npos) {
-            HILOG_ERROR("index path format error, %s", indexPath.c_str());
+    RawFileLocation location;
+    RState state = FindRawFileLocation(name, location, false);
+    if (state == SUCCESS) {
+        outValue = location.path;
+    }
+    return state;
+}
+
+RState HapManager::FindRawFile(const std::string &name, RawFileLocation &location)
+{
+    return FindRawFileLocation(name, location, true);
+}
+
+std::string HapManager::GetRawFileName(const std::string &name)
+{
+    std::string tempName = name;
+    const std::string rawFileDirName = RawFileIndex::ROOT_DIR + "/";
+    if (tempName.length() <= rawFileDirName.length()
+        || (tempName.compare(0, rawFileDirName.length(), rawFileDirName) != 0)) {
+        tempName = rawFileDirName + tempName;
+    }
+    return tempName;
+}
+
+RState HapManager::FindRawFileLocation(const std::string &name, RawFileLocation &location, bool includeHap)
+{
+    std::string rawFileName;
+    if (!RawFileIndex::Normalize(GetRawFileName(name), rawFileName)) {
+        HILOG_ERROR("invalid raw file name, %s", name.c_str());
+        return RState::NOT_FOUND;
+    }
+    std::shared_ptr<const Resources> resources = GetResources();
+    // on a miss, the raw file may have been added on the disk after the index was built
+    if (LookupRawFile(*resources, rawFileName, location, includeHap) ||
+        (RescanChangedRawFiles(*resources) && LookupRawFile(*resources, rawFileName, location, includeHap))) {
+        return SUCCESS;
+    }
+    return RState::NOT_FOUND;
+}
+
+bool HapManager::LookupRawFile(const Resources &resources, const std::string &rawFileName, RawFileLocation &location,
+    bool includeHap)
+{
+    for (auto iter = resources.rbegin(); iter != resources.rend(); iter++) {
+        if ((*iter)->IsHap() && !includeHap) {
             continue;
         }
-        std::string resourcesIndexPath = indexPath.substr(0, index);
-        char tmpPath[PATH_MAX] = {0};
-        std::string tempName = name;
-        const std::string rawFileDirName = "rawfile/";
-        if (tempName.length() <= rawFileDirName.length()
-            || (tempName.compare(0, rawFileDirName.length(), rawFileDirName) != 0)) {
-            tempName = rawFileDirName + tempName;
+        std::shared_ptr<const RawFileIndex> index = (*iter)->GetRawFileIndex();
+        if (index == nullptr) {
+            continue;
         }
-#ifdef __WINNT__
-        if (!PathCanonicalizeA(tmpPath, (resourcesIndexPath + "/resources/" + tempName).c_str())) {
+        const RawFileIndex::File *file = index->Find(rawFileName);
+        if (file != nullptr && GetRawFileLocation(iter->get(), *index, rawFileName, *file, location)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void HapManager::LookupRawFiles(const Resources &resources, const std::vector<std::string> &rawFileNames,
+    std::vector<bool> &pending, size_t &remaining, std::vector<RawFileLocation> &locations)
+{
+    for (auto iter = resources.rbegin(); iter != resources.rend() && remaining > 0; iter++) {
+        std::shared_ptr<const RawFileIndex> index = (*iter)->GetRawFileIndex();
+        if (index == nullptr) {
             continue;
         }
-#else
-        if (realpath((resourcesIndexPath + "/resources/" + tempName).c_str(), tmpPath) == nullptr) {
-            HILOG_ERROR("FindRawFile path to realpath error");
+        for (size_t i = 0; i < rawFileNames.size(); ++i) {
+            if (!pending[i]) {
+                continue;
+            }
+            const RawFileIndex::File *file = index->Find(rawFileNames[i]);
+            if (file != nullptr && GetRawFileLocation(iter->get(), *index, rawFileNames[i], *file, locations[i])) {
+                pending[i] = false;
+                remaining--;
+            }
+        }
+    }
+}
+
+bool HapManager::RescanChangedRawFiles(const Resources &resources)
+{
+    bool changed = false;
+    for (auto iter = resources.begin(); iter != resources.end(); iter++) {
+        if (!(*iter)->IsHap() && (*iter)->RescanRawFilesIfChanged()) {
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+RState HapManager::FindRawFiles(const std::vector<std::string> &names, std::vector<RawFileLocation> &locations)
+{
+    locations.assign(names.size(), RawFileLocation());
+    std::vector<std::string> rawFileNames(names.size());
+    std::vector<bool> pending(names.size(), false);
+    size_t remaining = 0;
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (RawFileIndex::Normalize(GetRawFileName(names[i]), rawFileNames[i])) {
+            pending[i] = true;
+            remaining++;
+        }
+    }
+    std::shared_ptr<const Resources> resources = GetResources();
+    LookupRawFiles(*resources, rawFileNames, pending, remaining, locations);
+    if (remaining > 0 && RescanChangedRawFiles(*resources)) {
+        LookupRawFiles(*resources, rawFileNames, pending, remaining, locations);
+    }
+    return remaining == 0 ? SUCCESS : RState::NOT_FOUND;
+}
+
+bool HapManager::GetRawFileLocation(const HapResource *resource, const RawFileIndex &index, const std::string &name,
+    const RawFileIndex::File &file, RawFileLocation &location)
+{
+    if (file.entry == nullptr) {
+        location.path = index.GetRoot() + name;
+        location.offset = 0;
+        location.length = file.size;
+        location.archive = nullptr;
+        location.entry = nullptr;
+        return true;
+    }
+    const std::shared_ptr<ZipArchive> &archive = resource->GetZipArchive();
+    uint64_t dataOffset = 0;
+    if (archive->GetDataOffset(*file.entry, dataOffset) != OK) {
+        return false;
+    }
+    location.path = archive->GetPath();
+    location.offset = dataOffset;
+    location.length = file.size;
+    location.archive = archive;
+    location.entry = file.entry;
+    return true;
+}
+
+RState HapManager::ListRawFiles(const std::string &dirName, bool recursive, std::vector<std::string> &names)
+{
+    std::string dir;
+    if (!RawFileIndex::Normalize(GetRawFileName(dirName), dir)) {
+        HILOG_ERROR("invalid raw file directory, %s", dirName.c_str());
+        return RState::NOT_FOUND;
+    }
+    bool found = false;
+    std::unordered_set<std::string> listed;
+    std::shared_ptr<const Resources> resources = GetResources();
+    RescanChangedRawFiles(*resources);
+    for (auto iter = resources->rbegin(); iter != resources->rend(); iter++) {
+        std::shared_ptr<const RawFileIndex> index = (*iter)->GetRawFileIndex();
+        std::vector<std::string> files;
+        if (index == nullptr || !index->List(dir, recursive, files)) {
             continue;
         }
-#endif
-        const std::string realPath = tmpPath;
-        if (realPath.length() > resourcesIndexPath.length()
-            && (realPath.compare(0, resourcesIndexPath.length(), resourcesIndexPath) == 0)) {
-            std::fstream inputFile;
-            inputFile.open(realPath, std::ios::in);
-            if (inputFile) {
-                outValue = realPath;
-                return SUCCESS;
+        found = true;
+        // a file of several haps is listed once
+        for (auto file = files.begin(); file != files.end(); ++file) {
+            if (listed.insert(*file).second) {
+                names.push_back(*file);
             }
         }
     }
-    return RState::NOT_FOUND;
+    return found ? SUCCESS : RState::NOT_FOUND;
+}
+
+void HapManager::RescanRawFiles()
+{
+    std::shared_ptr<const Resources> resources = GetResources();
+    for (auto iter = resources->begin(); iter != resources->end(); iter++) {
+        (*iter)->RescanRawFiles();
+    }
 }
 
 RState HapManager::UpdateResConfig(ResConfig &resConfig)
 {
-    AutoMutex mutex(this->lock_);
-    this->resConfig_->Copy(resConfig);
-    RState rState = this->ReloadAll();
+    AutoMutex update(this->updateLock_);
+    ResConfigImpl *newConfig = new (std::nothrow) ResConfigImpl;
+    if (newConfig == nullptr) {
+        HILOG_ERROR("new ResConfigImpl failed when UpdateResConfig");
+        return ERROR;
+    }
+    newConfig->Copy(resConfig);
+    // load with the new config while the old resources are still readable
+    Resources newResources;
+    RState rState = this->ReloadAll(newConfig, newResources);
     if (rState != SUCCESS) {
         HILOG_ERROR("ReloadAll() failed when UpdateResConfig!");
+        delete newConfig;
+        return rState;
+    }
+    ResConfigImpl *oldConfig = nullptr;
+    std::shared_ptr<const Resources> oldResources;
+    {
+        AutoMutex mutex(this->lock_);
+        oldConfig = this->resConfig_;
+        this->resConfig_ = newConfig;
+        oldResources = Publish(std::make_shared<const Resources>(std::move(newResources)));
+        idValueCache_.clear();
     }
+    delete oldConfig;
     return rState;
 }
 
@@ -290,36 +464,331 @@ void HapManager::GetResConfig(ResConfig &resConfig)
 
 bool HapManager::AddResource(const char *path)
 {
-    AutoMutex mutex(this->lock_);
+    AutoMutex update(this->updateLock_);
     return this->AddResourcePath(path);
 }
 
-bool HapManager::AddResource(const std::string &path, const std::vector<std::string> &overlayPaths)
+bool HapManager::AddResource(const std::string &targetPath, const std::vector<std::string> &overlayPaths)
+{
+    AutoMutex update(this->updateLock_);
+    std::string path = HapResource::GetCanonicalPath(targetPath);
+    // AddOverlay and RemoveOverlay match the overlays by their canonical paths
+    std::vector<std::string> sOverlayPaths;
+    for (size_t i = 0; i < overlayPaths.size(); ++i) {
+        sOverlayPaths.push_back(HapResource::GetCanonicalPath(overlayPaths[i]));
+    }
+    std::unordered_map<std::string, HapResource *> result = HapResource::LoadOverlays(path, sOverlayPaths, resConfig_);
+    if (result.size() == 0) {
+        return false;
+    }
+    // keep the target first and the overlays in the order they were given
+    Resources newResources(*hapResources_);
+    newResources.push_back(Hold(result[path]));
+    std::vector<std::string> validOverlayPaths;
+    for (size_t i = 0; i < sOverlayPaths.size(); ++i) {
+        auto iter = result.find(sOverlayPaths[i]);
+        if (iter != result.end() && sOverlayPaths[i] != path) {
+            newResources.push_back(Hold(iter->second));
+            validOverlayPaths.push_back(sOverlayPaths[i]);
+        }
+    }
+    AutoMutex mutex(this->lock_);
+    Publish(std::make_shared<const Resources>(std::move(newResources)));
+    loadedHapPaths_[path] = validOverlayPaths;
+    idValueCache_.clear();
+    return true;
+}
+
+bool HapManager::AddOverlay(const std::string &targetPath, const std::string &overlayPath)
+{
+    AutoMutex update(this->updateLock_);
+    std::string path = HapResource::GetCanonicalPath(targetPath);
+    std::string sOverlayPath = HapResource::GetCanonicalPath(overlayPath);
+    auto it = loadedHapPaths_.find(path);
+    if (it == loadedHapPaths_.end()) {
+        HILOG_ERROR("%s is not loaded", path.c_str());
+        return false;
+    }
+    std::vector<std::string> &overlayPaths = it->second;
+    if (sOverlayPath == path ||
+        std::find(overlayPaths.begin(), overlayPaths.end(), sOverlayPath) != overlayPaths.end()) {
+        HILOG_ERROR("%s has already been loaded!", sOverlayPath.c_str());
+        return false;
+    }
+    // the overlay is mapped to the target in use, the file of it may have been changed since it was loaded
+    Resources newResources(*hapResources_);
+    size_t start = 0;
+    while (start < newResources.size() && newResources[start]->GetIndexPath() != path) {
+        start++;
+    }
+    if (start == newResources.size()) {
+        HILOG_ERROR("%s is not found in the resources", path.c_str());
+        return false;
+    }
+    const HapResource *overlay = HapResource::LoadOverlay(sOverlayPath, *newResources[start], resConfig_);
+    if (overlay == nullptr) {
+        return false;
+    }
+    // after the target and its overlays, so the overlays added before keep their priority
+    size_t pos = start + 1;
+    for (size_t i = pos; i < newResources.size(); ++i) {
+        if (std::find(overlayPaths.begin(), overlayPaths.end(), newResources[i]->GetIndexPath()) !=
+            overlayPaths.end()) {
+            pos = i + 1;
+        }
+    }
+    newResources.insert(newResources.begin() + pos, Hold(overlay));
+    AutoMutex mutex(this->lock_);
+    Publish(std::make_shared<const Resources>(std::move(newResources)));
+    overlayPaths.push_back(sOverlayPath);
+    InvalidateIds(overlay);
+    return true;
+}
+
+bool HapManager::RemoveOverlay(const std::string &targetPath, const std::string &overlayPath)
+{
+    AutoMutex update(this->updateLock_);
+    std::string path = HapResource::GetCanonicalPath(targetPath);
+    std::string sOverlayPath = HapResource::GetCanonicalPath(overlayPath);
+    auto it = loadedHapPaths_.find(path);
+    if (it == loadedHapPaths_.end()) {
+        HILOG_ERROR("%s is not loaded", path.c_str());
+        return false;
+    }
+    std::vector<std::string> &overlayPaths = it->second;
+    auto pathIter = std::find(overlayPaths.begin(), overlayPaths.end(), sOverlayPath);
+    if (pathIter == overlayPaths.end()) {
+        HILOG_ERROR("%s is not an overlay of %s", sOverlayPath.c_str(), path.c_str());
+        return false;
+    }
+    // the overlays of path follow it, another target may have an overlay of the same path
+    Resources newResources(*hapResources_);
+    size_t start = 0;
+    while (start < newResources.size() && newResources[start]->GetIndexPath() != path) {
+        start++;
+    }
+    if (start == newResources.size()) {
+        HILOG_ERROR("%s is not found in the resources", path.c_str());
+        return false;
+    }
+    // a reader holding the old list may still use the values of the overlay, it is released by the last of them
+    std::shared_ptr<const HapResource> overlay;
+    for (size_t i = start + 1; i < newResources.size(); ++i) {
+        if (newResources[i]->GetIndexPath() == sOverlayPath) {
+            overlay = newResources[i];
+            newResources.erase(newResources.begin() + i);
+            break;
+        }
+    }
+    if (overlay == nullptr) {
+        HILOG_ERROR("%s is not found in the resources", sOverlayPath.c_str());
+        return false;
+    }
+    overlayPaths.erase(pathIter);
+    AutoMutex mutex(this->lock_);
+    Publish(std::make_shared<const Resources>(std::move(newResources)));
+    InvalidateIds(overlay.get());
+    return true;
+}
+
+void HapManager::GetMemoryUsage(MemoryReport &report)
 {
-    loadedHapPaths_[path] = overlayPaths;
-    std::unordered_map<std::string, HapResource *> result = HapResource::LoadOverlays(path, overlayPaths, resConfig_);
-    if (result.size() > 0) {
-        std::vector<std::string> &validOverlayPaths = loadedHapPaths_[path];
-        int i = 0;
-        for (auto iter = result.begin(); iter != result.end(); iter++) {
-            this->hapResources_.push_back(iter->second);
-            if (i > 0) {
-                // the first is the target, not the overlay
-                validOverlayPaths.push_back(iter->first);
-                i++;
+    AutoMutex mutex(this->lock_);
+    for (size_t i = 0; i < hapResources_->size(); ++i) {
+        const HapResource *resource = (*hapResources_)[i].get();
+        MemoryUsage usage;
+        resource->GetMemoryUsage(usage);
+        report.total += usage;
+        report.resources.emplace_back(resource->GetIndexPath(), usage);
+    }
+    report.total.valueCache += MemoryUsage::Of(idValueCache_);
+#ifdef SUPPORT_GRAPHICS
+    // the rules are opaque icu objects, only the objects themselves are counted
+    report.total.pluralRules += MemoryUsage::Of(plurRulesCache_);
+    for (size_t i = 0; i < plurRulesCache_.size(); ++i) {
+        report.total.pluralRules += MemoryUsage::Of(plurRulesCache_[i].first) + sizeof(icu::PluralRules);
+    }
+#endif
+}
+
+void HapManager::Trim(TrimLevel level)
+{
+    AutoMutex update(this->updateLock_);
+    AutoMutex mutex(this->lock_);
+    // clear() keeps the buckets
+    std::unordered_map<uint32_t, const HapResource::ValueUnderQualifierDir *>().swap(idValueCache_);
+#ifdef SUPPORT_GRAPHICS
+    for (size_t i = 0; i < plurRulesCache_.size(); ++i) {
+        delete plurRulesCache_[i].second;
+    }
+    std::vector<std::pair<std::string, icu::PluralRules *>>().swap(plurRulesCache_);
+#endif
+    for (size_t i = 0; i < hapResources_->size(); ++i) {
+        (*hapResources_)[i]->TrimCaches();
+    }
+}
+
+void HapManager::SetAutoReload(bool enabled)
+{
+    autoReload_.store(enabled, std::memory_order_relaxed);
+}
+
+void HapManager::CheckChanged()
+{
+    if (!autoReload_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t last = lastCheckTime_.load(std::memory_order_relaxed);
+    // one of the lookups at the same time does the check
+    if (now - last < AUTO_RELOAD_INTERVAL_MS || !lastCheckTime_.compare_exchange_strong(last, now)) {
+        return;
+    }
+    // a lookup does not wait for an update in progress, the next one checks again
+    if (!updateLock_.try_lock()) {
+        lastCheckTime_.store(last, std::memory_order_relaxed);
+        return;
+    }
+    ReloadChangedLocked();
+    updateLock_.unlock();
+}
+
+bool HapManager::ReloadChanged()
+{
+    AutoMutex update(this->updateLock_);
+    return ReloadChangedLocked();
+}
+
+bool HapManager::ReloadChangedLocked()
+{
+    // the updates hold updateLock_, so the list is not replaced while it is read here
+    const Resources &resources = *hapResources_;
+    Resources newResources(resources);
+    // the resources replaced and the ones replacing them
+    std::vector<std::pair<const HapResource *, const HapResource *>> replaced;
+    for (auto iter = loadedHapPaths_.begin(); iter != loadedHapPaths_.end(); ++iter) {
+        const std::string &path = iter->first;
+        const std::vector<std::string> &overlayPaths = iter->second;
+        // the positions of the target and its overlays, the overlays follow the target
+        std::vector<size_t> positions(overlayPaths.size() + 1, resources.size());
+        bool changed = false;
+        size_t start = 0;
+        for (size_t k = 0; k < positions.size(); ++k) {
+            const std::string &indexPath = (k == 0) ? path : overlayPaths[k - 1];
+            for (size_t i = start; i < resources.size(); ++i) {
+                if (resources[i]->GetIndexPath() == indexPath) {
+                    positions[k] = i;
+                    changed = changed || resources[i]->IsChanged();
+                    break;
+                }
+            }
+            if (k == 0 && positions[0] < resources.size()) {
+                start = positions[0];
             }
         }
-        return true;
+        if (!changed) {
+            continue;
+        }
+        std::vector<const HapResource *> loaded;
+        if (overlayPaths.size() == 0) {
+            loaded.push_back(HapResource::Acquire(path.c_str(), resConfig_));
+        } else {
+            std::unordered_map<std::string, HapResource *> result = HapResource::LoadOverlays(path,
+                overlayPaths, resConfig_);
+            if (result.size() > 0) {
+                loaded.push_back(result[path]);
+                for (size_t k = 0; k < overlayPaths.size(); ++k) {
+                    loaded.push_back(result[overlayPaths[k]]);
+                }
+            }
+        }
+        if (loaded.size() == 0 || loaded[0] == nullptr) {
+            // it may be still being written, try again at the next check
+            HILOG_ERROR("reload %s failed", path.c_str());
+            continue;
+        }
+        for (size_t k = 0; k < loaded.size(); ++k) {
+            if (positions[k] >= resources.size()) {
+                HapResource::Release(loaded[k]);
+                continue;
+            }
+            replaced.emplace_back(resources[positions[k]].get(), loaded[k]);
+            newResources[positions[k]] = Hold(loaded[k]);
+        }
     }
-    return false;
+    if (replaced.empty()) {
+        return false;
+    }
+    // declared before the lock, so the replaced resources are released after it is unlocked
+    std::shared_ptr<const Resources> oldResources;
+    AutoMutex mutex(this->lock_);
+    // the cached values of the ids of a replaced resource are in it, they are freed with the old list. The ids
+    // of the new one may be found in it instead of another resource now
+    oldResources = Publish(std::make_shared<const Resources>(std::move(newResources)));
+    for (size_t i = 0; i < replaced.size(); ++i) {
+        InvalidateIds(replaced[i].first);
+        InvalidateIds(replaced[i].second);
+    }
+    return true;
 }
 
-HapManager::~HapManager()
+void HapManager::InvalidateIds(const HapResource *resource)
 {
-    for (size_t i = 0; i < hapResources_.size(); ++i) {
-        auto ptr = hapResources_[i];
-        delete (ptr);
+    if (idValueCache_.empty()) {
+        return;
     }
+    std::vector<uint32_t> ids;
+    resource->GetIds(ids);
+    for (size_t i = 0; i < ids.size(); ++i) {
+        idValueCache_.erase(ids[i]);
+    }
+}
+
+std::shared_ptr<const HapManager::Resources> HapManager::Publish(std::shared_ptr<const Resources> resources)
+{
+    hapResources_.swap(resources);
+    generation_++;
+    return resources;
+}
+
+bool HapManager::AddResources(const std::vector<std::string> &paths)
+{
+    AutoMutex update(this->updateLock_);
+    std::vector<std::string> toLoad;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        std::string path = HapResource::GetCanonicalPath(paths[i]);
+        if (loadedHapPaths_.find(path) != loadedHapPaths_.end() ||
+            std::find(toLoad.begin(), toLoad.end(), path) != toLoad.end()) {
+            HILOG_ERROR(" %s has already been loaded!", paths[i].c_str());
+            continue;
+        }
+        toLoad.push_back(path);
+    }
+    std::vector<const HapResource *> loaded(toLoad.size(), nullptr);
+    ThreadPool::GetInstance().ParallelFor(toLoad.size(), [&](size_t i) {
+        loaded[i] = HapResource::Acquire(toLoad[i].c_str(), resConfig_);
+    });
+    bool success = toLoad.size() == paths.size();
+    Resources newResources(*hapResources_);
+    AutoMutex mutex(this->lock_);
+    for (size_t i = 0; i < loaded.size(); ++i) {
+        if (loaded[i] == nullptr) {
+            success = false;
+            continue;
+        }
+        newResources.push_back(Hold(loaded[i]));
+        this->loadedHapPaths_[toLoad[i]] = std::vector<std::string>();
+    }
+    Publish(std::make_shared<const Resources>(std::move(newResources)));
+    idValueCache_.clear();
+    return success;
+}
+
+HapManager::~HapManager()
+{
+    // the resources are released before the config they are loaded with
+    hapResources_ = nullptr;
     delete resConfig_;
 
 #ifdef SUPPORT_GRAPHICS
@@ -333,11 +802,22 @@ HapManager::~HapManager()
 }
 
 std::vector<const HapResource::IdValues *> HapManager::GetResourceList(uint32_t ident) const
+{
+    return GetResourceList(*hapResources_, ident);
+}
+
+std::vector<const HapResource::IdValues *> HapManager::GetResourceListByName(const char *name,
+    const ResType resType) const
+{
+    return GetResourceListByName(*hapResources_, name, resType);
+}
+
+std::vector<const HapResource::IdValues *> HapManager::GetResourceList(const Resources &resources, uint32_t ident)
 {
     std::vector<const HapResource::IdValues *> result;
     // one id only exit in one hap
-    for (size_t i = 0; i < hapResources_.size(); ++i) {
-        HapResource *pResource = hapResources_[i];
+    for (size_t i = 0; i < resources.size(); ++i) {
+        const HapResource *pResource = resources[i].get();
         const HapResource::IdValues *out = pResource->GetIdValues(ident);
         if (out != nullptr) {
             result.emplace_back(out);
@@ -346,13 +826,13 @@ std::vector<const HapResource::IdValues *> HapManager::GetResourceList(uint32_t
     return result;
 }
 
-std::vector<const HapResource::IdValues *> HapManager::GetResourceListByName(const char *name,
-    const ResType resType) const
+std::vector<const HapResource::IdValues *> HapManager::GetResourceListByName(const Resources &resources,
+    const char *name, const ResType resType)
 {
     std::vector<const HapResource::IdValues *> result;
     // all match will return
-    for (size_t i = 0; i < hapResources_.size(); ++i) {
-        HapResource *pResource = hapResources_[i];
+    for (size_t i = 0; i < resources.size(); ++i) {
+        const HapResource *pResource = resources[i].get();
         const HapResource::IdValues *out = pResource->GetIdValuesByName(std::string(name), resType);
         if (out != nullptr) {
             result.emplace_back(out);
@@ -363,63 +843,102 @@ std::vector<const HapResource::IdValues *> HapManager::GetResourceListByName(con
 
 bool HapManager::AddResourcePath(const char *path)
 {
-    std::string sPath(path);
+    if (path == nullptr) {
+        return false;
+    }
+    // the same file added by another path is found as loaded
+    std::string sPath = HapResource::GetCanonicalPath(path);
     auto it = loadedHapPaths_.find(sPath);
     if (it != loadedHapPaths_.end()) {
         HILOG_ERROR(" %s has already been loaded!", path);
         return false;
     }
-    const HapResource *pResource = HapResource::LoadFromIndex(path, resConfig_);
+    const HapResource *pResource = HapResource::Acquire(sPath.c_str(), resConfig_);
     if (pResource == nullptr) {
         return false;
     }
-    this->hapResources_.push_back(const_cast<HapResource *>(pResource));
+    Resources newResources(*hapResources_);
+    newResources.push_back(Hold(pResource));
+    AutoMutex mutex(this->lock_);
+    Publish(std::make_shared<const Resources>(std::move(newResources)));
     this->loadedHapPaths_[sPath] = std::vector<std::string>();
+    idValueCache_.clear();
     return true;
 }
 
-RState HapManager::ReloadAll()
+std::vector<std::string> HapManager::GetLoadOrder() const
 {
-    if (hapResources_.size() == 0) {
-        return SUCCESS;
+    // follow the order of hapResources_, the paths which are not found there come last
+    std::vector<std::string> order;
+    for (size_t i = 0; i < hapResources_->size(); ++i) {
+        const std::string &indexPath = (*hapResources_)[i]->GetIndexPath();
+        if (loadedHapPaths_.find(indexPath) != loadedHapPaths_.end() &&
+            std::find(order.begin(), order.end(), indexPath) == order.end()) {
+            order.push_back(indexPath);
+        }
     }
-    std::vector<HapResource *> newResources;
+    std::vector<std::string> others;
     for (auto iter = loadedHapPaths_.begin(); iter != loadedHapPaths_.end(); iter++) {
-        const HapResource *pResource = HapResource::LoadFromIndex(iter->first.c_str(), resConfig_);
-        if (pResource == nullptr) {
-            for (size_t i = 0; i < newResources.size(); ++i) {
-                delete (newResources[i]);
+        if (std::find(order.begin(), order.end(), iter->first) == order.end()) {
+            others.push_back(iter->first);
+        }
+    }
+    std::sort(others.begin(), others.end());
+    order.insert(order.end(), others.begin(), others.end());
+    return order;
+}
+
+RState HapManager::ReloadAll(const ResConfigImpl *resConfig, Resources &newResources)
+{
+    if (hapResources_->size() == 0) {
+        return SUCCESS;
+    }
+    std::vector<std::string> order = GetLoadOrder();
+    // every target with its overlays is loaded by one task, the results are joined in order
+    std::vector<std::vector<HapResource *>> groups(order.size());
+    ThreadPool::GetInstance().ParallelFor(order.size(), [&](size_t i) {
+        const std::string &path = order[i];
+        const std::vector<std::string> &overlayPaths = loadedHapPaths_.find(path)->second;
+        if (overlayPaths.size() > 0) {
+            std::unordered_map<std::string, HapResource *> result = HapResource::LoadOverlays(path,
+                overlayPaths, resConfig);
+            if (result.size() > 0) {
+                groups[i].push_back(result[path]);
+                for_each(overlayPaths.begin(), overlayPaths.end(), [&](auto &overlayPath) {
+                    if (overlayPath != path && result.find(overlayPath) != result.end()) {
+                        groups[i].push_back(result[overlayPath]);
+                    }
+                });
+                return;
             }
-            return HAP_INIT_FAILED;
         }
-        newResources.push_back(const_cast<HapResource *>(pResource));
-        std::vector<std::string> &overlayPaths = iter->second;
-        if (overlayPaths.size() == 0) {
-            continue;
+        const HapResource *pResource = HapResource::Acquire(path.c_str(), resConfig);
+        if (pResource != nullptr) {
+            groups[i].push_back(const_cast<HapResource *>(pResource));
         }
-        std::unordered_map<std::string, HapResource *> result = HapResource::LoadOverlays(iter->first.c_str(),
-            overlayPaths, resConfig_);
-        if (result.size() == 0) {
-            continue;
+    });
+    bool success = std::all_of(groups.begin(), groups.end(), [](auto &group) { return !group.empty(); });
+    for (size_t i = 0; i < groups.size(); ++i) {
+        for (size_t j = 0; j < groups[i].size(); ++j) {
+            newResources.push_back(Hold(groups[i][j]));
         }
-
-        for_each(overlayPaths.begin(), overlayPaths.end(), [&](auto &path) {
-            if (result.find(path) != result.end()) {
-                newResources.push_back(result[path]);
-            }
-        });
     }
-    for (size_t i = 0; i < hapResources_.size(); ++i) {
-        delete (hapResources_[i]);
+    if (!success) {
+        newResources.clear();
+        return HAP_INIT_FAILED;
     }
-    hapResources_ = newResources;
     return SUCCESS;
 }
 
 std::vector<std::string> HapManager::GetResourcePaths()
 {
     std::vector<std::string> result;
-    for (auto iter = hapResources_.rbegin(); iter != hapResources_.rend(); iter++) {
+    std::shared_ptr<const Resources> resources = GetResources();
+    for (auto iter = resources->rbegin(); iter != resources->rend(); iter++) {
+        if ((*iter)->IsHap()) {
+            // the resources inside a hap have no directory on the disk
+            continue;
+        }
         std::string indexPath = (*iter)->GetIndexPath();
         auto index = indexPath.rfind('/');
         if (index == std::string::npos) {
@@ -15,8 +15,10 @@
 
 #include "hap_resource.h"
 
-#include <fstream>
+#include <atomic>
 #include <iostream>
+#include <mutex>
+#include <sys/stat.h>
 
 #ifdef __WINNT__
 #include <shlwapi.h>
@@ -28,11 +30,17 @@
 #if !defined(__WINNT__) && !defined(__IDE_PREVIEW__)
 #include "hitrace_meter.h"
 #endif
+#include "auto_mutex.h"
 #include "hap_parser.h"
 #include "hilog_wrapper.h"
 #include "locale_matcher.h"
+#include "securec.h"
 #include "utils/errors.h"
+#include "utils/index_v2.h"
+#include "utils/long_string_store.h"
+#include "utils/mapped_file.h"
 #include "utils/string_utils.h"
+#include "utils/thread_pool.h"
 
 #if defined(__linux__)
 #include <malloc.h>
@@ -41,6 +49,57 @@
 namespace OHOS {
 namespace Global {
 namespace Resource {
+namespace {
+struct SharedResource {
+    const HapResource *resource;
+
+    size_t refs;
+};
+
+std::mutex g_sharedLock;
+
+// keyed by the canonical path, the modification time, size and inode of the file, and the locale parsed
+std::unordered_map<std::string, SharedResource> g_sharedResources;
+
+std::unordered_map<const HapResource *, std::string> g_sharedKeys;
+
+// 0 if the long strings are not compressed
+std::atomic<size_t> g_longStringThreshold(0);
+
+bool IsHapPath(const std::string &path)
+{
+    static const std::string suffix = ".hap";
+    return path.length() > suffix.length() &&
+        path.compare(path.length() - suffix.length(), suffix.length(), suffix) == 0;
+}
+
+time_t GetModTime(const char *path)
+{
+    struct stat fileStat = {};
+    if (path == nullptr || stat(path, &fileStat) != 0) {
+        return 0;
+    }
+    return fileStat.st_mtime;
+}
+
+// the mod time with the nanoseconds, the size and the inode of a file, empty if it can not be stat. The seconds of
+// the mod time miss a rewrite within the same second, the inode changes on a replace
+std::string GetFileStamp(const char *path)
+{
+    struct stat fileStat = {};
+    if (path == nullptr || stat(path, &fileStat) != 0) {
+        return std::string();
+    }
+#ifdef __WINNT__
+    long modTimeNsec = 0;
+#else
+    long modTimeNsec = fileStat.st_mtim.tv_nsec;
+#endif
+    return std::to_string(fileStat.st_mtime) + "." + std::to_string(modTimeNsec) + "|" +
+        std::to_string(fileStat.st_size) + "|" + std::to_string(fileStat.st_ino);
+}
+} // namespace
+
 HapResource::ValueUnderQualifierDir::ValueUnderQualifierDir(const std::vector<KeyParam *> &keyParams, IdItem *idItem,
     HapResource *hapResource, bool isOverlay) : hapResource_(hapResource)
 {
@@ -62,6 +121,12 @@ void HapResource::ValueUnderQualifierDir::InitResConfig()
     resConfig_ = HapParser::CreateResConfigFromKeyParams(keyParams_);
 }
 
+std::string_view HapResource::ValueUnderQualifierDir::GetValue(std::shared_ptr<const std::string> &holder) const
+{
+    const LongStringStore *longStrings = (hapResource_ == nullptr) ? nullptr : hapResource_->GetLongStrings();
+    return idItem_->GetValue(longStrings, holder);
+}
+
 // IdValues
 HapResource::IdValues::~IdValues()
 {
@@ -85,6 +150,9 @@ HapResource::~HapResource()
         IdValues *ptr = iter->second;
         delete (ptr);
     }
+    for (size_t i = 0; i < unmatchedIdValues_.size(); ++i) {
+        delete (unmatchedIdValues_[i]);
+    }
 
     for (size_t i = 0; i < idValuesNameMap_.size(); ++i) {
         delete (idValuesNameMap_[i]);
@@ -120,49 +188,196 @@ void CanonicalizePath(const char *path, char *outPath, size_t len)
 #endif
 }
 
+std::string HapResource::GetCanonicalPath(const std::string &path)
+{
+    char outPath[PATH_MAX + 1] = {0};
+    CanonicalizePath(path.c_str(), outPath, PATH_MAX);
+    return (outPath[0] == '\0') ? path : std::string(outPath);
+}
+
 const HapResource *HapResource::LoadFromIndex(const char *path, const ResConfigImpl *defaultConfig, bool system)
 {
+    // taken before the file is read, so a change made during the read is found by the next check
+    time_t modTime = GetModTime(path);
+    std::string fileStamp = GetFileStamp(path);
+    if (path != nullptr && IsHapPath(path)) {
+        HapResource *pResource = const_cast<HapResource *>(LoadFromHap(path, defaultConfig));
+        if (pResource != nullptr) {
+            pResource->lastModTime_ = modTime;
+            pResource->fileStamp_ = fileStamp;
+        }
+        return pResource;
+    }
     char outPath[PATH_MAX + 1] = {0};
     CanonicalizePath(path, outPath, PATH_MAX);
-    std::ifstream inFile(outPath, std::ios::binary | std::ios::in);
-    if (!inFile.good()) {
+    // a version 1 index is parsed out of the mapping, a version 2 one keeps it
+    std::shared_ptr<const MappedFile> file = MappedFile::Open(outPath);
+    if (file == nullptr) {
         return nullptr;
     }
-    inFile.seekg(0, std::ios::end);
-    int bufLen = inFile.tellg();
-    if (bufLen <= 0) {
+    if (file->Size() == 0) {
         HILOG_ERROR("file size is zero");
-        inFile.close();
         return nullptr;
     }
-    void *buf = malloc(bufLen);
-    if (buf == nullptr) {
-        HILOG_ERROR("Error allocating memory");
-        inFile.close();
+    HapResource *pResource = LoadFromBuffer(std::string(path), file->Data(), file->Size(), defaultConfig, file);
+    if (pResource != nullptr) {
+        pResource->lastModTime_ = modTime;
+        pResource->fileStamp_ = fileStamp;
+    }
+    return pResource;
+}
+
+namespace {
+bool GetSharedKey(const char *path, const ResConfigImpl *defaultConfig, std::string &key)
+{
+    char outPath[PATH_MAX + 1] = {0};
+    CanonicalizePath(path, outPath, PATH_MAX);
+    std::string fileStamp = (outPath[0] == '\0') ? std::string() : GetFileStamp(outPath);
+    if (fileStamp.empty()) {
+        return false;
+    }
+    key = std::string(outPath) + "|" + fileStamp;
+    // only the keys matching the locale are parsed
+    const ResLocale *locale = (defaultConfig == nullptr) ? nullptr : defaultConfig->GetResLocale();
+    if (defaultConfig == nullptr) {
+        key.append("|*");
+    } else if (locale != nullptr) {
+        const char *parts[] = { locale->GetLanguage(), locale->GetScript(), locale->GetRegion() };
+        for (const char *part : parts) {
+            key.append("|").append(part == nullptr ? "" : part);
+        }
+    }
+    return true;
+}
+} // namespace
+
+const HapResource *HapResource::Acquire(const char *path, const ResConfigImpl *defaultConfig)
+{
+    std::string key;
+    if (path == nullptr || !GetSharedKey(path, defaultConfig, key)) {
+        return LoadFromIndex(path, defaultConfig);
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_sharedLock);
+        auto iter = g_sharedResources.find(key);
+        if (iter != g_sharedResources.end()) {
+            iter->second.refs++;
+            return iter->second.resource;
+        }
+    }
+    // loaded without the lock, the loads of different files do not wait for each other
+    const HapResource *resource = LoadFromIndex(path, defaultConfig);
+    if (resource == nullptr) {
         return nullptr;
     }
-    inFile.seekg(0, std::ios::beg);
-    inFile.read(static_cast<char *>(buf), bufLen);
-    inFile.close();
+    std::lock_guard<std::mutex> lock(g_sharedLock);
+    auto iter = g_sharedResources.find(key);
+    if (iter != g_sharedResources.end()) {
+        // another load of the file is done first
+        delete resource;
+        iter->second.refs++;
+        return iter->second.resource;
+    }
+    g_sharedResources[key] = { resource, 1 };
+    g_sharedKeys[resource] = key;
+    return resource;
+}
+
+void HapResource::Release(const HapResource *resource)
+{
+    if (resource == nullptr) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_sharedLock);
+        auto key = g_sharedKeys.find(resource);
+        if (key != g_sharedKeys.end()) {
+            auto iter = g_sharedResources.find(key->second);
+            if (iter != g_sharedResources.end() && --iter->second.refs > 0) {
+                return;
+            }
+            g_sharedResources.erase(key->second);
+            g_sharedKeys.erase(key);
+        }
+    }
+    delete resource;
+}
 
-    HILOG_DEBUG("extract success, bufLen:%d", bufLen);
+size_t HapResource::GetSharedCount()
+{
+    std::lock_guard<std::mutex> lock(g_sharedLock);
+    return g_sharedResources.size();
+}
 
+void HapResource::SetLongStringThreshold(size_t threshold)
+{
+    g_longStringThreshold.store(threshold, std::memory_order_relaxed);
+}
+
+const HapResource *HapResource::LoadFromHap(const char *path, const ResConfigImpl *defaultConfig)
+{
+    std::string errInfo;
+    std::shared_ptr<ZipArchive> archive = ZipArchive::Open(path, errInfo);
+    if (archive == nullptr) {
+        HILOG_ERROR("open hap failed! %s", errInfo.c_str());
+        return nullptr;
+    }
+    std::string indexEntry;
+    if (HapParser::GetIndexEntryName(*archive, indexEntry, errInfo) != OK) {
+        HILOG_ERROR("GetIndexEntryName failed! %s", errInfo.c_str());
+        return nullptr;
+    }
+    ZipArchive::View *view = archive->ReadEntry(indexEntry, errInfo);
+    if (view == nullptr) {
+        HILOG_ERROR("read index failed! %s", errInfo.c_str());
+        return nullptr;
+    }
+    std::shared_ptr<const ZipArchive::View> owner(view);
+    HapResource *pResource = LoadFromBuffer(std::string(path), view->Data(), view->Size(), defaultConfig, owner);
+    if (pResource == nullptr) {
+        return nullptr;
+    }
+    pResource->archive_ = archive;
+    // "assets/entry/resources.index" -> "assets/entry/resources/"
+    pResource->resourcesEntryPrefix_ = indexEntry.substr(0, indexEntry.rfind('/') + 1) + "resources/";
+    return pResource;
+}
+
+HapResource *HapResource::LoadFromBuffer(const std::string &path, const char *buffer, size_t bufLen,
+    const ResConfigImpl *defaultConfig, std::shared_ptr<const void> owner)
+{
     ResDesc *resDesc = new (std::nothrow) ResDesc();
     if (resDesc == nullptr) {
         HILOG_ERROR("new ResDesc failed when LoadFromIndex");
-        free(buf);
         return nullptr;
     }
-    int32_t out = HapParser::ParseResHex(static_cast<char *>(buf), bufLen, *resDesc, defaultConfig);
+    size_t threshold = g_longStringThreshold.load(std::memory_order_relaxed);
+    if (IndexV2::IsIndexV2(buffer, bufLen)) {
+        // the tables are read in place, an entry of a hap may be unaligned
+        if (reinterpret_cast<uintptr_t>(buffer) % IndexV2::ALIGNMENT != 0) {
+            std::shared_ptr<char> copy(static_cast<char *>(malloc(bufLen)), free);
+            if (copy == nullptr || memcpy_s(copy.get(), bufLen, buffer, bufLen) != OK) {
+                HILOG_ERROR("copy index failed");
+                delete (resDesc);
+                return nullptr;
+            }
+            buffer = copy.get();
+            owner = copy;
+        }
+        resDesc->buffer_ = owner;
+    } else if (threshold > 0) {
+        // the strings are kept expanded if it fails
+        resDesc->longStrings_ = new (std::nothrow) LongStringStore(threshold);
+    }
+    int32_t out = HapParser::ParseResHex(buffer, bufLen, *resDesc, defaultConfig, true);
     if (out != OK) {
         delete (resDesc);
-        free(buf);
         HILOG_ERROR("ParseResHex failed! retcode:%d", out);
         return nullptr;
     }
-    free(buf);
 
-    HapResource *pResource = new (std::nothrow) HapResource(std::string(path), 0, defaultConfig, resDesc);
+    // the resource may be shared by several managers, the config of one of them is only used by the parse
+    HapResource *pResource = new (std::nothrow) HapResource(path, 0, nullptr, resDesc);
     if (pResource == nullptr) {
         HILOG_ERROR("new HapResource failed when LoadFromIndex");
         delete (resDesc);
@@ -179,80 +394,90 @@ const std::unordered_map<std::string, HapResource *> HapResource::LoadOverlays(c
     const std::vector<std::string> &overlayPaths, const ResConfigImpl *defaultConfig)
 {
     std::unordered_map<std::string, HapResource *> result;
+    // index 0 is the target, the others are overlays, they are independent of each other.
+    // the target is shared, so it is parsed once whoever loads it, with or without overlays.
+    std::vector<const HapResource *> loaded(overlayPaths.size() + 1, nullptr);
+    ThreadPool::GetInstance().ParallelFor(loaded.size(), [&](size_t i) {
+        if (i == 0) {
+            loaded[i] = Acquire(path.c_str(), defaultConfig);
+        } else {
+            loaded[i] = LoadFromIndex(overlayPaths[i - 1].c_str(), defaultConfig);
+        }
+    });
     do {
-        const HapResource *targetResource = LoadFromIndex(path.c_str(), defaultConfig);
+        const HapResource *targetResource = loaded[0];
         if (targetResource == nullptr) {
             HILOG_ERROR("load target failed");
             break;
         }
-        result[path] = const_cast<HapResource*>(targetResource);
         bool success = true;
-        std::unordered_map<std::string, std::unordered_map<ResType, uint32_t>> mapping =
-            targetResource->BuildNameTypeIdMapping();
-        for (auto iter = overlayPaths.begin(); iter != overlayPaths.end(); iter++) {
-            const HapResource *overlayResource = LoadFromIndex(iter->c_str(), defaultConfig);
-            if (overlayResource == nullptr) {
+        for (size_t i = 0; i < overlayPaths.size(); i++) {
+            if (loaded[i + 1] == nullptr) {
                 HILOG_ERROR("load overlay failed");
                 success = false;
                 break;
             }
-            result[*iter] = const_cast<HapResource*>(overlayResource);
         }
-
-        if (success) {
-            for (auto iter = result.begin(); iter != result.end(); iter++) {
-                auto index = iter->first.find(path);
-                if (index == std::string::npos) {
-                    iter->second->UpdateOverlayInfo(mapping);
-                }
-            }
-            return result;
+        if (!success) {
+            break;
         }
+        result[path] = const_cast<HapResource *>(targetResource);
+        for (size_t i = 0; i < overlayPaths.size(); i++) {
+            HapResource *overlayResource = const_cast<HapResource *>(loaded[i + 1]);
+            overlayResource->UpdateOverlayInfo(*targetResource);
+            result[overlayPaths[i]] = overlayResource;
+        }
+        return result;
     } while (false);
 
-    for_each (result.begin(), result.end(), [](auto &iter) {
-        delete iter.second;
+    for_each (loaded.begin(), loaded.end(), [](auto &resource) {
+        Release(resource);
     });
     return std::unordered_map<std::string, HapResource *>();
 }
 
-std::unordered_map<std::string, std::unordered_map<ResType, uint32_t>> HapResource::BuildNameTypeIdMapping() const
+const HapResource *HapResource::LoadOverlay(const std::string &path, const HapResource &target,
+    const ResConfigImpl *defaultConfig)
 {
-    std::unordered_map<std::string, std::unordered_map<ResType, uint32_t>> result;
-    for (auto iter = idValuesMap_.begin(); iter != idValuesMap_.end(); iter++) {
-        const std::vector<ValueUnderQualifierDir *> &limitPaths = iter->second->GetLimitPathsConst();
-        if (limitPaths.size() > 0) {
-            ValueUnderQualifierDir* value = limitPaths[0];
-            result[value->idItem_->name_][value->idItem_->resType_] = value->idItem_->id_;
-        }
+    HapResource *overlay = const_cast<HapResource *>(LoadFromIndex(path.c_str(), defaultConfig));
+    if (overlay == nullptr) {
+        HILOG_ERROR("load overlay failed");
+        return nullptr;
     }
-    return result;
+    overlay->UpdateOverlayInfo(target);
+    return overlay;
 }
 
-void HapResource::UpdateOverlayInfo(std::unordered_map<std::string, std::unordered_map<ResType, uint32_t>> &nameTypeId)
+void HapResource::UpdateOverlayInfo(const HapResource &target)
 {
+    // the names table of a version 2 index has the ids before they are remapped
+    if (namesInIndex_) {
+        for (auto iter = idValuesMap_.begin(); iter != idValuesMap_.end(); iter++) {
+            const IdItem *idItem = iter->second->GetLimitPathsConst()[0]->idItem_;
+            idValuesNameMap_[idItem->resType_]->emplace(std::string(idItem->name_), iter->second);
+        }
+        namesInIndex_ = false;
+    }
+    // the ids are remapped by the name index of the target, which is built when the target is parsed
     std::map<uint32_t, IdValues *> newIdValuesMap;
     for (auto iter = idValuesMap_.begin(); iter != idValuesMap_.end(); iter++) {
         const std::vector<ValueUnderQualifierDir *> &limitPaths = iter->second->GetLimitPathsConst();
-        uint32_t newId = 0;
-        if (limitPaths.size() > 0) {
-            ValueUnderQualifierDir *value = limitPaths[0];
-            std::string name = value->idItem_->name_;
-            ResType type = value->idItem_->resType_;
-            if (nameTypeId.find(name) == nameTypeId.end()) {
-                continue;
-            }
-            auto &typeId = nameTypeId[name];
-            if (typeId.find(type) == typeId.end()) {
-                continue;
-            }
-            newId = typeId[type];
-            for_each(limitPaths.begin(), limitPaths.end(), [&](auto &item) {
-                item->idItem_->id_ = newId;
-                item->isOverlay_ = true;
-            });
-            newIdValuesMap[newId] = iter->second;
+        if (limitPaths.size() == 0) {
+            unmatchedIdValues_.push_back(iter->second);
+            continue;
+        }
+        const IdItem *idItem = limitPaths[0]->idItem_;
+        int newId = target.GetIdByName(idItem->name_.data(), idItem->resType_);
+        if (newId < 0) {
+            // not in the target, it is never found by id, but it is still referred by the name index
+            unmatchedIdValues_.push_back(iter->second);
+            continue;
         }
+        for_each(limitPaths.begin(), limitPaths.end(), [&](auto &item) {
+            item->idItem_->id_ = static_cast<uint32_t>(newId);
+            item->isOverlay_ = true;
+        });
+        newIdValuesMap.emplace_hint(newIdValuesMap.end(), static_cast<uint32_t>(newId), iter->second);
     }
     idValuesMap_.swap(newIdValuesMap);
 }
@@ -293,12 +518,57 @@ bool HapResource::Init()
     return InitIdList();
 }
 
+std::shared_ptr<const RawFileIndex> HapResource::GetRawFileIndex() const
+{
+    AutoMutex mutex(this->rawFileIndexLock_);
+    if (rawFileIndex_ == nullptr) {
+        RescanRawFilesLocked();
+    }
+    return rawFileIndex_;
+}
+
+void HapResource::RescanRawFiles() const
+{
+    AutoMutex mutex(this->rawFileIndexLock_);
+    RescanRawFilesLocked();
+}
+
+bool HapResource::RescanRawFilesIfChanged() const
+{
+    AutoMutex mutex(this->rawFileIndexLock_);
+    if (rawFileIndex_ == nullptr || !rawFileIndex_->IsChanged()) {
+        return false;
+    }
+    RescanRawFilesLocked();
+    return true;
+}
+
+void HapResource::RescanRawFilesLocked() const
+{
+    if (IsHap()) {
+        rawFileIndex_.reset(RawFileIndex::BuildFromZip(*archive_, resourcesEntryPrefix_));
+        return;
+    }
+#ifdef __WINNT__
+    char separator = '\\';
+#else
+    char separator = '/';
+#endif
+    auto index = indexPath_.rfind(separator);
+    if (index == std::string::npos) {
+        HILOG_ERROR("index path format error, %s", indexPath_.c_str());
+        return;
+    }
+    rawFileIndex_.reset(RawFileIndex::BuildFromDirectory(indexPath_.substr(0, index) + "/resources/"));
+}
+
 bool HapResource::InitIdList()
 {
     if (resDesc_ == nullptr) {
         HILOG_ERROR("resDesc_ is null ! InitIdList failed");
         return false;
     }
+    namesInIndex_ = (resDesc_->indexV2_ != nullptr);
     for (size_t i = 0; i < resDesc_->keys_.size(); i++) {
         ResKey *resKey = resDesc_->keys_[i];
 
@@ -321,6 +591,9 @@ bool HapResource::InitIdList()
                 }
                 idValues->AddLimitPath(limitPath);
                 idValuesMap_.insert(std::make_pair(id, idValues));
+                if (namesInIndex_) {
+                    continue;
+                }
                 std::string name = std::string(idParam->idItem_->name_);
                 idValuesNameMap_[idParam->idItem_->resType_]->insert(std::make_pair(name, idValues));
             } else {
@@ -352,6 +625,19 @@ const HapResource::IdValues *HapResource::GetIdValues(const uint32_t id) const
 const HapResource::IdValues *HapResource::GetIdValuesByName(
     const std::string name, const ResType resType) const
 {
+    return FindIdValuesByName(name, resType);
+}
+
+const HapResource::IdValues *HapResource::FindIdValuesByName(const std::string &name, ResType resType) const
+{
+    if (namesInIndex_) {
+        int32_t index = resDesc_->indexV2_->FindId(resType, name);
+        if (index < 0) {
+            return nullptr;
+        }
+        auto iter = idValuesMap_.find(resDesc_->indexV2_->GetIds()[index].id);
+        return (iter == idValuesMap_.end()) ? nullptr : iter->second;
+    }
     const std::map<std::string, IdValues *> *map = idValuesNameMap_[resType];
     std::map<std::string, IdValues *>::const_iterator iter = map->find(name);
     if (iter == map->end()) {
@@ -361,17 +647,110 @@ const HapResource::IdValues *HapResource::GetIdValuesByName(
     return iter->second;
 }
 
+bool HapResource::IsChanged() const
+{
+    return GetFileStamp(indexPath_.c_str()) != fileStamp_;
+}
+
+void HapResource::GetIds(std::vector<uint32_t> &ids) const
+{
+    ids.reserve(ids.size() + idValuesMap_.size());
+    for (auto iter = idValuesMap_.begin(); iter != idValuesMap_.end(); ++iter) {
+        ids.push_back(iter->first);
+    }
+}
+
+void HapResource::GetMemoryUsage(MemoryUsage &usage) const
+{
+    std::call_once(indexUsageOnce_, [this] { indexUsage_ = MeasureIndex(); });
+    usage += indexUsage_;
+    if (resDesc_ != nullptr && resDesc_->longStrings_ != nullptr) {
+        usage.valueCache += resDesc_->longStrings_->GetCacheUsage();
+    }
+    AutoMutex mutex(this->rawFileIndexLock_);
+    if (rawFileIndex_ != nullptr) {
+        usage.rawFileIndex += rawFileIndex_->GetMemoryUsage();
+    }
+}
+
+void HapResource::TrimCaches() const
+{
+    if (resDesc_ != nullptr && resDesc_->longStrings_ != nullptr) {
+        resDesc_->longStrings_->ClearCache();
+    }
+}
+
+const LongStringStore *HapResource::GetLongStrings() const
+{
+    return (resDesc_ == nullptr) ? nullptr : resDesc_->longStrings_;
+}
+
+MemoryUsage HapResource::MeasureIndex() const
+{
+    MemoryUsage usage;
+    if (resDesc_ != nullptr) {
+        usage.resDesc += sizeof(ResDesc) + sizeof(ResHeader) + MemoryUsage::Of(resDesc_->keys_);
+        usage.idItems += resDesc_->stringPool_.GetMemoryUsage();
+        if (resDesc_->longStrings_ != nullptr) {
+            usage.idItems += sizeof(LongStringStore) + resDesc_->longStrings_->GetMemoryUsage();
+        }
+        for (const ResKey *resKey : resDesc_->keys_) {
+            usage.resDesc += sizeof(ResKey) + MemoryUsage::Of(resKey->keyParams_);
+            for (const KeyParam *keyParam : resKey->keyParams_) {
+                usage.resDesc += sizeof(KeyParam) + MemoryUsage::Of(keyParam->GetStr());
+            }
+            if (resKey->resId_ == nullptr) {
+                continue;
+            }
+            usage.resDesc += sizeof(ResId) + MemoryUsage::Of(resKey->resId_->idParams_);
+            for (const IdParam *idParam : resKey->resId_->idParams_) {
+                usage.resDesc += sizeof(IdParam);
+                const IdItem *idItem = idParam->idItem_;
+                if (idItem == nullptr) {
+                    continue;
+                }
+                usage.idItems += sizeof(IdItem) + MemoryUsage::Of(idItem->values_);
+            }
+        }
+    }
+    auto measureValues = [&usage](const IdValues *idValues) {
+        usage.values += sizeof(IdValues) + MemoryUsage::Of(idValues->GetLimitPathsConst());
+        for (const ValueUnderQualifierDir *path : idValues->GetLimitPathsConst()) {
+            usage.values += sizeof(ValueUnderQualifierDir) + MemoryUsage::Of(path->keyParams_) +
+                MemoryUsage::Of(path->folder_);
+            const ResConfigImpl *resConfig = path->GetResConfig();
+            if (resConfig != nullptr) {
+                usage.configs += sizeof(ResConfigImpl);
+                usage.configs += (resConfig->GetResLocale() != nullptr) ? sizeof(ResLocale) : 0;
+            }
+        }
+    };
+    for (auto iter = idValuesMap_.begin(); iter != idValuesMap_.end(); ++iter) {
+        measureValues(iter->second);
+    }
+    for (const IdValues *idValues : unmatchedIdValues_) {
+        measureValues(idValues);
+    }
+    usage.maps += MemoryUsage::Of(idValuesMap_) + MemoryUsage::Of(unmatchedIdValues_) +
+        MemoryUsage::Of(idValuesNameMap_);
+    for (const std::map<std::string, IdValues *> *nameMap : idValuesNameMap_) {
+        usage.maps += sizeof(*nameMap) + MemoryUsage::Of(*nameMap);
+        for (auto iter = nameMap->begin(); iter != nameMap->end(); ++iter) {
+            usage.maps += MemoryUsage::Of(iter->first);
+        }
+    }
+    return usage;
+}
+
 int HapResource::GetIdByName(const char *name, const ResType resType) const
 {
     if (name == nullptr) {
         return -1;
     }
-    const std::map<std::string, IdValues *> *map = idValuesNameMap_[resType];
-    std::map<std::string, IdValues *>::const_iterator iter = map->find(name);
-    if (iter == map->end()) {
+    const IdValues *ids = FindIdValuesByName(name, resType);
+    if (ids == nullptr) {
         return OBJ_NOT_FOUND;
     }
-    const IdValues *ids = iter->second;
 
     if (ids->GetLimitPathsConst().size() == 0) {
         HILOG_ERROR("limitPaths empty");
@@ -31,6 +31,11 @@ bool Lock::lock()
     return true;
 }
 
+bool Lock::try_lock()
+{
+    return this->mtx_->try_lock();
+}
+
 bool Lock::unlock()
 {
     this->mtx_->unlock();
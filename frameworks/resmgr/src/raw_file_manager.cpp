@@ -15,9 +15,12 @@
 
 #include "raw_file_manager.h"
 
+#include <cerrno>
+#include <condition_variable>
 #include <cstdio>
-#include <dirent.h>
 #include <fcntl.h>
+#include <mutex>
+#include <sys/mman.h>
 #include <unistd.h>
 
 #include "raw_dir.h"
@@ -25,6 +28,8 @@
 #include "resource_manager.h"
 #include "resource_manager_addon.h"
 #include "resource_manager_impl.h"
+#include "utils/thread_pool.h"
+#include "utils/zip_entry_reader.h"
 #include "hilog/log.h"
 
 #ifdef __WINNT__
@@ -39,6 +44,47 @@ using namespace OHOS::HiviewDFX;
 
 namespace {
     constexpr HiLogLabel LABEL = {LOG_CORE, 0xD001E00, "RawFile"};
+
+    // indexed by RawFileAdvice
+    constexpr int MADVICES[] = { MADV_NORMAL, MADV_SEQUENTIAL, MADV_RANDOM, MADV_WILLNEED, MADV_DONTNEED };
+    constexpr int FADVICES[] = { POSIX_FADV_NORMAL, POSIX_FADV_SEQUENTIAL, POSIX_FADV_RANDOM, POSIX_FADV_WILLNEED,
+        POSIX_FADV_DONTNEED };
+    constexpr int ADVICE_COUNT = sizeof(MADVICES) / sizeof(MADVICES[0]);
+
+    // a mapping starts at a page boundary, data is inside its first page
+    bool GetMapping(const void *data, long length, void *&base, size_t &baseLength)
+    {
+        if (data == nullptr || length <= 0) {
+            return false;
+        }
+        uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+        uintptr_t address = reinterpret_cast<uintptr_t>(data);
+        uintptr_t aligned = address - address % pageSize;
+        base = reinterpret_cast<void *>(aligned);
+        baseLength = static_cast<size_t>(length) + (address - aligned);
+        return true;
+    }
+
+    long PreadFully(int fd, void *buf, size_t length, off_t offset)
+    {
+        size_t total = 0;
+        while (total < length) {
+            ssize_t count = pread(fd, static_cast<char *>(buf) + total, length - total,
+                offset + static_cast<off_t>(total));
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count < 0) {
+                HiLog::Error(LABEL, "failed to pread the rawFile, errno %{public}d", errno);
+                return total > 0 ? static_cast<long>(total) : -1;
+            }
+            if (count == 0) {
+                break;
+            }
+            total += static_cast<size_t>(count);
+        }
+        return static_cast<long>(total);
+    }
 }
 
 struct NativeResourceManager {
@@ -55,13 +101,32 @@ struct RawDir {
     struct FileNameCache fileNameCache;
 };
 
+struct RawFileBatch {
+    RawFileReadRequest *requests = nullptr;
+    size_t count = 0;
+    RawFileBatchCallback callback = nullptr;
+    void *userData = nullptr;
+    // the reads of one raw file, they run in one task
+    std::vector<std::pair<HapManager::RawFileLocation, std::vector<size_t>>> groups;
+    size_t pendingGroups = 0;
+    bool done = false;
+    mutable std::mutex lock;
+    mutable std::condition_variable cond;
+};
+
 struct RawFile {
     const std::string filePath;
     long offset;
     long length;
     FILE* pf;
+    // a raw file compressed in the hap is inflated by reader, position is the current uncompressed offset
+    std::unique_ptr<ZipEntryReader> reader;
+    mutable long position;
+    // the reader keeps the inflate state, it is used by one thread at a time
+    mutable std::mutex readerLock;
 
-    explicit RawFile(const std::string &path) : filePath(path), offset(0L), length(0L), pf(nullptr) {}
+    explicit RawFile(const std::string &path)
+        : filePath(path), offset(0L), length(0L), pf(nullptr), reader(nullptr), position(0L) {}
 
     ~RawFile()
     {
@@ -110,35 +175,9 @@ RawDir *OH_ResourceManager_OpenRawDir(const NativeResourceManager *mgr, const ch
         return nullptr;
     }
     ResourceManagerImpl* impl = static_cast<ResourceManagerImpl *>(mgr->resManager.get());
-    std::string tempName = dirName;
-    const std::string rawFileDirName = "rawfile/";
-    if (tempName.length() < rawFileDirName.length()
-        || (tempName.compare(0, rawFileDirName.length(), rawFileDirName) != 0)) {
-        tempName = rawFileDirName + tempName;
-    }
     std::unique_ptr<RawDir> result = std::make_unique<RawDir>();
-    std::vector<std::string> resourcesPaths = impl->GetResourcePaths();
-    for (auto iter = resourcesPaths.begin(); iter != resourcesPaths.end(); iter++) {
-        std::string currentPath = *iter + tempName;
-        DIR* dir = opendir(currentPath.c_str());
-        if (dir == nullptr) {
-            continue;
-        }
-        struct dirent *dirp = readdir(dir);
-        while (dirp != nullptr) {
-            if (std::strcmp(dirp->d_name, ".") == 0 ||
-                std::strcmp(dirp->d_name, "..") == 0) {
-                dirp = readdir(dir);
-                continue;
-            }
-            if (dirp->d_type == DT_REG) {
-                result->fileNameCache.names.push_back(tempName + "/" + dirp->d_name);
-            }
-
-            dirp = readdir(dir);
-        }
-        closedir(dir);
-    }
+    // listed from the raw file indexes, an unknown directory is empty
+    impl->GetRawFileList(dirName, false, result->fileNameCache.names);
     return result.release();
 }
 
@@ -148,19 +187,30 @@ RawFile *OH_ResourceManager_OpenRawFile(const NativeResourceManager *mgr, const
         return nullptr;
     }
 
-    std::string filePath;
-    RState state = mgr->resManager->GetRawFilePathByName(fileName, filePath);
+    ResourceManagerImpl* impl = static_cast<ResourceManagerImpl *>(mgr->resManager.get());
+    HapManager::RawFileLocation location;
+    RState state = impl->GetRawFileLocation(fileName, location);
     if (state != SUCCESS) {
         return nullptr;
     }
-    std::unique_ptr<RawFile> result = std::make_unique<RawFile>(filePath);
+    if (location.entry != nullptr && location.entry->method != ZipArchive::METHOD_STORED) {
+        std::unique_ptr<RawFile> result = std::make_unique<RawFile>(location.path);
+        result->reader = std::make_unique<ZipEntryReader>(location.archive, *location.entry, location.offset);
+        if (!result->reader->Init()) {
+            HiLog::Error(LABEL, "%{public}s is compressed in the hap and can not be inflated", fileName);
+            return nullptr;
+        }
+        result->length = static_cast<long>(location.entry->uncompressedSize);
+        return result.release();
+    }
+    // a raw file stored in a hap is read in place, it is the range [offset, offset + length) of the hap
+    std::unique_ptr<RawFile> result = std::make_unique<RawFile>(location.path);
     if (!result->open()) {
         return nullptr;
     }
-
-    std::fseek(result->pf, 0, SEEK_END);
-    result->length = ftell(result->pf);
-    std::fseek(result->pf, 0, SEEK_SET);
+    result->offset = static_cast<long>(location.offset);
+    result->length = static_cast<long>(location.length);
+    std::fseek(result->pf, result->offset, SEEK_SET);
     return result.release();
 }
 
@@ -196,14 +246,55 @@ int OH_ResourceManager_ReadRawFile(const RawFile *rawFile, void *buf, size_t len
     if (rawFile == nullptr || buf == nullptr || length == 0) {
         return 0;
     }
+    if (rawFile->reader != nullptr) {
+        std::lock_guard<std::mutex> lock(rawFile->readerLock);
+        size_t count = rawFile->reader->Read(static_cast<uint64_t>(rawFile->position), buf, length);
+        rawFile->position += static_cast<long>(count);
+        return static_cast<int>(count);
+    }
+    // do not read beyond the raw file when it is a part of the hap
+    long remaining = rawFile->offset + rawFile->length - ftell(rawFile->pf);
+    if (remaining <= 0) {
+        return 0;
+    }
+    if (length > static_cast<size_t>(remaining)) {
+        length = static_cast<size_t>(remaining);
+    }
     return std::fread(buf, 1, length, rawFile->pf);
 }
 
+static int SeekCompressedRawFile(const RawFile *rawFile, long offset, int whence)
+{
+    // only the position moves, the data is inflated from the nearest checkpoint when read
+    long start = 0;
+    switch (whence) {
+        case SEEK_SET:
+            start = offset;
+            break;
+        case SEEK_CUR:
+            start = rawFile->position + offset;
+            break;
+        case SEEK_END:
+            start = rawFile->length + offset;
+            break;
+        default:
+            return -1;
+    }
+    if (start < 0) {
+        return -1;
+    }
+    rawFile->position = start;
+    return 0;
+}
+
 int OH_ResourceManager_SeekRawFile(const RawFile *rawFile, long offset, int whence)
 {
     if (rawFile == nullptr) {
         return 0;
     }
+    if (rawFile->reader != nullptr) {
+        return SeekCompressedRawFile(rawFile, offset, whence);
+    }
 
     int origin = 0;
     int start = 0;
@@ -248,6 +339,9 @@ long OH_ResourceManager_GetRawFileOffset(const RawFile *rawFile)
     if (rawFile == nullptr) {
         return 0;
     }
+    if (rawFile->reader != nullptr) {
+        return rawFile->position;
+    }
     return ftell(rawFile->pf) - rawFile->offset;
 }
 
@@ -256,6 +350,10 @@ bool OH_ResourceManager_GetRawFileDescriptor(const RawFile *rawFile, RawFileDesc
     if (rawFile == nullptr) {
         return false;
     }
+    if (rawFile->reader != nullptr) {
+        HiLog::Error(LABEL, "the rawFile is compressed in the hap, no descriptor of it");
+        return false;
+    }
     char paths[PATH_MAX] = {0};
 #ifdef __WINNT__
     if (!PathCanonicalizeA(paths, rawFile->filePath.c_str())) {
@@ -284,3 +382,223 @@ bool OH_ResourceManager_ReleaseRawFileDescriptor(const RawFileDescriptor &descri
     }
     return true;
 }
+
+long OH_ResourceManager_ReadRawFileAt(const RawFile *rawFile, void *buf, size_t length, long offset)
+{
+    if (rawFile == nullptr || buf == nullptr || offset < 0) {
+        return -1;
+    }
+    if (length == 0 || offset >= rawFile->length) {
+        return 0;
+    }
+    if (length > static_cast<size_t>(rawFile->length - offset)) {
+        length = static_cast<size_t>(rawFile->length - offset);
+    }
+    if (rawFile->reader != nullptr) {
+        std::lock_guard<std::mutex> lock(rawFile->readerLock);
+        return static_cast<long>(rawFile->reader->Read(static_cast<uint64_t>(offset), buf, length));
+    }
+    // pread leaves the offset of pf alone, so the reads of other threads are not affected
+    return PreadFully(fileno(rawFile->pf), buf, length, static_cast<off_t>(rawFile->offset + offset));
+}
+
+const void *OH_ResourceManager_MapRawFile(const RawFile *rawFile, long *length)
+{
+    if (rawFile == nullptr || length == nullptr) {
+        return nullptr;
+    }
+    *length = 0;
+    if (rawFile->reader != nullptr) {
+        HiLog::Error(LABEL, "the rawFile is compressed in the hap, it can not be mapped");
+        return nullptr;
+    }
+    if (rawFile->length <= 0) {
+        return nullptr;
+    }
+    // the mapping offset must be page aligned, the raw file may start anywhere in the hap
+    long pageSize = sysconf(_SC_PAGESIZE);
+    long alignedOffset = rawFile->offset - rawFile->offset % pageSize;
+    size_t delta = static_cast<size_t>(rawFile->offset - alignedOffset);
+    void *base = mmap(nullptr, static_cast<size_t>(rawFile->length) + delta, PROT_READ, MAP_PRIVATE,
+        fileno(rawFile->pf), static_cast<off_t>(alignedOffset));
+    if (base == MAP_FAILED) {
+        HiLog::Error(LABEL, "failed to mmap the rawFile, errno %{public}d", errno);
+        return nullptr;
+    }
+    *length = rawFile->length;
+    return static_cast<const char *>(base) + delta;
+}
+
+bool OH_ResourceManager_UnmapRawFile(const void *data, long length)
+{
+    void *base = nullptr;
+    size_t baseLength = 0;
+    if (!GetMapping(data, length, base, baseLength)) {
+        return false;
+    }
+    return munmap(base, baseLength) == 0;
+}
+
+bool OH_ResourceManager_AdviseRawFile(const RawFile *rawFile, int advice)
+{
+    if (rawFile == nullptr || advice < 0 || advice >= ADVICE_COUNT) {
+        return false;
+    }
+    if (rawFile->reader != nullptr) {
+        return false;
+    }
+    return posix_fadvise(fileno(rawFile->pf), static_cast<off_t>(rawFile->offset),
+        static_cast<off_t>(rawFile->length), FADVICES[advice]) == 0;
+}
+
+bool OH_ResourceManager_AdviseMappedRawFile(const void *data, long length, int advice)
+{
+    void *base = nullptr;
+    size_t baseLength = 0;
+    if (advice < 0 || advice >= ADVICE_COUNT || !GetMapping(data, length, base, baseLength)) {
+        return false;
+    }
+    return madvise(base, baseLength, MADVICES[advice]) == 0;
+}
+
+static void ReadRawFileGroup(RawFileBatch *batch, const HapManager::RawFileLocation &location,
+    const std::vector<size_t> &indexes)
+{
+    std::unique_ptr<ZipEntryReader> reader;
+    int fd = -1;
+    if (location.entry != nullptr && location.entry->method != ZipArchive::METHOD_STORED) {
+        reader = std::make_unique<ZipEntryReader>(location.archive, *location.entry, location.offset);
+        if (!reader->Init()) {
+            reader = nullptr;
+        }
+    } else if (location.archive != nullptr) {
+        fd = location.archive->GetFd();
+    } else {
+        fd = open(location.path.c_str(), O_RDONLY);
+    }
+    for (size_t index : indexes) {
+        RawFileReadRequest &request = batch->requests[index];
+        long rawFileLength = static_cast<long>(location.length);
+        if (request.buf == nullptr || request.offset < 0 || (reader == nullptr && fd < 0)) {
+            request.result = -1;
+            continue;
+        }
+        if (request.length == 0 || request.offset >= rawFileLength) {
+            request.result = 0;
+            continue;
+        }
+        size_t length = std::min(request.length, static_cast<size_t>(rawFileLength - request.offset));
+        if (reader != nullptr) {
+            request.result = static_cast<long>(reader->Read(static_cast<uint64_t>(request.offset), request.buf,
+                length));
+        } else {
+            request.result = PreadFully(fd, request.buf, length,
+                static_cast<off_t>(location.offset) + static_cast<off_t>(request.offset));
+        }
+    }
+    if (location.archive == nullptr && fd >= 0) {
+        close(fd);
+    }
+}
+
+static void FinishRawFileBatch(RawFileBatch *batch)
+{
+    // the callback may release the batch, it is not used once it is done
+    RawFileBatchCallback callback = batch->callback;
+    RawFileReadRequest *requests = batch->requests;
+    size_t count = batch->count;
+    void *userData = batch->userData;
+    {
+        std::lock_guard<std::mutex> lock(batch->lock);
+        batch->done = true;
+        batch->cond.notify_all();
+    }
+    if (callback != nullptr) {
+        callback(requests, count, userData);
+    }
+}
+
+RawFileBatch *OH_ResourceManager_SubmitRawFileBatch(const NativeResourceManager *mgr, RawFileReadRequest *requests,
+    size_t count, RawFileBatchCallback callback, void *userData)
+{
+    if (mgr == nullptr || (requests == nullptr && count > 0)) {
+        return nullptr;
+    }
+    std::unique_ptr<RawFileBatch> batch = std::make_unique<RawFileBatch>();
+    batch->requests = requests;
+    batch->count = count;
+    batch->callback = callback;
+    batch->userData = userData;
+
+    // look up all raw files at once, then group the reads by the raw file
+    std::vector<std::string> names(count);
+    for (size_t i = 0; i < count; ++i) {
+        requests[i].result = -1;
+        names[i] = (requests[i].fileName != nullptr) ? requests[i].fileName : "";
+    }
+    ResourceManagerImpl* impl = static_cast<ResourceManagerImpl *>(mgr->resManager.get());
+    std::vector<HapManager::RawFileLocation> locations;
+    impl->GetRawFileLocations(names, locations);
+    std::unordered_map<std::string, size_t> groupIndexes;
+    for (size_t i = 0; i < count; ++i) {
+        if (locations[i].path.empty()) {
+            HiLog::Error(LABEL, "%{public}s not found", names[i].c_str());
+            continue;
+        }
+        std::string key = locations[i].path + ":" + std::to_string(locations[i].offset);
+        auto iter = groupIndexes.find(key);
+        if (iter == groupIndexes.end()) {
+            iter = groupIndexes.emplace(key, batch->groups.size()).first;
+            batch->groups.emplace_back(locations[i], std::vector<size_t>());
+        }
+        batch->groups[iter->second].second.push_back(i);
+    }
+
+    RawFileBatch *result = batch.release();
+    result->pendingGroups = result->groups.size();
+    if (result->pendingGroups == 0) {
+        FinishRawFileBatch(result);
+        return result;
+    }
+    // the reads of different raw files run in parallel, the last one to finish completes the batch
+    for (size_t i = 0; i < result->groups.size(); ++i) {
+        ThreadPool::GetInstance().Post([result, i] {
+            ReadRawFileGroup(result, result->groups[i].first, result->groups[i].second);
+            bool last = false;
+            {
+                std::lock_guard<std::mutex> lock(result->lock);
+                last = (--result->pendingGroups == 0);
+            }
+            if (last) {
+                FinishRawFileBatch(result);
+            }
+        });
+    }
+    return result;
+}
+
+bool OH_ResourceManager_IsRawFileBatchDone(const RawFileBatch *batch)
+{
+    if (batch == nullptr) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(batch->lock);
+    return batch->done;
+}
+
+void OH_ResourceManager_WaitRawFileBatch(const RawFileBatch *batch)
+{
+    if (batch == nullptr) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(batch->lock);
+    batch->cond.wait(lock, [batch] { return batch->done; });
+}
+
+void OH_ResourceManager_ReleaseRawFileBatch(RawFileBatch *batch)
+{
+    if (batch != nullptr) {
+        OH_ResourceManager_WaitRawFileBatch(batch);
+        delete batch;
+    }
+}
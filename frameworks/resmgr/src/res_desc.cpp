@@ -24,6 +24,8 @@
 #endif
 #include "utils/common.h"
 #include "utils/errors.h"
+#include "utils/index_v2.h"
+#include "utils/long_string_store.h"
 #include "utils/string_utils.h"
 
 namespace OHOS {
@@ -201,20 +203,18 @@ bool IdItem::HaveParent() const
     return (values_.size() % 2 == 1);
 }
 
-bool IdItem::IsRef(const std::string &value, ResType &resType, int &id)
+bool IdItem::IsRef(std::string_view value, ResType &resType, int &id)
 {
-    const char *it = value.c_str();
-    const char *st = it;
-    if (*st != '$') {
+    if (value.empty() || value[0] != '$') {
         return false;
     }
     auto index = value.find(":");
-    if (index == std::string::npos || index < 2) {
+    if (index == std::string_view::npos || index < 2) {
         return false;
     }
     std::string typeStr, idStr;
-    typeStr.assign(it + 1, index - 1);
-    idStr.assign(it + index + 1, value.size() - index);
+    typeStr.assign(value.data() + 1, index - 1);
+    idStr.assign(value.data() + index + 1, value.size() - index - 1);
 
     int idd = atoi(idStr.c_str());
     if (idd <= 0) {
@@ -238,20 +238,35 @@ std::string IdItem::ToString() const
 {
     std::string ret = FormatString(
         "[size:%u, resType:%d, id:%u, valueLen:%u, isArray:%d, name:'%s', value:",
-        size_, resType_, id_, valueLen_, isArray_, name_.c_str());
+        size_, resType_, id_, valueLen_, isArray_, name_.data());
     if (isArray_) {
         ret.append("[");
         for (size_t i = 0; i < values_.size(); ++i) {
-            ret.append(FormatString("'%s',", values_[i].c_str()));
+            ret.append(FormatString("'%s',", values_[i].data()));
         }
         ret.append("]");
+    } else if (isCompressed_) {
+        ret.append(FormatString("<compressed %zu bytes>", value_.size()));
     } else {
-        ret.append(FormatString("'%s'", value_.c_str()));
+        ret.append("'").append(value_).append("'");
     }
     ret.append("]");
     return ret;
 }
 
+std::string_view IdItem::GetValue(const LongStringStore *longStrings,
+    std::shared_ptr<const std::string> &holder) const
+{
+    if (!isCompressed_) {
+        return value_;
+    }
+    if (longStrings == nullptr) {
+        return std::string_view();
+    }
+    holder = longStrings->Decode(value_, valueLen_);
+    return (holder == nullptr) ? std::string_view() : std::string_view(*holder);
+}
+
 IdParam::~IdParam()
 {
     delete (idItem_);
@@ -301,7 +316,7 @@ std::string ResKey::ToString() const
     return ret;
 }
 
-ResDesc::ResDesc() : resHeader_(nullptr)
+ResDesc::ResDesc() : resHeader_(nullptr), longStrings_(nullptr), indexV2_(nullptr)
 {}
 
 ResDesc::~ResDesc()
@@ -312,6 +327,8 @@ ResDesc::~ResDesc()
         auto ptr = keys_[i];
         delete (ptr);
     }
+    delete (longStrings_);
+    delete (indexV2_);
 }
 
 std::string ResDesc::ToString() const
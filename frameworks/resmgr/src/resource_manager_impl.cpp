@@ -24,6 +24,9 @@
 #include <sstream>
 #include <sys/types.h>
 #include <unistd.h>
+#if defined(__linux__)
+#include <malloc.h>
+#endif
 
 #if !defined(__WINNT__) && !defined(__IDE_PREVIEW__)
 #include "hitrace_meter.h"
@@ -31,8 +34,12 @@
 #include "hilog_wrapper.h"
 #include "res_config.h"
 #include "utils/common.h"
+#include "utils/errors.h"
+#include "utils/mapped_file.h"
 #include "utils/string_utils.h"
+#include "utils/thread_pool.h"
 #include "utils/utils.h"
+#include "utils/zip_archive.h"
 
 namespace OHOS {
 namespace Global {
@@ -60,6 +67,54 @@ ResourceManager *CreateResourceManager()
 ResourceManager::~ResourceManager()
 {}
 
+bool ResourceManager::AddResources(const std::vector<std::string> &paths)
+{
+    bool success = true;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        success = AddResource(paths[i].c_str()) && success;
+    }
+    return success;
+}
+
+std::future<bool> ResourceManager::AddResourceAsync(const std::string &path)
+{
+    std::promise<bool> promise;
+    promise.set_value(AddResource(path.c_str()));
+    return promise.get_future();
+}
+
+void ResourceManager::AddResourceAsync(const std::string &path, const std::function<void(bool)> &callback)
+{
+    bool ret = AddResource(path.c_str());
+    if (callback) {
+        callback(ret);
+    }
+}
+
+std::future<RState> ResourceManager::UpdateResConfigAsync(ResConfig &resConfig)
+{
+    std::promise<RState> promise;
+    promise.set_value(UpdateResConfig(resConfig));
+    return promise.get_future();
+}
+
+void ResourceManager::UpdateResConfigAsync(ResConfig &resConfig, const std::function<void(RState)> &callback)
+{
+    RState state = UpdateResConfig(resConfig);
+    if (callback) {
+        callback(state);
+    }
+}
+
+bool ResourceManager::GetGeneration(uint32_t &generation)
+{
+    return false;
+}
+
+void ResourceManager::Trim(TrimLevel level)
+{
+}
+
 ResourceManagerImpl::ResourceManagerImpl() : hapManager_(nullptr)
 {}
 
@@ -83,21 +138,25 @@ bool ResourceManagerImpl::Init()
 
 RState ResourceManagerImpl::GetStringById(uint32_t id, std::string &outValue)
 {
-    const IdItem *idItem = hapManager_->FindResourceById(id);
-    return GetString(idItem, outValue);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const HapResource::ValueUnderQualifierDir *vuqd = hapManager_->FindQualifierValueById(id, resources);
+    return GetString(vuqd, outValue);
 }
 
 RState ResourceManagerImpl::GetStringByName(const char *name, std::string &outValue)
 {
-    const IdItem *idItem = hapManager_->FindResourceByName(name, ResType::STRING);
-    return GetString(idItem, outValue);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const HapResource::ValueUnderQualifierDir *vuqd =
+        hapManager_->FindQualifierValueByName(name, ResType::STRING, resources);
+    return GetString(vuqd, outValue);
 }
 
 RState ResourceManagerImpl::GetStringFormatById(std::string &outValue, uint32_t id, ...)
 {
-    const IdItem *idItem = hapManager_->FindResourceById(id);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const HapResource::ValueUnderQualifierDir *vuqd = hapManager_->FindQualifierValueById(id, resources);
     std::string temp;
-    RState rState = GetString(idItem, temp);
+    RState rState = GetString(vuqd, temp);
     if (rState != SUCCESS) {
         return rState;
     }
@@ -110,9 +169,11 @@ RState ResourceManagerImpl::GetStringFormatById(std::string &outValue, uint32_t
 
 RState ResourceManagerImpl::GetStringFormatByName(std::string &outValue, const char *name, ...)
 {
-    const IdItem *idItem = hapManager_->FindResourceByName(name, ResType::STRING);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const HapResource::ValueUnderQualifierDir *vuqd =
+        hapManager_->FindQualifierValueByName(name, ResType::STRING, resources);
     std::string temp;
-    RState rState = GetString(idItem, temp);
+    RState rState = GetString(vuqd, temp);
     if (rState != SUCCESS) {
         return rState;
     }
@@ -123,13 +184,14 @@ RState ResourceManagerImpl::GetStringFormatByName(std::string &outValue, const c
     return SUCCESS;
 }
 
-RState ResourceManagerImpl::GetString(const IdItem *idItem, std::string &outValue)
+RState ResourceManagerImpl::GetString(const HapResource::ValueUnderQualifierDir *vuqd, std::string &outValue)
 {
     // not found or type invalid
-    if (idItem == nullptr || idItem->resType_ != ResType::STRING) {
+    if (vuqd == nullptr || vuqd->GetIdItem()->resType_ != ResType::STRING) {
         return NOT_FOUND;
     }
-    RState ret = ResolveReference(idItem->value_, outValue);
+    std::shared_ptr<const std::string> holder;
+    RState ret = ResolveReference(vuqd->GetValue(holder), outValue);
     if (ret != SUCCESS) {
         return ret;
     }
@@ -138,13 +200,15 @@ RState ResourceManagerImpl::GetString(const IdItem *idItem, std::string &outValu
 
 RState ResourceManagerImpl::GetStringArrayById(uint32_t id, std::vector<std::string> &outValue)
 {
-    const IdItem *idItem = hapManager_->FindResourceById(id);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const IdItem *idItem = hapManager_->FindResourceById(id, resources);
     return GetStringArray(idItem, outValue);
 }
 
 RState ResourceManagerImpl::GetStringArrayByName(const char *name, std::vector<std::string> &outValue)
 {
-    const IdItem *idItem = hapManager_->FindResourceByName(name, ResType::STRINGARRAY);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const IdItem *idItem = hapManager_->FindResourceByName(name, ResType::STRINGARRAY, resources);
     return GetStringArray(idItem, outValue);
 }
 
@@ -160,7 +224,7 @@ RState ResourceManagerImpl::GetStringArray(const IdItem *idItem, std::vector<std
         std::string resolvedValue;
         RState rrRet = ResolveReference(idItem->values_[i], resolvedValue);
         if (rrRet != SUCCESS) {
-            HILOG_ERROR("ResolveReference failed, value:%s", idItem->values_[i].c_str());
+            HILOG_ERROR("ResolveReference failed, value:%s", idItem->values_[i].data());
             return ERROR;
         }
         outValue.push_back(resolvedValue);
@@ -170,13 +234,15 @@ RState ResourceManagerImpl::GetStringArray(const IdItem *idItem, std::vector<std
 
 RState ResourceManagerImpl::GetPatternById(uint32_t id, std::map<std::string, std::string> &outValue)
 {
-    const IdItem *idItem = hapManager_->FindResourceById(id);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const IdItem *idItem = hapManager_->FindResourceById(id, resources);
     return GetPattern(idItem, outValue);
 }
 
 RState ResourceManagerImpl::GetPatternByName(const char *name, std::map<std::string, std::string> &outValue)
 {
-    const IdItem *idItem = hapManager_->FindResourceByName(name, ResType::PATTERN);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const IdItem *idItem = hapManager_->FindResourceByName(name, ResType::PATTERN, resources);
     return GetPattern(idItem, outValue);
 }
 
@@ -191,20 +257,23 @@ RState ResourceManagerImpl::GetPattern(const IdItem *idItem, std::map<std::strin
 
 RState ResourceManagerImpl::GetPluralStringById(uint32_t id, int quantity, std::string &outValue)
 {
-    const HapResource::ValueUnderQualifierDir *vuqd = hapManager_->FindQualifierValueById(id);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const HapResource::ValueUnderQualifierDir *vuqd = hapManager_->FindQualifierValueById(id, resources);
     return GetPluralString(vuqd, quantity, outValue);
 }
 
 RState ResourceManagerImpl::GetPluralStringByName(const char *name, int quantity, std::string &outValue)
 {
+    std::shared_ptr<const HapManager::Resources> resources;
     const HapResource::ValueUnderQualifierDir *vuqd =
-        hapManager_->FindQualifierValueByName(name, ResType::PLURALS);
+        hapManager_->FindQualifierValueByName(name, ResType::PLURALS, resources);
     return GetPluralString(vuqd, quantity, outValue);
 }
 
 RState ResourceManagerImpl::GetPluralStringByIdFormat(std::string &outValue, uint32_t id, int quantity, ...)
 {
-    const HapResource::ValueUnderQualifierDir *vuqd = hapManager_->FindQualifierValueById(id);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const HapResource::ValueUnderQualifierDir *vuqd = hapManager_->FindQualifierValueById(id, resources);
     std::string temp;
     RState rState = GetPluralString(vuqd, quantity, temp);
     if (rState != SUCCESS) {
@@ -221,8 +290,9 @@ RState ResourceManagerImpl::GetPluralStringByIdFormat(std::string &outValue, uin
 
 RState ResourceManagerImpl::GetPluralStringByNameFormat(std::string &outValue, const char *name, int quantity, ...)
 {
+    std::shared_ptr<const HapManager::Resources> resources;
     const HapResource::ValueUnderQualifierDir *vuqd =
-        hapManager_->FindQualifierValueByName(name, ResType::PLURALS);
+        hapManager_->FindQualifierValueByName(name, ResType::PLURALS, resources);
     std::string temp;
     RState rState = GetPluralString(vuqd, quantity, temp);
     if (rState != SUCCESS) {
@@ -281,13 +351,16 @@ RState ResourceManagerImpl::GetPluralString(const HapResource::ValueUnderQualifi
     return SUCCESS;
 }
 
-RState ResourceManagerImpl::ResolveReference(const std::string value, std::string &outValue)
+RState ResourceManagerImpl::ResolveReference(std::string_view value, std::string &outValue)
 {
     int id;
     ResType resType;
     bool isRef = true;
     int count = 0;
-    std::string refStr(value);
+    std::string_view refStr(value);
+    // hold the resources and the inflated value refStr may refer to, the lookups are done in the same resources
+    std::shared_ptr<const HapManager::Resources> resources;
+    std::shared_ptr<const std::string> holder;
     while (isRef) {
         isRef = IdItem::IsRef(refStr, resType, id);
         if (!isRef) {
@@ -297,24 +370,26 @@ RState ResourceManagerImpl::ResolveReference(const std::string value, std::strin
 
         if (IdItem::IsArrayOfType(resType)) {
             // can't be array
-            HILOG_ERROR("ref %s can't be array", refStr.c_str());
+            HILOG_ERROR("ref %s can't be array", std::string(refStr).c_str());
             return ERROR;
         }
-        const IdItem *idItem = hapManager_->FindResourceById(id);
-        if (idItem == nullptr) {
-            HILOG_ERROR("ref %s id not found", refStr.c_str());
+        const HapResource::ValueUnderQualifierDir *vuqd = hapManager_->FindQualifierValueById(id, resources);
+        if (vuqd == nullptr) {
+            HILOG_ERROR("ref %s id not found", std::string(refStr).c_str());
             return ERROR;
         }
+        const IdItem *idItem = vuqd->GetIdItem();
         // unless compile bug
         if (resType != idItem->resType_) {
-            HILOG_ERROR("impossible. ref %s type mismatch, found type: %d", refStr.c_str(), idItem->resType_);
+            HILOG_ERROR("impossible. ref %s type mismatch, found type: %d", std::string(refStr).c_str(),
+                idItem->resType_);
             return ERROR;
         }
 
-        refStr = idItem->value_;
+        refStr = vuqd->GetValue(holder);
 
         if (++count > MAX_DEPTH_REF_SEARCH) {
-            HILOG_ERROR("ref %s has re-ref too much", value.c_str());
+            HILOG_ERROR("ref %s has re-ref too much", std::string(value).c_str());
             return ERROR;
         }
     }
@@ -337,6 +412,8 @@ RState ResourceManagerImpl::ResolveParentReference(const IdItem *idItem, std::ma
 
     bool haveParent = false;
     int count = 0;
+    // holds the parents, idItem is held by the caller
+    std::shared_ptr<const HapManager::Resources> resources;
     const IdItem *currItem = idItem;
     do {
         haveParent = currItem->HaveParent();
@@ -368,9 +445,9 @@ RState ResourceManagerImpl::ResolveParentReference(const IdItem *idItem, std::ma
                 HILOG_ERROR("something wrong, pls check HaveParent(). idItem: %s", idItem->ToString().c_str());
                 return ERROR;
             }
-            currItem = hapManager_->FindResourceById(id);
+            currItem = hapManager_->FindResourceById(id, resources);
             if (currItem == nullptr) {
-                HILOG_ERROR("ref %s id not found", idItem->values_[0].c_str());
+                HILOG_ERROR("ref %s id not found", idItem->values_[0].data());
                 return ERROR;
             }
         }
@@ -386,13 +463,15 @@ RState ResourceManagerImpl::ResolveParentReference(const IdItem *idItem, std::ma
 
 RState ResourceManagerImpl::GetBooleanById(uint32_t id, bool &outValue)
 {
-    const IdItem *idItem = hapManager_->FindResourceById(id);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const IdItem *idItem = hapManager_->FindResourceById(id, resources);
     return GetBoolean(idItem, outValue);
 }
 
 RState ResourceManagerImpl::GetBooleanByName(const char *name, bool &outValue)
 {
-    const IdItem *idItem = hapManager_->FindResourceByName(name, ResType::BOOLEAN);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const IdItem *idItem = hapManager_->FindResourceByName(name, ResType::BOOLEAN, resources);
     return GetBoolean(idItem, outValue);
 }
 
@@ -419,7 +498,8 @@ RState ResourceManagerImpl::GetBoolean(const IdItem *idItem, bool &outValue)
 
 RState ResourceManagerImpl::GetFloatById(uint32_t id, float &outValue)
 {
-    const IdItem *idItem = hapManager_->FindResourceById(id);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const IdItem *idItem = hapManager_->FindResourceById(id, resources);
     std::string unit;
     RState state = GetFloat(idItem, outValue, unit);
     if (state == SUCCESS) {
@@ -430,13 +510,15 @@ RState ResourceManagerImpl::GetFloatById(uint32_t id, float &outValue)
 
 RState ResourceManagerImpl::GetFloatById(uint32_t id, float &outValue, std::string &unit)
 {
-    const IdItem *idItem = hapManager_->FindResourceById(id);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const IdItem *idItem = hapManager_->FindResourceById(id, resources);
     return GetFloat(idItem, outValue, unit);
 }
 
 RState ResourceManagerImpl::GetFloatByName(const char *name, float &outValue)
 {
-    const IdItem *idItem = hapManager_->FindResourceByName(name, ResType::FLOAT);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const IdItem *idItem = hapManager_->FindResourceByName(name, ResType::FLOAT, resources);
     std::string unit;
     RState state = GetFloat(idItem, outValue, unit);
     if (state == SUCCESS) {
@@ -447,7 +529,8 @@ RState ResourceManagerImpl::GetFloatByName(const char *name, float &outValue)
 
 RState ResourceManagerImpl::GetFloatByName(const char *name, float &outValue, std::string &unit)
 {
-    const IdItem *idItem = hapManager_->FindResourceByName(name, ResType::FLOAT);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const IdItem *idItem = hapManager_->FindResourceByName(name, ResType::FLOAT, resources);
     return GetFloat(idItem, outValue, unit);
 }
 
@@ -502,13 +585,15 @@ RState ResourceManagerImpl::GetFloat(const IdItem *idItem, float &outValue, std:
 
 RState ResourceManagerImpl::GetIntegerById(uint32_t id, int &outValue)
 {
-    const IdItem *idItem = hapManager_->FindResourceById(id);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const IdItem *idItem = hapManager_->FindResourceById(id, resources);
     return GetInteger(idItem, outValue);
 }
 
 RState ResourceManagerImpl::GetIntegerByName(const char *name, int &outValue)
 {
-    const IdItem *idItem = hapManager_->FindResourceByName(name, ResType::INTEGER);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const IdItem *idItem = hapManager_->FindResourceByName(name, ResType::INTEGER, resources);
     return GetInteger(idItem, outValue);
 }
 
@@ -528,13 +613,15 @@ RState ResourceManagerImpl::GetInteger(const IdItem *idItem, int &outValue)
 
 RState ResourceManagerImpl::GetColorById(uint32_t id, uint32_t &outValue)
 {
-    const IdItem *idItem = hapManager_->FindResourceById(id);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const IdItem *idItem = hapManager_->FindResourceById(id, resources);
     return GetColor(idItem, outValue);
 }
 
 RState ResourceManagerImpl::GetColorByName(const char *name, uint32_t &outValue)
 {
-    const IdItem *idItem = hapManager_->FindResourceByName(name, ResType::COLOR);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const IdItem *idItem = hapManager_->FindResourceByName(name, ResType::COLOR, resources);
     return GetColor(idItem, outValue);
 }
 
@@ -553,13 +640,15 @@ RState ResourceManagerImpl::GetColor(const IdItem *idItem, uint32_t &outValue)
 
 RState ResourceManagerImpl::GetIntArrayById(uint32_t id, std::vector<int> &outValue)
 {
-    const IdItem *idItem = hapManager_->FindResourceById(id);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const IdItem *idItem = hapManager_->FindResourceById(id, resources);
     return GetIntArray(idItem, outValue);
 }
 
 RState ResourceManagerImpl::GetIntArrayByName(const char *name, std::vector<int> &outValue)
 {
-    const IdItem *idItem = hapManager_->FindResourceByName(name, ResType::INTARRAY);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const IdItem *idItem = hapManager_->FindResourceByName(name, ResType::INTARRAY, resources);
     return GetIntArray(idItem, outValue);
 }
 
@@ -575,7 +664,7 @@ RState ResourceManagerImpl::GetIntArray(const IdItem *idItem, std::vector<int> &
         std::string resolvedValue;
         RState rrRet = ResolveReference(idItem->values_[i], resolvedValue);
         if (rrRet != SUCCESS) {
-            HILOG_ERROR("ResolveReference failed, value:%s", idItem->values_[i].c_str());
+            HILOG_ERROR("ResolveReference failed, value:%s", idItem->values_[i].data());
             return ERROR;
         }
         outValue.push_back(stoi(resolvedValue));
@@ -585,13 +674,15 @@ RState ResourceManagerImpl::GetIntArray(const IdItem *idItem, std::vector<int> &
 
 RState ResourceManagerImpl::GetThemeById(uint32_t id, std::map<std::string, std::string> &outValue)
 {
-    const IdItem *idItem = hapManager_->FindResourceById(id);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const IdItem *idItem = hapManager_->FindResourceById(id, resources);
     return GetTheme(idItem, outValue);
 }
 
 RState ResourceManagerImpl::GetThemeByName(const char *name, std::map<std::string, std::string> &outValue)
 {
-    const IdItem *idItem = hapManager_->FindResourceByName(name, ResType::THEME);
+    std::shared_ptr<const HapManager::Resources> resources;
+    const IdItem *idItem = hapManager_->FindResourceByName(name, ResType::THEME, resources);
     return GetTheme(idItem, outValue);
 }
 
@@ -606,7 +697,8 @@ RState ResourceManagerImpl::GetTheme(const IdItem *idItem, std::map<std::string,
 
 RState ResourceManagerImpl::GetProfileById(uint32_t id, std::string &outValue)
 {
-    auto qd = hapManager_->FindQualifierValueById(id);
+    std::shared_ptr<const HapManager::Resources> resources;
+    auto qd = hapManager_->FindQualifierValueById(id, resources);
     if (qd == nullptr) {
         return NOT_FOUND;
     }
@@ -615,7 +707,8 @@ RState ResourceManagerImpl::GetProfileById(uint32_t id, std::string &outValue)
 
 RState ResourceManagerImpl::GetProfileByName(const char *name, std::string &outValue)
 {
-    auto qd = hapManager_->FindQualifierValueByName(name, ResType::PROF);
+    std::shared_ptr<const HapManager::Resources> resources;
+    auto qd = hapManager_->FindQualifierValueByName(name, ResType::PROF, resources);
     if (qd == nullptr) {
         return NOT_FOUND;
     }
@@ -624,7 +717,8 @@ RState ResourceManagerImpl::GetProfileByName(const char *name, std::string &outV
 
 RState ResourceManagerImpl::GetMediaById(uint32_t id, std::string &outValue)
 {
-    auto qd = hapManager_->FindQualifierValueById(id);
+    std::shared_ptr<const HapManager::Resources> resources;
+    auto qd = hapManager_->FindQualifierValueById(id, resources);
     if (qd == nullptr) {
         return NOT_FOUND;
     }
@@ -633,7 +727,8 @@ RState ResourceManagerImpl::GetMediaById(uint32_t id, std::string &outValue)
 
 RState ResourceManagerImpl::GetMediaByName(const char *name, std::string &outValue)
 {
-    auto qd = hapManager_->FindQualifierValueByName(name, ResType::MEDIA);
+    std::shared_ptr<const HapManager::Resources> resources;
+    auto qd = hapManager_->FindQualifierValueByName(name, ResType::MEDIA, resources);
     if (qd == nullptr) {
         return NOT_FOUND;
     }
@@ -651,11 +746,17 @@ RState ResourceManagerImpl::GetRawFile(const HapResource::ValueUnderQualifierDir
     if (idItem == nullptr || idItem->resType_ != resType) {
         return NOT_FOUND;
     }
+    // the entries of a hap have no path, the one derived from the hap location does not exist
+    if (vuqd->GetHapResource()->IsHap()) {
+        HILOG_ERROR("%s is in the hap %s, it has no file path", idItem->name_.data(),
+            vuqd->GetHapResource()->GetIndexPath().c_str());
+        return ERROR;
+    }
     outValue = vuqd->GetHapResource()->GetResourcePath();
 #ifdef __IDE_PREVIEW__
     auto index = idItem->value_.find('/');
     if (index == std::string::npos) {
-        HILOG_ERROR("resource path format error, %s", idItem->value_.c_str());
+        HILOG_ERROR("resource path format error, %s", idItem->value_.data());
         return NOT_FOUND;
     }
     auto nameWithoutModule = idItem->value_.substr(index + 1);
@@ -671,61 +772,136 @@ RState ResourceManagerImpl::GetRawFilePathByName(const std::string &name, std::s
     return hapManager_->FindRawFile(name, outValue);
 }
 
+RState ResourceManagerImpl::GetRawFileLocation(const std::string &name, HapManager::RawFileLocation &location)
+{
+    return hapManager_->FindRawFile(name, location);
+}
+
+RState ResourceManagerImpl::GetRawFileLocations(const std::vector<std::string> &names,
+    std::vector<HapManager::RawFileLocation> &locations)
+{
+    return hapManager_->FindRawFiles(names, locations);
+}
+
+RState ResourceManagerImpl::GetRawFileList(const std::string &dirName, bool recursive,
+    std::vector<std::string> &names)
+{
+    return hapManager_->ListRawFiles(dirName, recursive, names);
+}
+
+void ResourceManagerImpl::RescanRawFiles()
+{
+    hapManager_->RescanRawFiles();
+}
+
 RState ResourceManagerImpl::GetRawFileDescriptor(const std::string &name, RawFileDescriptor &descriptor)
 {
-    auto it = rawFileDescriptor_.find(name);
-    if (it != rawFileDescriptor_.end()) {
-        descriptor.fd = rawFileDescriptor_[name].fd;
-        descriptor.length = rawFileDescriptor_[name].length;
-        descriptor.offset = rawFileDescriptor_[name].offset;
-        return SUCCESS;
-    }
-    std::string paths = "";
-    RState rState = GetRawFilePathByName(name, paths);
-    if (rState != SUCCESS) {
-        return rState;
-    }
-    int fd = open(paths.c_str(), O_RDONLY);
-    if (fd > 0) {
-        long length = lseek(fd, 0, SEEK_END);
-        if (length == -1) {
-            close(fd);
+    hapManager_->GetStartupProfile().RecordRawFile(name);
+    RawFileDescriptorCache::Descriptor cached;
+    if (!rawFileDescriptors_.Acquire(name, cached)) {
+        HapManager::RawFileLocation location;
+        RState rState = GetRawFileLocation(name, location);
+        if (rState != SUCCESS) {
+            return rState;
+        }
+        if (location.entry != nullptr && location.entry->method != ZipArchive::METHOD_STORED) {
+            // only the uncompressed entries can be read in place from the hap
+            HILOG_ERROR("%s is compressed in %s", name.c_str(), location.path.c_str());
             return ERROR;
         }
-        long begin = lseek(fd, 0, SEEK_SET);
-        if (begin == -1) {
-            close(fd);
+        if (!rawFileDescriptors_.Open(name, location.path, static_cast<long>(location.offset),
+            static_cast<long>(location.length), cached)) {
             return ERROR;
         }
-        descriptor.fd = fd;
-        descriptor.length = length;
-        descriptor.offset = 0;
-        rawFileDescriptor_[name] = descriptor;
-        return SUCCESS;
     }
-    return ERROR;
+    descriptor.fd = cached.fd;
+    descriptor.offset = cached.offset;
+    descriptor.length = cached.length;
+    return SUCCESS;
 }
 
 RState ResourceManagerImpl::CloseRawFileDescriptor(const std::string &name)
 {
-    auto it = rawFileDescriptor_.find(name);
-    if (it == rawFileDescriptor_.end()) {
-        return SUCCESS;
+    // the fd is closed when no one holds it and the cache is full
+    if (!rawFileDescriptors_.Release(name)) {
+        HILOG_DEBUG("the raw file descriptor of %s is not held", name.c_str());
     }
-    int fd = rawFileDescriptor_[name].fd;
-    if (fd > 0) {
-        int result = close(fd);
-        if (result == -1) {
-            return ERROR;
+    return SUCCESS;
+}
+
+void ResourceManagerImpl::SetRawFileDescriptorLimits(size_t maxOpenFiles, size_t maxEntries)
+{
+    rawFileDescriptors_.SetLimits(maxOpenFiles, maxEntries);
+}
+
+bool ResourceManagerImpl::StartStartupProfile(const std::string &profilePath, uint32_t durationMs)
+{
+    // the file is written on a worker thread, not on the thread of the lookup which ends the recording
+    auto onEnd = [this, profilePath](const std::vector<StartupProfile::Entry> &entries) {
+        PostTask([profilePath, entries] { StartupProfile::Save(profilePath, entries); });
+    };
+    if (!hapManager_->GetStartupProfile().Start(durationMs, onEnd)) {
+        return false;
+    }
+    PostTask([this, profilePath] {
+        std::vector<StartupProfile::Entry> entries;
+        // there is no profile at the first start
+        if (StartupProfile::Load(profilePath, entries) == OK) {
+            ReplayStartupProfile(entries);
+        }
+    });
+    return true;
+}
+
+void ResourceManagerImpl::ReplayStartupProfile(const std::vector<StartupProfile::Entry> &entries)
+{
+#if !defined(__WINNT__) && !defined(__IDE_PREVIEW__)
+    HITRACE_METER_NAME(HITRACE_TAG_APP, __PRETTY_FUNCTION__);
+#endif
+    StartupProfile::ReplayScope scope;
+    for (const StartupProfile::Entry &entry : entries) {
+        std::shared_ptr<const HapManager::Resources> resources;
+        if (entry.type == StartupProfile::ID) {
+            PrewarmValue(hapManager_->FindQualifierValueById(entry.id, resources));
+        } else if (entry.type == StartupProfile::NAME) {
+            PrewarmValue(hapManager_->FindQualifierValueByName(entry.name.c_str(), entry.resType, resources));
+        } else if (entry.type == StartupProfile::RAW_FILE) {
+            // the descriptor is kept in the cache after it is closed
+            RawFileDescriptor descriptor;
+            if (GetRawFileDescriptor(entry.name, descriptor) == SUCCESS) {
+                CloseRawFileDescriptor(entry.name);
+            }
         }
-        rawFileDescriptor_.erase(name);
-        return SUCCESS;
     }
-    return ERROR;
+}
+
+void ResourceManagerImpl::PrewarmValue(const HapResource::ValueUnderQualifierDir *vuqd)
+{
+    if (vuqd == nullptr) {
+        return;
+    }
+    const IdItem *idItem = vuqd->GetIdItem();
+    std::string resolvedValue;
+    if (!idItem->isArray_) {
+        std::shared_ptr<const std::string> holder;
+        ResolveReference(vuqd->GetValue(holder), resolvedValue);
+        return;
+    }
+    for (std::string_view value : idItem->values_) {
+        ResolveReference(value, resolvedValue);
+    }
 }
 
 ResourceManagerImpl::~ResourceManagerImpl()
 {
+    // the recording is saved with the lookups so far
+    if (hapManager_ != nullptr) {
+        hapManager_->GetStartupProfile().Stop();
+    }
+    {
+        std::unique_lock<std::mutex> lock(pendingMutex_);
+        pendingCond_.wait(lock, [this] { return pendingTasks_ == 0; });
+    }
     if (hapManager_ != nullptr) {
         delete hapManager_;
     }
@@ -744,6 +920,107 @@ bool ResourceManagerImpl::AddResource(const std::string &path, const std::vector
     return this->hapManager_->AddResource(path, overlayPaths);
 }
 
+bool ResourceManagerImpl::AddOverlay(const std::string &path, const std::string &overlayPath)
+{
+    return this->hapManager_->AddOverlay(path, overlayPath);
+}
+
+bool ResourceManagerImpl::RemoveOverlay(const std::string &path, const std::string &overlayPath)
+{
+    return this->hapManager_->RemoveOverlay(path, overlayPath);
+}
+
+void ResourceManagerImpl::GetMemoryUsage(MemoryReport &report)
+{
+    this->hapManager_->GetMemoryUsage(report);
+    report.total.rawFileDescriptors += rawFileDescriptors_.GetMemoryUsage();
+}
+
+void ResourceManagerImpl::Trim(TrimLevel level)
+{
+    this->hapManager_->Trim(level);
+    rawFileDescriptors_.ReleaseIdle();
+    // the archives and the mappings in use are kept by their users
+    ZipArchive::ReleaseCache();
+    MappedFile::ReleaseCache();
+    if (level >= TRIM_ALL) {
+#if defined(__linux__)
+        malloc_trim(0);
+#endif
+    }
+}
+
+void ResourceManagerImpl::SetAutoReload(bool enabled)
+{
+    this->hapManager_->SetAutoReload(enabled);
+}
+
+bool ResourceManagerImpl::ReloadChanged()
+{
+    return this->hapManager_->ReloadChanged();
+}
+
+bool ResourceManagerImpl::AddResources(const std::vector<std::string> &paths)
+{
+#if !defined(__WINNT__) && !defined(__IDE_PREVIEW__)
+    HITRACE_METER_NAME(HITRACE_TAG_APP, __PRETTY_FUNCTION__);
+#endif
+    return this->hapManager_->AddResources(paths);
+}
+
+std::future<bool> ResourceManagerImpl::AddResourceAsync(const std::string &path)
+{
+    auto promise = std::make_shared<std::promise<bool>>();
+    std::future<bool> result = promise->get_future();
+    AddResourceAsync(path, [promise](bool ret) { promise->set_value(ret); });
+    return result;
+}
+
+void ResourceManagerImpl::AddResourceAsync(const std::string &path, const std::function<void(bool)> &callback)
+{
+    PostTask([this, path, callback] {
+        bool ret = this->AddResource(path.c_str());
+        if (callback) {
+            callback(ret);
+        }
+    });
+}
+
+std::future<RState> ResourceManagerImpl::UpdateResConfigAsync(ResConfig &resConfig)
+{
+    auto promise = std::make_shared<std::promise<RState>>();
+    std::future<RState> result = promise->get_future();
+    UpdateResConfigAsync(resConfig, [promise](RState state) { promise->set_value(state); });
+    return result;
+}
+
+void ResourceManagerImpl::UpdateResConfigAsync(ResConfig &resConfig, const std::function<void(RState)> &callback)
+{
+    auto config = std::make_shared<ResConfigImpl>();
+    config->Copy(resConfig);
+    PostTask([this, config, callback] {
+        RState state = this->UpdateResConfig(*config);
+        if (callback) {
+            callback(state);
+        }
+    });
+}
+
+void ResourceManagerImpl::PostTask(const std::function<void()> &task)
+{
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        pendingTasks_++;
+    }
+    ThreadPool::GetInstance().Post([this, task] {
+        task();
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        if (--pendingTasks_ == 0) {
+            pendingCond_.notify_all();
+        }
+    });
+}
+
 RState ResourceManagerImpl::UpdateResConfig(ResConfig &resConfig)
 {
 #if !defined(__WINNT__) && !defined(__IDE_PREVIEW__)
@@ -765,6 +1042,12 @@ void ResourceManagerImpl::GetResConfig(ResConfig &resConfig)
     this->hapManager_->GetResConfig(resConfig);
 }
 
+bool ResourceManagerImpl::GetGeneration(uint32_t &generation)
+{
+    generation = this->hapManager_->GetGeneration();
+    return true;
+}
+
 std::vector<std::string> ResourceManagerImpl::GetResourcePaths()
 {
     return this->hapManager_->GetResourcePaths();
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/base64.h"
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BASE64_X86
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define BASE64_NEON
+#endif
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+namespace {
+const char CODES[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// the bytes of the input encoded by one step, and the chars written
+constexpr size_t BLOCK_IN = 3;
+constexpr size_t BLOCK_OUT = 4;
+
+// the number of the input bytes the SIMD code has encoded, the rest is left to the scalar code
+using EncodeBlocksFunc = size_t (*)(const uint8_t *src, size_t len, char *dst);
+
+size_t EncodeTail(const uint8_t *src, size_t len, char *dst)
+{
+    size_t i = 0;
+    size_t j = 0;
+    for (; i + BLOCK_IN <= len; i += BLOCK_IN) {
+        uint32_t triple = (static_cast<uint32_t>(src[i]) << 16) | (static_cast<uint32_t>(src[i + 1]) << 8) |
+            src[i + 2];
+        dst[j++] = CODES[(triple >> 18) & 0x3F];
+        dst[j++] = CODES[(triple >> 12) & 0x3F];
+        dst[j++] = CODES[(triple >> 6) & 0x3F];
+        dst[j++] = CODES[triple & 0x3F];
+    }
+    if (i + 1 == len) {
+        dst[j++] = CODES[src[i] >> 2];
+        dst[j++] = CODES[(src[i] & 0x3) << 4];
+        dst[j++] = '=';
+        dst[j++] = '=';
+    } else if (i + 2 == len) {
+        dst[j++] = CODES[src[i] >> 2];
+        dst[j++] = CODES[((src[i] & 0x3) << 4) | (src[i + 1] >> 4)];
+        dst[j++] = CODES[(src[i + 1] & 0xF) << 2];
+        dst[j++] = '=';
+    }
+    return j;
+}
+
+#ifdef BASE64_X86
+__attribute__((target("ssse3"))) __m128i LookupSse(__m128i indexes)
+{
+    // 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12, the offset to the char in the table
+    __m128i result = _mm_subs_epu8(indexes, _mm_set1_epi8(51));
+    __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indexes);
+    result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+    const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    return _mm_add_epi8(_mm_shuffle_epi8(offsets, result), indexes);
+}
+
+__attribute__((target("ssse3"))) size_t EncodeBlocksSse(const uint8_t *src, size_t len, char *dst)
+{
+    // 12 bytes are encoded and 16 read each step
+    size_t i = 0;
+    for (; i + 16 <= len; i += 12) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        // split the 12 bytes into 16 indexes of 6 bits, one in each byte
+        in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+        __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+        __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+        __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+        __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+        __m128i out = LookupSse(_mm_or_si128(t1, t3));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i / BLOCK_IN * BLOCK_OUT), out);
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) __m256i LookupAvx2(__m256i indexes)
+{
+    __m256i result = _mm256_subs_epu8(indexes, _mm256_set1_epi8(51));
+    __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indexes);
+    result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+    const __m256i offsets = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    return _mm256_add_epi8(_mm256_shuffle_epi8(offsets, result), indexes);
+}
+
+__attribute__((target("avx2"))) size_t EncodeBlocksAvx2(const uint8_t *src, size_t len, char *dst)
+{
+    // 24 bytes are encoded each step, 12 in each lane, and 28 read
+    size_t i = 0;
+    for (; i + 28 <= len; i += 24) {
+        __m256i in = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i))),
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 12)), 1);
+        in = _mm256_shuffle_epi8(in, _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+            10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+        __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+        __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+        __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        __m256i out = LookupAvx2(_mm256_or_si256(t1, t3));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i / BLOCK_IN * BLOCK_OUT), out);
+    }
+    // the rest blocks of 12 bytes
+    return i + EncodeBlocksSse(src + i, len - i, dst + i / BLOCK_IN * BLOCK_OUT);
+}
+
+EncodeBlocksFunc SelectEncodeBlocks()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return EncodeBlocksAvx2;
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+        return EncodeBlocksSse;
+    }
+    return nullptr;
+}
+#endif
+
+#ifdef BASE64_NEON
+size_t EncodeBlocksNeon(const uint8_t *src, size_t len, char *dst)
+{
+    uint8x16x4_t table;
+    table.val[0] = vld1q_u8(reinterpret_cast<const uint8_t *>(CODES));
+    table.val[1] = vld1q_u8(reinterpret_cast<const uint8_t *>(CODES) + 16);
+    table.val[2] = vld1q_u8(reinterpret_cast<const uint8_t *>(CODES) + 32);
+    table.val[3] = vld1q_u8(reinterpret_cast<const uint8_t *>(CODES) + 48);
+    const uint8x16_t mask = vdupq_n_u8(0x3F);
+    // 48 bytes are deinterleaved to the 1st, 2nd and 3rd bytes of 16 blocks each step
+    size_t i = 0;
+    for (; i + 48 <= len; i += 48) {
+        uint8x16x3_t in = vld3q_u8(src + i);
+        uint8x16x4_t out;
+        out.val[0] = vshrq_n_u8(in.val[0], 2);
+        out.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), mask);
+        out.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), mask);
+        out.val[3] = vandq_u8(in.val[2], mask);
+        out.val[0] = vqtbl4q_u8(table, out.val[0]);
+        out.val[1] = vqtbl4q_u8(table, out.val[1]);
+        out.val[2] = vqtbl4q_u8(table, out.val[2]);
+        out.val[3] = vqtbl4q_u8(table, out.val[3]);
+        vst4q_u8(reinterpret_cast<uint8_t *>(dst + i / BLOCK_IN * BLOCK_OUT), out);
+    }
+    return i;
+}
+
+EncodeBlocksFunc SelectEncodeBlocks()
+{
+    // neon is always there on aarch64
+    return EncodeBlocksNeon;
+}
+#endif
+
+#if !defined(BASE64_X86) && !defined(BASE64_NEON)
+EncodeBlocksFunc SelectEncodeBlocks()
+{
+    return nullptr;
+}
+#endif
+} // namespace
+
+size_t Base64::EncodedLength(size_t len)
+{
+    return (len + BLOCK_IN - 1) / BLOCK_IN * BLOCK_OUT;
+}
+
+size_t Base64::Encode(const char *data, size_t len, char *dst)
+{
+    static const EncodeBlocksFunc encodeBlocks = SelectEncodeBlocks();
+    const uint8_t *src = reinterpret_cast<const uint8_t *>(data);
+    size_t done = 0;
+    if (encodeBlocks != nullptr) {
+        done = encodeBlocks(src, len, dst);
+    }
+    return done / BLOCK_IN * BLOCK_OUT + EncodeTail(src + done, len - done, dst + done / BLOCK_IN * BLOCK_OUT);
+}
+
+void Base64::Encode(const char *data, size_t len, std::string &out)
+{
+    size_t start = out.size();
+    out.resize(start + EncodedLength(len));
+    Encode(data, len, &out[start]);
+}
+
+size_t Base64::EncodeScalar(const char *data, size_t len, char *dst)
+{
+    return EncodeTail(reinterpret_cast<const uint8_t *>(data), len, dst);
+}
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
@@ -18,10 +18,9 @@
 #include <algorithm>
 #include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <string>
-#include <unzip.h>
-#include <zip.h>
-#include <zlib.h>
+#include <string_view>
 
 #include "hilog_wrapper.h"
 #include "locale_matcher.h"
@@ -32,80 +31,44 @@
 #endif
 #include "utils/common.h"
 #include "utils/errors.h"
+#include "utils/index_v2.h"
+#include "utils/long_string_store.h"
 #include "utils/string_utils.h"
+#include "utils/thread_pool.h"
 
 namespace OHOS {
 namespace Global {
 namespace Resource {
 const char *HapParser::RES_FILE_NAME = "/resources.index";
 
-void UnzCloseFileAndLog(unzFile uf, const char *zipFile)
-{
-    int err = unzCloseCurrentFile(uf); // close the zipfile
-    if (err != UNZ_OK) {
-        HILOG_ERROR("Error %d with zipfile %s in unzCloseCurrentFile", err, zipFile);
-    }
-}
-
 int32_t HapParser::ReadFileFromZip(const char *zipFile, const char *fileName, void **buffer, size_t &bufLen,
                                    std::string &errInfo)
 {
-    int err = UNZ_OK;                // error status
-    char filenameInzip[256];         // for unzGetCurrentFileInfo
-    unz_file_info fileInfo;          // for unzGetCurrentFileInfo
-
-    unzFile uf = unzOpen64(zipFile); // open zipfile stream
-    if (uf == nullptr) {
-        errInfo = FormatString("Cannot open %s", zipFile);
-        return UNKNOWN_ERROR;
-    } // file is open
-
-    if (unzLocateFile(uf, fileName, 1)) { // try to locate file inside zip
-        // second argument of unzLocateFile: 1 = case sensitive, 0 = case-insensitive
-        unzClose(uf);
-        errInfo = FormatString("File %s not found in %s", fileName, zipFile);
+    std::shared_ptr<ZipArchive> archive = ZipArchive::Open(zipFile, errInfo);
+    if (archive == nullptr) {
         return UNKNOWN_ERROR;
-    } // file inside zip found
-
-    if (unzGetCurrentFileInfo(uf, &fileInfo, filenameInzip, sizeof(filenameInzip), nullptr, 0, nullptr, 0)) {
-        unzClose(uf);
-        errInfo = FormatString("Error %d with zipfile %s in unzGetCurrentFileInfo.", err, zipFile);
+    }
+    std::unique_ptr<ZipArchive::View> view(archive->ReadEntry(fileName, errInfo));
+    if (view == nullptr) {
         return UNKNOWN_ERROR;
-    } // obtained the necessary details about file inside zip
+    }
+    return CopyView(*view, buffer, bufLen, errInfo);
+}
 
-    *buffer = static_cast<void *>(malloc(fileInfo.uncompressed_size)); // setup buffer
-    bufLen = fileInfo.uncompressed_size;
+int32_t HapParser::CopyView(const ZipArchive::View &view, void **buffer, size_t &bufLen, std::string &errInfo)
+{
+    *buffer = malloc(view.Size() == 0 ? 1 : view.Size());
     if ((*buffer) == nullptr) {
-        unzClose(uf);
         errInfo = FormatString("Error allocating memory for read buffer");
         return UNKNOWN_ERROR;
-    } // buffer ready
-
-    err = unzOpenCurrentFilePassword(uf, nullptr); // Open the file inside the zip (password = NULL)
-    if (err != UNZ_OK) {
-        errInfo = FormatString("Error %d with zipfile %s in unzOpenCurrentFilePassword.", err, zipFile);
-        free(*buffer);
-        *buffer = nullptr;
-        unzClose(uf);
-        return UNKNOWN_ERROR;
-    } // file inside the zip is open
-    // Copy contents of the file inside the zip to the buffer
-    HILOG_DEBUG("Extracting: %s from %s, file size: %lu", filenameInzip, zipFile, fileInfo.uncompressed_size);
-    err = unzReadCurrentFile(uf, *buffer, bufLen);
-    if (err < 0) {
-        errInfo = FormatString("Error %d with zipfile %s in unzReadCurrentFile", err, zipFile);
-        free(*buffer);
-        *buffer = nullptr;
-        UnzCloseFileAndLog(uf, zipFile); // close the zipfile
-        unzClose(uf);
-        return UNKNOWN_ERROR;
     }
-    if ((*buffer) == nullptr) {
+    bufLen = view.Size();
+    if (bufLen > 0 && memcpy_s(*buffer, bufLen, view.Data(), bufLen) != OK) {
         free(*buffer);
         *buffer = nullptr;
+        errInfo = FormatString("Error copying the read buffer");
+        return UNKNOWN_ERROR;
     }
-    UnzCloseFileAndLog(uf, zipFile); // close the zipfile
-    unzClose(uf);
     return OK;
 }
 
@@ -130,43 +93,67 @@ std::string GetModuleName(const char *configStr)
     return retStr;
 }
 
+std::string GetModuleNameFromView(const ZipArchive::View &view)
+{
+    // config.json is not terminated by '\0'
+    std::string config(view.Data(), view.Size());
+    return GetModuleName(config.c_str());
+}
+
 int32_t HapParser::ReadIndexFromFile(const char *zipFile, void **buffer,
                                      size_t &bufLen, std::string &errInfo)
 {
-    void *tmpBuf = nullptr;
-    size_t tmpLen;
+    std::unique_ptr<ZipArchive::View> view(ReadIndexFromFile(zipFile, errInfo));
+    if (view == nullptr) {
+        return UNKNOWN_ERROR;
+    }
+    return CopyView(*view, buffer, bufLen, errInfo);
+}
+
+ZipArchive::View *HapParser::ReadIndexFromFile(const char *zipFile, std::string &errInfo)
+{
+    std::shared_ptr<ZipArchive> archive = ZipArchive::Open(zipFile, errInfo);
+    if (archive == nullptr) {
+        return nullptr;
+    }
+    std::string indexFilePath;
+    if (GetIndexEntryName(*archive, indexFilePath, errInfo) != OK) {
+        return nullptr;
+    }
+    return archive->ReadEntry(indexFilePath, errInfo);
+}
+
+int32_t HapParser::GetIndexEntryName(const ZipArchive &archive, std::string &name, std::string &errInfo)
+{
     std::string tmp;
-    int32_t ret = ReadFileFromZip(zipFile, "config.json", &tmpBuf, tmpLen, tmp);
-    if (ret != OK) {
+    std::unique_ptr<ZipArchive::View> config(archive.ReadEntry("config.json", tmp));
+    if (config == nullptr) {
         errInfo = "read config.json error";
-        HILOG_ERROR("read config.json error");
-        return ret;
+        HILOG_ERROR("read config.json error, %s", tmp.c_str());
+        return UNKNOWN_ERROR;
     }
 
     // parse config.json
-    std::string mName = GetModuleName(static_cast<char *>(tmpBuf));
+    std::string mName = GetModuleNameFromView(*config);
     if (mName.size() == 0) {
         errInfo = "parse moduleName from config.json error";
-        free(tmpBuf);
         return UNKNOWN_ERROR;
     }
-    free(tmpBuf);
-    std::string indexFilePath = std::string("assets/");
-    indexFilePath.append(mName);
-    indexFilePath.append(RES_FILE_NAME);
-
-    return ReadFileFromZip(zipFile, indexFilePath.c_str(), buffer, bufLen, errInfo);
+    name = std::string("assets/");
+    name.append(mName);
+    name.append(RES_FILE_NAME);
+    return OK;
 }
 
 /**
  *
  * @param buffer
  * @param offset
- * @param id
+ * @param id the string in the buffer
  * @param includeTemi dose length include '\0'
  * @return OK or ERROR
  */
-int32_t ParseString(const char *buffer, uint32_t &offset, std::string &id, bool includeTemi = true)
+int32_t ParseString(const char *buffer, uint32_t &offset, std::string_view &id, bool includeTemi = true)
 {
     uint16_t strLen;
     errno_t eret = memcpy_s(&strLen, sizeof(strLen), buffer + offset, 2);
@@ -174,9 +161,8 @@ int32_t ParseString(const char *buffer, uint32_t &offset, std::string &id, bool
         return SYS_ERROR;
     }
     offset += 2;
-    std::string tmp = std::string(const_cast<char *>(buffer) + offset, includeTemi ? (strLen - 1) : strLen);
+    id = std::string_view(buffer + offset, includeTemi ? (strLen - 1) : strLen);
     offset += includeTemi ? strLen : (strLen + 1);
-    id = tmp;
     return OK;
 }
 
@@ -185,9 +171,11 @@ int32_t ParseString(const char *buffer, uint32_t &offset, std::string &id, bool
  * @param buffer
  * @param offset
  * @param values
+ * @param pool the strings are interned in it
  * @return
  */
-int32_t ParseStringArray(const char *buffer, uint32_t &offset, std::vector<std::string> &values)
+int32_t ParseStringArray(const char *buffer, uint32_t &offset, std::vector<std::string_view> &values,
+                         StringPool &pool)
 {
     uint16_t arrLen;
     errno_t eret = memcpy_s(&arrLen, sizeof(arrLen), buffer + offset, 2);
@@ -198,12 +186,12 @@ int32_t ParseStringArray(const char *buffer, uint32_t &offset, std::vector<std::
     // next arrLen bytes are several strings. then after, is one '\0'
     uint32_t startOffset = offset;
     while (true) {
-        std::string value;
+        std::string_view value;
         int32_t ret = ParseString(buffer, offset, value, false);
         if (ret != OK) {
             return ret;
         }
-        values.push_back(value);
+        values.push_back(pool.Intern(value));
 
         uint32_t readSize = offset - startOffset;
         if (readSize + 1 == arrLen) {
@@ -219,7 +207,7 @@ int32_t ParseStringArray(const char *buffer, uint32_t &offset, std::vector<std::
     return OK;
 }
 
-int32_t ParseIdItem(const char *buffer, uint32_t &offset, IdItem *idItem)
+int32_t ParseIdItem(const char *buffer, uint32_t &offset, IdItem *idItem, ResDesc &resDesc)
 {
     errno_t eret = memcpy_s(idItem, sizeof(IdItem), buffer + offset, IdItem::HEADER_LEN);
     if (eret != OK) {
@@ -229,29 +217,35 @@ int32_t ParseIdItem(const char *buffer, uint32_t &offset, IdItem *idItem)
 
     idItem->JudgeArray();
     if (idItem->isArray_) {
-        int32_t ret = ParseStringArray(buffer, offset, idItem->values_);
+        int32_t ret = ParseStringArray(buffer, offset, idItem->values_, resDesc.stringPool_);
         if (ret != OK) {
             return ret;
         }
     } else {
-        std::string value;
+        std::string_view value;
         int32_t ret = ParseString(buffer, offset, value);
         if (ret != OK) {
             return ret;
         }
-        idItem->value_ = std::string(value);
+        // a long string stays in the buffer until CompressLongStrings
+        if (resDesc.longStrings_ != nullptr && idItem->resType_ == ResType::STRING &&
+            value.size() >= resDesc.longStrings_->GetThreshold()) {
+            idItem->value_ = value;
+        } else {
+            idItem->value_ = resDesc.stringPool_.Intern(value);
+        }
         idItem->valueLen_ = value.size();
     }
-    std::string name;
+    std::string_view name;
     int32_t ret = ParseString(buffer, offset, name);
     if (ret != OK) {
         return ret;
     }
-    idItem->name_ = std::string(name);
+    idItem->name_ = resDesc.stringPool_.Intern(name);
     return OK;
 }
 
-int32_t ParseId(const char *buffer, uint32_t &offset, ResId *id)
+int32_t ParseId(const char *buffer, uint32_t &offset, ResId *id, ResDesc &resDesc)
 {
     errno_t eret = memcpy_s(id, sizeof(ResId), buffer + offset, ResId::RESID_HEADER_LEN);
     if (eret != OK) {
@@ -281,7 +275,7 @@ int32_t ParseId(const char *buffer, uint32_t &offset, ResId *id)
             return SYS_ERROR;
         }
         uint32_t ipOffset = ip->offset_;
-        int32_t ret = ParseIdItem(buffer, ipOffset, idItem);
+        int32_t ret = ParseIdItem(buffer, ipOffset, idItem, resDesc);
         if (ret != OK) {
             delete (ip);
             delete (idItem);
@@ -312,8 +306,8 @@ bool IsLocaleMatch(const ResConfigImpl *defaultConfig, const std::vector<KeyPara
     return false;
 }
 
-int32_t ParseKey(const char *buffer, uint32_t &offset,  ResKey *key,
-                 bool &match, const ResConfigImpl *defaultConfig)
+int32_t ParseKeyParams(const char *buffer, uint32_t &offset,  ResKey *key,
+                       bool &match, const ResConfigImpl *defaultConfig)
 {
     errno_t eret = memcpy_s(key, sizeof(ResKey), buffer + offset, ResKey::RESKEY_HEADER_LEN);
     if (eret != OK) {
@@ -340,16 +334,18 @@ int32_t ParseKey(const char *buffer, uint32_t &offset,  ResKey *key,
         key->keyParams_.push_back(kp);
     }
     match = IsLocaleMatch(defaultConfig, key->keyParams_);
-    if (!match) {
-        return OK;
-    }
+    return OK;
+}
+
+int32_t ParseKeyId(const char *buffer, ResKey *key, ResDesc &resDesc)
+{
     uint32_t idOffset = key->offset_;
     ResId *id = new (std::nothrow) ResId();
     if (id == nullptr) {
         HILOG_ERROR("new ResId failed when ParseKey");
         return SYS_ERROR;
     }
-    int32_t ret = ParseId(buffer, idOffset, id);
+    int32_t ret = ParseId(buffer, idOffset, id, resDesc);
     if (ret != OK) {
         delete (id);
         return ret;
@@ -358,9 +354,240 @@ int32_t ParseKey(const char *buffer, uint32_t &offset,  ResKey *key,
     return OK;
 }
 
+int32_t ParseKey(const char *buffer, uint32_t &offset,  ResKey *key,
+                 bool &match, const ResConfigImpl *defaultConfig, ResDesc &resDesc)
+{
+    int32_t ret = ParseKeyParams(buffer, offset, key, match, defaultConfig);
+    if (ret != OK || !match) {
+        return ret;
+    }
+    return ParseKeyId(buffer, key, resDesc);
+}
+
+int32_t ParseKeysParallel(const char *buffer, uint32_t &offset, ResDesc &resDesc,
+                          const ResConfigImpl *defaultConfig)
+{
+    // the KEYS table is sequential, every IDSS block is located by key->offset_ and parsed independently
+    size_t first = resDesc.keys_.size();
+    for (uint32_t i = 0; i < resDesc.resHeader_->keyCount_; i++) {
+        ResKey *key = new (std::nothrow) ResKey();
+        if (key == nullptr) {
+            HILOG_ERROR("new ResKey failed when ParseResHex");
+            return SYS_ERROR;
+        }
+        bool match = true;
+        int32_t ret = ParseKeyParams(buffer, offset, key, match, defaultConfig);
+        if (ret != OK) {
+            delete (key);
+            return ret;
+        }
+        if (match) {
+            resDesc.keys_.push_back(key);
+        } else {
+            delete (key);
+        }
+    }
+    size_t count = resDesc.keys_.size() - first;
+    std::vector<int32_t> results(count, OK);
+    ThreadPool::GetInstance().ParallelFor(count, [&](size_t i) {
+        results[i] = ParseKeyId(buffer, resDesc.keys_[first + i], resDesc);
+    });
+    for (size_t i = 0; i < count; ++i) {
+        if (results[i] != OK) {
+            return results[i];
+        }
+    }
+    return OK;
+}
+
+int32_t ParseKeys(const char *buffer, uint32_t &offset, ResDesc &resDesc, const ResConfigImpl *defaultConfig)
+{
+    for (uint32_t i = 0; i < resDesc.resHeader_->keyCount_; i++) {
+        ResKey *key = new (std::nothrow) ResKey();
+        if (key == nullptr) {
+            HILOG_ERROR("new ResKey failed when ParseResHex");
+            return SYS_ERROR;
+        }
+        bool match = true;
+        int32_t ret = ParseKey(buffer, offset, key, match, defaultConfig, resDesc);
+        if (ret != OK) {
+            delete (key);
+            return ret;
+        }
+        if (match) {
+            resDesc.keys_.push_back(key);
+        } else {
+            delete (key);
+        }
+    }
+    return OK;
+}
+
+void CompressLongStrings(ResDesc &resDesc, bool parallel)
+{
+    // the long strings left in the buffer by ParseIdItem
+    std::vector<IdItem *> items;
+    std::vector<std::string_view> values;
+    for (const ResKey *key : resDesc.keys_) {
+        if (key->resId_ == nullptr) {
+            continue;
+        }
+        for (const IdParam *idParam : key->resId_->idParams_) {
+            IdItem *idItem = idParam->idItem_;
+            if (idItem->resType_ == ResType::STRING && !idItem->isArray_ &&
+                idItem->value_.size() >= resDesc.longStrings_->GetThreshold()) {
+                items.push_back(idItem);
+                values.push_back(idItem->value_);
+            }
+        }
+    }
+    resDesc.longStrings_->BuildDictionary(values);
+    auto compress = [&resDesc, &items](size_t i) {
+        IdItem *idItem = items[i];
+        std::string_view compressed;
+        if (resDesc.longStrings_->Compress(idItem->value_, resDesc.stringPool_, compressed)) {
+            idItem->value_ = compressed;
+            idItem->isCompressed_ = true;
+        } else {
+            idItem->value_ = resDesc.stringPool_.Intern(idItem->value_);
+        }
+    };
+    if (parallel) {
+        ThreadPool::GetInstance().ParallelFor(items.size(), compress);
+        return;
+    }
+    for (size_t i = 0; i < items.size(); ++i) {
+        compress(i);
+    }
+}
+
+ResKey *CreateKeyV2(const IndexV2 &index, const IndexV2::Key &entry)
+{
+    ResKey *key = new (std::nothrow) ResKey();
+    if (key == nullptr) {
+        HILOG_ERROR("new ResKey failed when ParseIndexV2");
+        return nullptr;
+    }
+    key->keyParamsCount_ = entry.paramCount;
+    for (uint32_t i = 0; i < entry.paramCount; ++i) {
+        KeyParam *kp = new (std::nothrow) KeyParam();
+        if (kp == nullptr) {
+            HILOG_ERROR("new KeyParam failed when ParseIndexV2");
+            delete (key);
+            return nullptr;
+        }
+        const IndexV2::KeyParam &param = index.GetKeyParams()[entry.firstParam + i];
+        kp->type_ = static_cast<KeyType>(param.type);
+        kp->value_ = param.value;
+        kp->InitStr();
+        key->keyParams_.push_back(kp);
+    }
+    return key;
+}
+
+int32_t ParseVariantV2(const IndexV2 &index, const IndexV2::Id &id, std::string_view name,
+    const IndexV2::Variant &variant, ResKey *key)
+{
+    IdItem *idItem = new (std::nothrow) IdItem();
+    if (idItem == nullptr) {
+        HILOG_ERROR("new IdItem failed when ParseIndexV2");
+        return SYS_ERROR;
+    }
+    IdParam *ip = new (std::nothrow) IdParam();
+    if (ip == nullptr) {
+        HILOG_ERROR("new IdParam failed when ParseIndexV2");
+        delete (idItem);
+        return SYS_ERROR;
+    }
+    ip->id_ = id.id;
+    ip->offset_ = 0;
+    ip->idItem_ = idItem;
+    key->resId_->idParams_.push_back(ip);
+    key->resId_->count_++;
+    idItem->id_ = id.id;
+    idItem->resType_ = static_cast<ResType>(id.resType);
+    idItem->name_ = name;
+    idItem->JudgeArray();
+    if (idItem->isArray_) {
+        if (static_cast<uint64_t>(variant.value) + variant.valueCount > index.GetHeader().arrayCount) {
+            return SYS_ERROR;
+        }
+        for (uint32_t i = 0; i < variant.valueCount; ++i) {
+            std::string_view value;
+            if (!index.GetString(index.GetArrays()[variant.value + i], value)) {
+                return SYS_ERROR;
+            }
+            idItem->values_.push_back(value);
+        }
+        return OK;
+    }
+    if (!index.GetString(variant.value, idItem->value_) || idItem->value_.size() > UINT16_MAX) {
+        return SYS_ERROR;
+    }
+    idItem->valueLen_ = static_cast<uint16_t>(idItem->value_.size());
+    return OK;
+}
+
+int32_t ParseIndexV2(const char *buffer, const size_t bufLen, ResDesc &resDesc, const ResConfigImpl *defaultConfig)
+{
+    IndexV2 *indexV2 = new (std::nothrow) IndexV2();
+    if (indexV2 == nullptr || indexV2->Init(buffer, bufLen) != OK) {
+        delete (indexV2);
+        return SYS_ERROR;
+    }
+    resDesc.indexV2_ = indexV2;
+    const IndexV2 &index = *indexV2;
+    const IndexV2::Header &header = index.GetHeader();
+    // the keys matching the locale by index, else nullptr
+    std::vector<ResKey *> keys(header.keyCount, nullptr);
+    for (uint32_t i = 0; i < header.keyCount; ++i) {
+        const IndexV2::Key &entry = index.GetKeys()[i];
+        if (static_cast<uint64_t>(entry.firstParam) + entry.paramCount > header.keyParamCount) {
+            return SYS_ERROR;
+        }
+        ResKey *key = CreateKeyV2(index, entry);
+        if (key == nullptr) {
+            return SYS_ERROR;
+        }
+        if (!IsLocaleMatch(defaultConfig, key->keyParams_)) {
+            delete (key);
+            continue;
+        }
+        key->resId_ = new (std::nothrow) ResId();
+        if (key->resId_ == nullptr) {
+            HILOG_ERROR("new ResId failed when ParseIndexV2");
+            delete (key);
+            return SYS_ERROR;
+        }
+        resDesc.keys_.push_back(key);
+        keys[i] = key;
+    }
+    for (uint32_t i = 0; i < header.idCount; ++i) {
+        const IndexV2::Id &id = index.GetIds()[i];
+        std::string_view name;
+        if (static_cast<uint64_t>(id.firstVariant) + id.variantCount > header.variantCount ||
+            id.resType >= ResType::MAX_RES_TYPE || !index.GetString(id.name, name)) {
+            return SYS_ERROR;
+        }
+        for (uint32_t j = 0; j < id.variantCount; ++j) {
+            const IndexV2::Variant &variant = index.GetVariants()[id.firstVariant + j];
+            if (variant.key >= header.keyCount) {
+                return SYS_ERROR;
+            }
+            if (keys[variant.key] == nullptr) {
+                continue;
+            }
+            int32_t ret = ParseVariantV2(index, id, name, variant, keys[variant.key]);
+            if (ret != OK) {
+                return ret;
+            }
+        }
+    }
+    return OK;
+}
 
 int32_t HapParser::ParseResHex(const char *buffer, const size_t bufLen, ResDesc &resDesc,
-                               const ResConfigImpl *defaultConfig)
+                               const ResConfigImpl *defaultConfig, bool parallel)
 {
     ResHeader *resHeader = new (std::nothrow) ResHeader();
     if (resHeader == nullptr) {
@@ -380,23 +607,16 @@ int32_t HapParser::ParseResHex(const char *buffer, const size_t bufLen, ResDesc
     }
 
     resDesc.resHeader_ = resHeader;
-    for (uint32_t i = 0; i < resHeader->keyCount_; i++) {
-        ResKey *key = new (std::nothrow) ResKey();
-        if (key == nullptr) {
-            HILOG_ERROR("new ResKey failed when ParseResHex");
-            return SYS_ERROR;
-        }
-        bool match = true;
-        int32_t ret = ParseKey(buffer, offset, key, match, defaultConfig);
-        if (ret != OK) {
-            delete (key);
-            return ret;
-        }
-        if (match) {
-            resDesc.keys_.push_back(key);
-        } else {
-            delete (key);
-        }
+    if (IndexV2::IsIndexV2(buffer, bufLen)) {
+        return ParseIndexV2(buffer, bufLen, resDesc, defaultConfig);
+    }
+    int32_t ret = parallel ? ParseKeysParallel(buffer, offset, resDesc, defaultConfig) :
+        ParseKeys(buffer, offset, resDesc, defaultConfig);
+    if (ret != OK) {
+        return ret;
+    }
+    if (resDesc.longStrings_ != nullptr) {
+        CompressLongStrings(resDesc, parallel);
     }
     return OK;
 }
@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/index_v2.h"
+
+#include <cstring>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "hilog_wrapper.h"
+#include "securec.h"
+#include "utils/errors.h"
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+namespace {
+const uint32_t FNV_OFFSET_BASIS = 2166136261u;
+
+const uint32_t FNV_PRIME = 16777619u;
+
+template<typename T>
+bool IsTableValid(size_t bufLen, uint32_t offset, uint32_t count, const char *name)
+{
+    if (offset % IndexV2::ALIGNMENT != 0 ||
+        static_cast<uint64_t>(offset) + static_cast<uint64_t>(count) * sizeof(T) > bufLen) {
+        HILOG_ERROR("invalid %s table, offset %u count %u", name, offset, count);
+        return false;
+    }
+    return true;
+}
+
+template<typename T>
+void AppendTable(std::string &out, const std::vector<T> &table)
+{
+    if (!table.empty()) {
+        out.append(reinterpret_cast<const char *>(table.data()), table.size() * sizeof(T));
+    }
+}
+
+class StringsWriter {
+public:
+    StringsWriter()
+    {
+        // the offset 0 is the empty string
+        Add(std::string_view());
+    }
+
+    uint32_t Add(std::string_view str)
+    {
+        auto iter = offsets_.find(std::string(str));
+        if (iter != offsets_.end()) {
+            return iter->second;
+        }
+        uint32_t offset = static_cast<uint32_t>(strings_.size());
+        uint32_t len = static_cast<uint32_t>(str.size());
+        strings_.append(reinterpret_cast<const char *>(&len), sizeof(len));
+        strings_.append(str.data(), str.size());
+        strings_.append(1, '\0');
+        strings_.append((IndexV2::ALIGNMENT - strings_.size() % IndexV2::ALIGNMENT) % IndexV2::ALIGNMENT, '\0');
+        offsets_[std::string(str)] = offset;
+        return offset;
+    }
+
+    const std::string &GetStrings() const
+    {
+        return strings_;
+    }
+
+private:
+    std::string strings_;
+
+    std::unordered_map<std::string, uint32_t> offsets_;
+};
+} // namespace
+
+bool IndexV2::IsIndexV2(const char *buffer, size_t bufLen)
+{
+    size_t prefixLen = strlen(VERSION_PREFIX);
+    return buffer != nullptr && bufLen >= RES_HEADER_LEN && strncmp(buffer, VERSION_PREFIX, prefixLen) == 0;
+}
+
+int32_t IndexV2::Init(const char *buffer, size_t bufLen)
+{
+    if (!IsIndexV2(buffer, bufLen) || bufLen < RES_HEADER_LEN + sizeof(Header) ||
+        reinterpret_cast<uintptr_t>(buffer) % ALIGNMENT != 0) {
+        HILOG_ERROR("invalid index v2 header");
+        return SYS_ERROR;
+    }
+    const Header *header = reinterpret_cast<const Header *>(buffer + RES_HEADER_LEN);
+    if (!IsTableValid<Key>(bufLen, header->keysOffset, header->keyCount, "keys") ||
+        !IsTableValid<KeyParam>(bufLen, header->keyParamsOffset, header->keyParamCount, "key params") ||
+        !IsTableValid<Id>(bufLen, header->idsOffset, header->idCount, "ids") ||
+        !IsTableValid<Variant>(bufLen, header->variantsOffset, header->variantCount, "variants") ||
+        !IsTableValid<uint32_t>(bufLen, header->arraysOffset, header->arrayCount, "arrays") ||
+        !IsTableValid<uint32_t>(bufLen, header->bucketsOffset, header->bucketCount, "names") ||
+        !IsTableValid<char>(bufLen, header->stringsOffset, header->stringsSize, "strings")) {
+        return SYS_ERROR;
+    }
+    if ((header->bucketCount & (header->bucketCount - 1)) != 0 || header->bucketCount < header->idCount) {
+        HILOG_ERROR("invalid names table size %u", header->bucketCount);
+        return SYS_ERROR;
+    }
+    buffer_ = buffer;
+    bufLen_ = bufLen;
+    header_ = header;
+    keys_ = reinterpret_cast<const Key *>(buffer + header->keysOffset);
+    keyParams_ = reinterpret_cast<const KeyParam *>(buffer + header->keyParamsOffset);
+    ids_ = reinterpret_cast<const Id *>(buffer + header->idsOffset);
+    variants_ = reinterpret_cast<const Variant *>(buffer + header->variantsOffset);
+    arrays_ = reinterpret_cast<const uint32_t *>(buffer + header->arraysOffset);
+    buckets_ = reinterpret_cast<const uint32_t *>(buffer + header->bucketsOffset);
+    return OK;
+}
+
+bool IndexV2::GetString(uint32_t offset, std::string_view &str) const
+{
+    const uint64_t size = header_->stringsSize;
+    if (offset % ALIGNMENT != 0 || static_cast<uint64_t>(offset) + sizeof(uint32_t) > size) {
+        return false;
+    }
+    const char *base = buffer_ + header_->stringsOffset + offset;
+    uint32_t len = *reinterpret_cast<const uint32_t *>(base);
+    if (static_cast<uint64_t>(offset) + sizeof(uint32_t) + len + 1 > size || base[sizeof(uint32_t) + len] != '\0') {
+        return false;
+    }
+    str = std::string_view(base + sizeof(uint32_t), len);
+    return true;
+}
+
+int32_t IndexV2::FindId(uint32_t resType, std::string_view name) const
+{
+    uint32_t bucketCount = header_->bucketCount;
+    if (bucketCount == 0) {
+        return -1;
+    }
+    uint32_t bucket = HashName(resType, name, bucketCount);
+    for (uint32_t i = 0; i < bucketCount; ++i) {
+        uint32_t index = buckets_[bucket];
+        if (index == EMPTY_BUCKET) {
+            return -1;
+        }
+        std::string_view idName;
+        if (index < header_->idCount && ids_[index].resType == resType && GetString(ids_[index].name, idName) &&
+            idName == name) {
+            return static_cast<int32_t>(index);
+        }
+        bucket = (bucket + 1) & (bucketCount - 1);
+    }
+    return -1;
+}
+
+uint32_t IndexV2::HashName(uint32_t resType, std::string_view name, uint32_t bucketCount)
+{
+    // FNV-1a of the type and the name
+    uint32_t hash = (FNV_OFFSET_BASIS ^ resType) * FNV_PRIME;
+    for (char c : name) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * FNV_PRIME;
+    }
+    return hash & (bucketCount - 1);
+}
+
+int32_t IndexV2::Write(const ResDesc &resDesc, std::string &out)
+{
+    return Write(resDesc.keys_, resDesc.longStrings_, out);
+}
+
+int32_t IndexV2::Write(const std::vector<ResKey *> &resKeys, const LongStringStore *longStrings, std::string &out)
+{
+    std::vector<Key> keys;
+    std::vector<KeyParam> keyParams;
+    // the values of every id by key index
+    std::map<uint32_t, std::vector<std::pair<uint32_t, const IdItem *>>> values;
+    for (const ResKey *resKey : resKeys) {
+        uint32_t keyIndex = static_cast<uint32_t>(keys.size());
+        keys.push_back({ static_cast<uint32_t>(keyParams.size()), static_cast<uint32_t>(resKey->keyParams_.size()) });
+        for (const Resource::KeyParam *keyParam : resKey->keyParams_) {
+            keyParams.push_back({ static_cast<uint32_t>(keyParam->type_), keyParam->value_ });
+        }
+        if (resKey->resId_ == nullptr) {
+            continue;
+        }
+        for (const IdParam *idParam : resKey->resId_->idParams_) {
+            if (idParam->idItem_ != nullptr) {
+                values[idParam->id_].emplace_back(keyIndex, idParam->idItem_);
+            }
+        }
+    }
+
+    StringsWriter strings;
+    std::vector<Id> ids;
+    std::vector<Variant> variants;
+    std::vector<uint32_t> arrays;
+    for (const auto &idValues : values) {
+        const IdItem *first = idValues.second.front().second;
+        ids.push_back({ idValues.first, static_cast<uint32_t>(first->resType_), strings.Add(first->name_),
+            static_cast<uint32_t>(variants.size()), static_cast<uint32_t>(idValues.second.size()) });
+        for (const auto &keyValue : idValues.second) {
+            const IdItem *idItem = keyValue.second;
+            if (idItem->isArray_) {
+                variants.push_back({ keyValue.first, static_cast<uint32_t>(arrays.size()),
+                    static_cast<uint32_t>(idItem->values_.size()) });
+                for (std::string_view value : idItem->values_) {
+                    arrays.push_back(strings.Add(value));
+                }
+                continue;
+            }
+            std::shared_ptr<const std::string> holder;
+            variants.push_back({ keyValue.first, strings.Add(idItem->GetValue(longStrings, holder)), 0 });
+        }
+    }
+
+    uint32_t bucketCount = 1;
+    while (bucketCount < ids.size() * 2) {
+        bucketCount <<= 1;
+    }
+    std::vector<uint32_t> buckets(bucketCount, EMPTY_BUCKET);
+    for (uint32_t i = 0; i < ids.size(); ++i) {
+        std::string_view name = values[ids[i].id].front().second->name_;
+        uint32_t bucket = HashName(ids[i].resType, name, bucketCount);
+        bool duplicated = false;
+        while (buckets[bucket] != EMPTY_BUCKET) {
+            const Id &other = ids[buckets[bucket]];
+            if (other.resType == ids[i].resType && values[other.id].front().second->name_ == name) {
+                // the first id of a name is found by it, as in version 1
+                duplicated = true;
+                break;
+            }
+            bucket = (bucket + 1) & (bucketCount - 1);
+        }
+        if (!duplicated) {
+            buckets[bucket] = i;
+        }
+    }
+
+    Header header = {};
+    uint32_t offset = RES_HEADER_LEN + sizeof(Header);
+    auto place = [&offset](uint32_t &tableOffset, uint32_t &tableCount, size_t count, size_t entrySize) {
+        tableOffset = offset;
+        tableCount = static_cast<uint32_t>(count);
+        offset += static_cast<uint32_t>(count * entrySize);
+    };
+    place(header.keysOffset, header.keyCount, keys.size(), sizeof(Key));
+    place(header.keyParamsOffset, header.keyParamCount, keyParams.size(), sizeof(KeyParam));
+    place(header.idsOffset, header.idCount, ids.size(), sizeof(Id));
+    place(header.variantsOffset, header.variantCount, variants.size(), sizeof(Variant));
+    place(header.arraysOffset, header.arrayCount, arrays.size(), sizeof(uint32_t));
+    place(header.bucketsOffset, header.bucketCount, buckets.size(), sizeof(uint32_t));
+    place(header.stringsOffset, header.stringsSize, strings.GetStrings().size(), sizeof(char));
+
+    ResHeader resHeader = {};
+    errno_t eret = memcpy_s(resHeader.version_, sizeof(resHeader.version_), VERSION, strlen(VERSION));
+    if (eret != OK) {
+        return SYS_ERROR;
+    }
+    resHeader.length_ = offset;
+    resHeader.keyCount_ = header.keyCount;
+    out.clear();
+    out.reserve(offset);
+    out.append(reinterpret_cast<const char *>(&resHeader), RES_HEADER_LEN);
+    out.append(reinterpret_cast<const char *>(&header), sizeof(Header));
+    AppendTable(out, keys);
+    AppendTable(out, keyParams);
+    AppendTable(out, ids);
+    AppendTable(out, variants);
+    AppendTable(out, arrays);
+    AppendTable(out, buckets);
+    out.append(strings.GetStrings());
+    return (out.size() == offset) ? OK : SYS_ERROR;
+}
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/long_string_store.h"
+
+#include <algorithm>
+#include <zlib.h>
+
+#include "hilog_wrapper.h"
+#include "utils/memory_usage.h"
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+namespace {
+// the bytes sampled from the start of every value for the dictionary
+const size_t MIN_SAMPLE_LEN = 32;
+
+const size_t MAX_SAMPLE_LEN = 512;
+
+const int DEFLATE_MEM_LEVEL = 8;
+}
+
+LongStringStore::LongStringStore(size_t threshold, size_t cacheSize) : threshold_(threshold), cacheSize_(cacheSize)
+{}
+
+void LongStringStore::BuildDictionary(const std::vector<std::string_view> &values)
+{
+    size_t total = 0;
+    for (std::string_view value : values) {
+        total += value.size();
+    }
+    size_t dictSize = std::min(MAX_DICTIONARY_SIZE, total / 8);
+    if (dictSize == 0) {
+        return;
+    }
+    // the common words and phrases of the texts, the end of the dictionary is the nearest to match
+    size_t sampleLen = std::min(std::max(dictSize / values.size(), MIN_SAMPLE_LEN), MAX_SAMPLE_LEN);
+    dictionary_.reserve(dictSize);
+    for (auto iter = values.rbegin(); iter != values.rend() && dictionary_.size() < dictSize; ++iter) {
+        size_t len = std::min({sampleLen, iter->size(), dictSize - dictionary_.size()});
+        dictionary_.append(iter->data(), len);
+    }
+    dictionary_.shrink_to_fit();
+}
+
+bool LongStringStore::Compress(std::string_view value, StringPool &pool, std::string_view &compressed) const
+{
+    z_stream stream = {};
+    // raw deflate data, no zlib header
+    if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS, DEFLATE_MEM_LEVEL,
+        Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+    if (!dictionary_.empty() && deflateSetDictionary(&stream, reinterpret_cast<const Bytef *>(dictionary_.data()),
+        static_cast<uInt>(dictionary_.size())) != Z_OK) {
+        deflateEnd(&stream);
+        return false;
+    }
+    std::string out(deflateBound(&stream, static_cast<uLong>(value.size())), '\0');
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(value.data()));
+    stream.avail_in = static_cast<uInt>(value.size());
+    stream.next_out = reinterpret_cast<Bytef *>(&out[0]);
+    stream.avail_out = static_cast<uInt>(out.size());
+    int ret = deflate(&stream, Z_FINISH);
+    size_t produced = stream.total_out;
+    deflateEnd(&stream);
+    if (ret != Z_STREAM_END || produced >= value.size()) {
+        return false;
+    }
+    out.resize(produced);
+    compressed = pool.Intern(out);
+    return !compressed.empty();
+}
+
+std::shared_ptr<const std::string> LongStringStore::Decode(std::string_view compressed, size_t len) const
+{
+    if (compressed.empty()) {
+        return nullptr;
+    }
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        auto iter = cacheIndex_.find(compressed.data());
+        if (iter != cacheIndex_.end()) {
+            cache_.splice(cache_.begin(), cache_, iter->second);
+            return iter->second->second;
+        }
+    }
+    std::shared_ptr<const std::string> value = Inflate(compressed, len);
+    if (value == nullptr || value->size() > cacheSize_) {
+        return value;
+    }
+    std::lock_guard<std::mutex> lock(lock_);
+    // another thread may have inflated it meanwhile
+    if (cacheIndex_.find(compressed.data()) == cacheIndex_.end()) {
+        cache_.emplace_front(compressed.data(), value);
+        cacheIndex_[compressed.data()] = cache_.begin();
+        cacheBytes_ += value->size();
+        while (cacheBytes_ > cacheSize_) {
+            cacheBytes_ -= cache_.back().second->size();
+            cacheIndex_.erase(cache_.back().first);
+            cache_.pop_back();
+        }
+    }
+    return value;
+}
+
+std::shared_ptr<const std::string> LongStringStore::Inflate(std::string_view compressed, size_t len) const
+{
+    auto value = std::make_shared<std::string>(len, '\0');
+    z_stream stream = {};
+    // raw deflate data, no zlib header
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+        return nullptr;
+    }
+    if (!dictionary_.empty() && inflateSetDictionary(&stream, reinterpret_cast<const Bytef *>(dictionary_.data()),
+        static_cast<uInt>(dictionary_.size())) != Z_OK) {
+        inflateEnd(&stream);
+        return nullptr;
+    }
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(compressed.data()));
+    stream.avail_in = static_cast<uInt>(compressed.size());
+    stream.next_out = reinterpret_cast<Bytef *>(&(*value)[0]);
+    stream.avail_out = static_cast<uInt>(len);
+    int ret = inflate(&stream, Z_FINISH);
+    size_t produced = stream.total_out;
+    inflateEnd(&stream);
+    if (ret != Z_STREAM_END || produced != len) {
+        HILOG_ERROR("inflate long string failed, ret %d", ret);
+        return nullptr;
+    }
+    return value;
+}
+
+void LongStringStore::ClearCache()
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    std::list<CacheEntry>().swap(cache_);
+    std::unordered_map<const char *, std::list<CacheEntry>::iterator>().swap(cacheIndex_);
+    cacheBytes_ = 0;
+}
+
+size_t LongStringStore::GetMemoryUsage() const
+{
+    return MemoryUsage::Of(dictionary_);
+}
+
+size_t LongStringStore::GetCacheUsage() const
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    // the list node with its two links, and the shared string with its control block
+    constexpr size_t entryBytes = sizeof(CacheEntry) + 2 * sizeof(void *) + sizeof(std::string) + 2 * sizeof(long);
+    return cacheBytes_ + cache_.size() * entryBytes + MemoryUsage::Of(cacheIndex_);
+}
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
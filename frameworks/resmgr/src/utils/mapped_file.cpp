@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/mapped_file.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <unordered_map>
+#ifndef __WINNT__
+#include <sys/mman.h>
+#endif
+
+#include "hilog_wrapper.h"
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+namespace {
+// the expired entries are swept when the registry grows beyond it
+constexpr size_t MIN_SWEEP_SIZE = 64;
+
+std::mutex g_registryLock;
+std::unordered_map<std::string, std::weak_ptr<const MappedFile>> g_registry;
+size_t g_sweepSize = MIN_SWEEP_SIZE;
+
+void SweepRegistry()
+{
+    for (auto iter = g_registry.begin(); iter != g_registry.end();) {
+        if (iter->second.expired()) {
+            iter = g_registry.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+    g_sweepSize = std::max(MIN_SWEEP_SIZE, g_registry.size() * 2);
+}
+
+bool ReadAll(int fd, char *buf, size_t len)
+{
+    size_t total = 0;
+    while (total < len) {
+        auto count = read(fd, buf + total, static_cast<unsigned int>(len - total));
+        if (count <= 0) {
+            return false;
+        }
+        total += static_cast<size_t>(count);
+    }
+    return true;
+}
+} // namespace
+
+MappedFile::~MappedFile()
+{
+    if (data_ == nullptr) {
+        return;
+    }
+#ifndef __WINNT__
+    if (mapped_) {
+        munmap(data_, size_);
+        return;
+    }
+#endif
+    free(data_);
+}
+
+bool MappedFile::Load(const std::string &path, size_t size, bool writable)
+{
+    size_ = size;
+    if (size == 0) {
+        return true;
+    }
+#ifdef __WINNT__
+    int fd = open(path.c_str(), O_RDONLY | O_BINARY);
+#else
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+#endif
+    if (fd < 0) {
+        HILOG_ERROR("Cannot open %s", path.c_str());
+        return false;
+    }
+#ifndef __WINNT__
+    // the pages of a private mapping are copied on write, the file is opened read only
+    int prot = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void *base = mmap(nullptr, size, prot, MAP_PRIVATE, fd, 0);
+    if (base != MAP_FAILED) {
+        data_ = static_cast<char *>(base);
+        mapped_ = true;
+    }
+#endif
+    if (!mapped_) {
+        char *buf = static_cast<char *>(malloc(size));
+        if (buf == nullptr || !ReadAll(fd, buf, size)) {
+            HILOG_ERROR("read %s failed", path.c_str());
+            free(buf);
+            close(fd);
+            return false;
+        }
+        data_ = buf;
+    }
+    close(fd);
+    return true;
+}
+
+std::shared_ptr<const MappedFile> MappedFile::Open(const std::string &path)
+{
+    struct stat fileStat = {};
+    if (stat(path.c_str(), &fileStat) != 0) {
+        HILOG_ERROR("Cannot stat %s", path.c_str());
+        return nullptr;
+    }
+    size_t size = static_cast<size_t>(fileStat.st_size);
+    std::lock_guard<std::mutex> lock(g_registryLock);
+    auto iter = g_registry.find(path);
+    if (iter != g_registry.end()) {
+        std::shared_ptr<const MappedFile> shared = iter->second.lock();
+        if (shared != nullptr && shared->modTime_ == fileStat.st_mtime && shared->size_ == size) {
+            return shared;
+        }
+    }
+    std::shared_ptr<MappedFile> file(new (std::nothrow) MappedFile());
+    if (file == nullptr) {
+        HILOG_ERROR("new MappedFile failed");
+        return nullptr;
+    }
+    file->modTime_ = fileStat.st_mtime;
+    if (!file->Load(path, size, false)) {
+        return nullptr;
+    }
+    if (g_registry.size() >= g_sweepSize) {
+        SweepRegistry();
+    }
+    g_registry[path] = file;
+    return file;
+}
+
+std::shared_ptr<MappedFile> MappedFile::OpenPrivate(const std::string &path)
+{
+    struct stat fileStat = {};
+    if (stat(path.c_str(), &fileStat) != 0) {
+        HILOG_ERROR("Cannot stat %s", path.c_str());
+        return nullptr;
+    }
+    std::shared_ptr<MappedFile> file(new (std::nothrow) MappedFile());
+    if (file == nullptr) {
+        HILOG_ERROR("new MappedFile failed");
+        return nullptr;
+    }
+    file->modTime_ = fileStat.st_mtime;
+    if (!file->Load(path, static_cast<size_t>(fileStat.st_size), true)) {
+        return nullptr;
+    }
+    return file;
+}
+
+size_t MappedFile::GetSharedCount()
+{
+    std::lock_guard<std::mutex> lock(g_registryLock);
+    size_t count = 0;
+    for (auto iter = g_registry.begin(); iter != g_registry.end(); ++iter) {
+        if (!iter->second.expired()) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void MappedFile::ReleaseCache()
+{
+    std::lock_guard<std::mutex> lock(g_registryLock);
+    SweepRegistry();
+}
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
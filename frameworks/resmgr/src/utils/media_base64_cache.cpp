@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/media_base64_cache.h"
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+MediaBase64Cache::MediaBase64Cache(size_t maxSize) : maxSize_(maxSize)
+{}
+
+bool MediaBase64Cache::Get(const std::string &path, time_t modTime, off_t fileSize, std::string &value)
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    auto iter = entries_.find(path);
+    if (iter == entries_.end()) {
+        return false;
+    }
+    auto entry = iter->second;
+    if (entry->modTime != modTime || entry->fileSize != fileSize) {
+        Erase(iter);
+        return false;
+    }
+    lru_.splice(lru_.begin(), lru_, entry);
+    value = entry->value;
+    return true;
+}
+
+void MediaBase64Cache::Put(const std::string &path, time_t modTime, off_t fileSize, const std::string &value)
+{
+    if (value.size() > maxSize_) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(lock_);
+    auto iter = entries_.find(path);
+    if (iter != entries_.end()) {
+        Erase(iter);
+    }
+    while (!lru_.empty() && size_ + value.size() > maxSize_) {
+        Erase(entries_.find(lru_.back().path));
+    }
+    lru_.push_front({path, modTime, fileSize, value});
+    entries_[path] = lru_.begin();
+    size_ += value.size();
+}
+
+void MediaBase64Cache::Clear()
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    // clear() keeps the buckets
+    std::list<Entry>().swap(lru_);
+    std::unordered_map<std::string, std::list<Entry>::iterator>().swap(entries_);
+    size_ = 0;
+}
+
+size_t MediaBase64Cache::GetSize() const
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    return size_;
+}
+
+size_t MediaBase64Cache::GetEntryCount() const
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    return entries_.size();
+}
+
+void MediaBase64Cache::Erase(std::unordered_map<std::string, std::list<Entry>::iterator>::iterator iter)
+{
+    size_ -= iter->second->value.size();
+    lru_.erase(iter->second);
+    entries_.erase(iter);
+}
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/raw_file_descriptor_cache.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "hilog_wrapper.h"
+#include "utils/memory_usage.h"
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+RawFileDescriptorCache::RawFileDescriptorCache(size_t maxOpenFiles, size_t maxEntries)
+    : maxOpenFiles_(maxOpenFiles == 0 ? 1 : maxOpenFiles), maxEntries_(maxEntries)
+{}
+
+RawFileDescriptorCache::~RawFileDescriptorCache()
+{
+    for (auto iter = files_.begin(); iter != files_.end(); ++iter) {
+        close(iter->second.fd);
+    }
+}
+
+bool RawFileDescriptorCache::Acquire(const std::string &name, Descriptor &descriptor)
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    return AcquireLocked(name, descriptor);
+}
+
+bool RawFileDescriptorCache::AcquireLocked(const std::string &name, Descriptor &descriptor)
+{
+    auto iter = entries_.find(name);
+    if (iter == entries_.end()) {
+        return false;
+    }
+    Entry &entry = iter->second;
+    if (entry.refs++ == 0) {
+        idle_.erase(entry.idle);
+    }
+    descriptor.fd = files_[entry.path].fd;
+    descriptor.offset = entry.offset;
+    descriptor.length = entry.length;
+    return true;
+}
+
+bool RawFileDescriptorCache::Open(const std::string &name, const std::string &path, long offset, long length,
+    Descriptor &descriptor)
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    // another thread may have opened the name since the caller missed it, checked under the lock of the insert
+    if (AcquireLocked(name, descriptor)) {
+        return true;
+    }
+    auto file = files_.find(path);
+    if (file == files_.end()) {
+        // drop the least recently used names until a file is closed
+        while (files_.size() >= maxOpenFiles_ && !idle_.empty()) {
+            Evict(idle_.back());
+        }
+        if (files_.size() >= maxOpenFiles_) {
+            HILOG_ERROR("too many raw file descriptors held, max open files %zu", maxOpenFiles_);
+            return false;
+        }
+        int flags = O_RDONLY;
+#ifdef O_CLOEXEC
+        flags |= O_CLOEXEC;
+#endif
+        int fd = open(path.c_str(), flags);
+        if (fd < 0) {
+            HILOG_ERROR("open %s failed", path.c_str());
+            return false;
+        }
+        file = files_.emplace(path, File()).first;
+        file->second.fd = fd;
+    }
+    Entry entry;
+    entry.path = path;
+    entry.offset = offset;
+    entry.length = length;
+    entry.refs = 1;
+    if (entries_.emplace(name, entry).second) {
+        file->second.names++;
+    }
+    descriptor.fd = file->second.fd;
+    descriptor.offset = offset;
+    descriptor.length = length;
+    return true;
+}
+
+bool RawFileDescriptorCache::Release(const std::string &name)
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    auto iter = entries_.find(name);
+    if (iter == entries_.end() || iter->second.refs == 0) {
+        return false;
+    }
+    Entry &entry = iter->second;
+    if (--entry.refs == 0) {
+        idle_.push_front(name);
+        entry.idle = idle_.begin();
+        Trim();
+    }
+    return true;
+}
+
+void RawFileDescriptorCache::SetLimits(size_t maxOpenFiles, size_t maxEntries)
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    maxOpenFiles_ = (maxOpenFiles == 0) ? 1 : maxOpenFiles;
+    maxEntries_ = maxEntries;
+    Trim();
+    while (files_.size() > maxOpenFiles_ && !idle_.empty()) {
+        Evict(idle_.back());
+    }
+}
+
+void RawFileDescriptorCache::ReleaseIdle()
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    while (!idle_.empty()) {
+        Evict(idle_.back());
+    }
+}
+
+size_t RawFileDescriptorCache::GetOpenFileCount() const
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    return files_.size();
+}
+
+size_t RawFileDescriptorCache::GetEntryCount() const
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    return entries_.size();
+}
+
+size_t RawFileDescriptorCache::GetMemoryUsage() const
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    // a node of idle_ holds a name and the previous and next links
+    size_t usage = MemoryUsage::Of(files_) + MemoryUsage::Of(entries_) +
+        idle_.size() * (sizeof(std::string) + 2 * sizeof(void *));
+    for (auto iter = files_.begin(); iter != files_.end(); ++iter) {
+        usage += MemoryUsage::Of(iter->first);
+    }
+    for (auto iter = entries_.begin(); iter != entries_.end(); ++iter) {
+        usage += MemoryUsage::Of(iter->first) + MemoryUsage::Of(iter->second.path);
+    }
+    for (auto iter = idle_.begin(); iter != idle_.end(); ++iter) {
+        usage += MemoryUsage::Of(*iter);
+    }
+    return usage;
+}
+
+void RawFileDescriptorCache::Evict(const std::string name)
+{
+    auto iter = entries_.find(name);
+    if (iter == entries_.end()) {
+        return;
+    }
+    idle_.erase(iter->second.idle);
+    auto file = files_.find(iter->second.path);
+    if (file != files_.end() && --file->second.names == 0) {
+        close(file->second.fd);
+        files_.erase(file);
+    }
+    entries_.erase(iter);
+}
+
+void RawFileDescriptorCache::Trim()
+{
+    while (entries_.size() > maxEntries_ && !idle_.empty()) {
+        Evict(idle_.back());
+    }
+}
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
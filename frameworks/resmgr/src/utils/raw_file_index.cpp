@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/raw_file_index.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "hilog_wrapper.h"
+#include "utils/memory_usage.h"
+#ifdef __WINNT__
+#include <shlwapi.h>
+#include <windows.h>
+#endif
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+const std::string RawFileIndex::ROOT_DIR = "rawfile";
+
+namespace {
+// guards against directory links pointing to an ancestor
+constexpr int MAX_DEPTH = 64;
+
+bool StatInside(const std::string &path, const std::string &realRoot, struct stat &st)
+{
+#ifdef __WINNT__
+    return stat(path.c_str(), &st) == 0;
+#else
+    if (lstat(path.c_str(), &st) != 0) {
+        return false;
+    }
+    if (!S_ISLNK(st.st_mode)) {
+        return true;
+    }
+    // a link is followed only when its target is inside the resources directory
+    char real[PATH_MAX] = {0};
+    if (realpath(path.c_str(), real) == nullptr) {
+        return false;
+    }
+    const std::string realPath = real;
+    if (realPath.length() <= realRoot.length() || realPath.compare(0, realRoot.length(), realRoot) != 0 ||
+        realPath[realRoot.length()] != '/') {
+        HILOG_ERROR("raw file link out of the resources directory, %s", path.c_str());
+        return false;
+    }
+    return stat(path.c_str(), &st) == 0;
+#endif
+}
+
+// the mod time of a directory with the nanoseconds, empty if it can not be stat
+std::string GetDirStamp(const std::string &path)
+{
+    struct stat st = {};
+    if (stat(path.c_str(), &st) != 0) {
+        return std::string();
+    }
+#ifdef __WINNT__
+    long modTimeNsec = 0;
+#else
+    long modTimeNsec = st.st_mtim.tv_nsec;
+#endif
+    return std::to_string(st.st_mtime) + "." + std::to_string(modTimeNsec);
+}
+} // namespace
+
+RawFileIndex *RawFileIndex::BuildFromDirectory(const std::string &resourcesDir)
+{
+    RawFileIndex *index = new (std::nothrow) RawFileIndex();
+    if (index == nullptr) {
+        HILOG_ERROR("new RawFileIndex failed when BuildFromDirectory");
+        return nullptr;
+    }
+    index->root_ = resourcesDir;
+    char realRoot[PATH_MAX] = {0};
+#ifdef __WINNT__
+    if (!PathCanonicalizeA(realRoot, resourcesDir.c_str())) {
+        return index;
+    }
+#else
+    if (realpath(resourcesDir.c_str(), realRoot) == nullptr) {
+        return index;
+    }
+#endif
+    index->ScanDirectory(resourcesDir + ROOT_DIR, ROOT_DIR, realRoot, 0);
+    index->Sort();
+    index->memoryUsage_ = index->MeasureMemory();
+    return index;
+}
+
+RawFileIndex *RawFileIndex::BuildFromZip(const ZipArchive &archive, const std::string &prefix)
+{
+    RawFileIndex *index = new (std::nothrow) RawFileIndex();
+    if (index == nullptr) {
+        HILOG_ERROR("new RawFileIndex failed when BuildFromZip");
+        return nullptr;
+    }
+    const std::string base = prefix + ROOT_DIR + "/";
+    for (auto iter = archive.GetEntries().begin(); iter != archive.GetEntries().end(); ++iter) {
+        const std::string &entryName = iter->first;
+        if (entryName.length() < base.length() || entryName.compare(0, base.length(), base) != 0) {
+            continue;
+        }
+        std::string name;
+        if (!Normalize(entryName.substr(prefix.length()), name)) {
+            continue;
+        }
+        // the directories of a zip are the entries ending with '/'
+        if (entryName.back() == '/') {
+            index->AddDir(name);
+            continue;
+        }
+        File file;
+        file.size = iter->second.uncompressedSize;
+        file.entry = &iter->second;
+        index->AddFile(name, file);
+    }
+    index->Sort();
+    index->memoryUsage_ = index->MeasureMemory();
+    return index;
+}
+
+bool RawFileIndex::Normalize(const std::string &name, std::string &outName)
+{
+    outName.clear();
+    size_t start = 0;
+    while (start <= name.length()) {
+        size_t end = name.find('/', start);
+        if (end == std::string::npos) {
+            end = name.length();
+        }
+        size_t len = end - start;
+        if (len == 2 && name.compare(start, len, "..") == 0) {
+            return false;
+        }
+        if (len > 0 && !(len == 1 && name[start] == '.')) {
+            if (!outName.empty()) {
+                outName.push_back('/');
+            }
+            outName.append(name, start, len);
+        }
+        start = end + 1;
+    }
+    return true;
+}
+
+void RawFileIndex::ScanDirectory(const std::string &path, const std::string &name, const std::string &realRoot,
+    int depth)
+{
+    // taken before the directory is read, so a change made during the read is found by IsChanged
+    dirStamps_.emplace_back(path, GetDirStamp(path));
+    DIR *dir = opendir(path.c_str());
+    if (dir == nullptr) {
+        return;
+    }
+    AddDir(name);
+    if (depth >= MAX_DEPTH) {
+        HILOG_ERROR("raw file directory too deep, %s", path.c_str());
+        closedir(dir);
+        return;
+    }
+    struct dirent *dirp = readdir(dir);
+    while (dirp != nullptr) {
+        const std::string child = dirp->d_name;
+        dirp = readdir(dir);
+        if (child == "." || child == "..") {
+            continue;
+        }
+        const std::string childPath = path + "/" + child;
+        struct stat st;
+        if (!StatInside(childPath, realRoot, st)) {
+            continue;
+        }
+        if (S_ISDIR(st.st_mode)) {
+            ScanDirectory(childPath, name + "/" + child, realRoot, depth + 1);
+        } else if (S_ISREG(st.st_mode)) {
+            File file;
+            file.size = static_cast<uint64_t>(st.st_size);
+            AddFile(name + "/" + child, file);
+        }
+    }
+    closedir(dir);
+}
+
+void RawFileIndex::AddDir(const std::string &name)
+{
+    if (dirs_.find(name) != dirs_.end()) {
+        return;
+    }
+    dirs_[name];
+    auto pos = name.rfind('/');
+    if (pos == std::string::npos) {
+        return;
+    }
+    const std::string parent = name.substr(0, pos);
+    AddDir(parent);
+    dirs_[parent].subDirs.push_back(name);
+}
+
+void RawFileIndex::AddFile(const std::string &name, const File &file)
+{
+    if (!files_.emplace(name, file).second) {
+        return;
+    }
+    auto pos = name.rfind('/');
+    if (pos == std::string::npos) {
+        return;
+    }
+    const std::string parent = name.substr(0, pos);
+    AddDir(parent);
+    dirs_[parent].files.push_back(name);
+}
+
+void RawFileIndex::Sort()
+{
+    for (auto iter = dirs_.begin(); iter != dirs_.end(); ++iter) {
+        std::sort(iter->second.files.begin(), iter->second.files.end());
+        std::sort(iter->second.subDirs.begin(), iter->second.subDirs.end());
+    }
+}
+
+size_t RawFileIndex::MeasureMemory() const
+{
+    size_t usage = MemoryUsage::Of(root_) + MemoryUsage::Of(files_) + MemoryUsage::Of(dirs_) +
+        MemoryUsage::Of(dirStamps_);
+    for (auto iter = dirStamps_.begin(); iter != dirStamps_.end(); ++iter) {
+        usage += MemoryUsage::Of(iter->first) + MemoryUsage::Of(iter->second);
+    }
+    for (auto iter = files_.begin(); iter != files_.end(); ++iter) {
+        usage += MemoryUsage::Of(iter->first);
+    }
+    for (auto iter = dirs_.begin(); iter != dirs_.end(); ++iter) {
+        usage += MemoryUsage::Of(iter->first) + MemoryUsage::Of(iter->second.files) +
+            MemoryUsage::Of(iter->second.subDirs);
+        for (const std::string &name : iter->second.files) {
+            usage += MemoryUsage::Of(name);
+        }
+        for (const std::string &name : iter->second.subDirs) {
+            usage += MemoryUsage::Of(name);
+        }
+    }
+    return usage;
+}
+
+bool RawFileIndex::IsChanged() const
+{
+    for (auto iter = dirStamps_.begin(); iter != dirStamps_.end(); ++iter) {
+        if (GetDirStamp(iter->first) != iter->second) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const RawFileIndex::File *RawFileIndex::Find(const std::string &name) const
+{
+    auto iter = files_.find(name);
+    if (iter == files_.end()) {
+        return nullptr;
+    }
+    return &iter->second;
+}
+
+bool RawFileIndex::List(const std::string &dir, bool recursive, std::vector<std::string> &names) const
+{
+    auto iter = dirs_.find(dir);
+    if (iter == dirs_.end()) {
+        return false;
+    }
+    ListDir(iter->second, recursive, names);
+    return true;
+}
+
+void RawFileIndex::ListDir(const Dir &dir, bool recursive, std::vector<std::string> &names) const
+{
+    names.insert(names.end(), dir.files.begin(), dir.files.end());
+    if (!recursive) {
+        return;
+    }
+    for (auto iter = dir.subDirs.begin(); iter != dir.subDirs.end(); ++iter) {
+        auto sub = dirs_.find(*iter);
+        if (sub != dirs_.end()) {
+            ListDir(sub->second, recursive, names);
+        }
+    }
+}
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
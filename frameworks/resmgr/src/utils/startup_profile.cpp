@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/startup_profile.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "hilog_wrapper.h"
+#include "utils/errors.h"
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+namespace {
+// the first line of a profile file
+const char *PROFILE_HEADER = "ResStartupProfile 1";
+
+const size_t MAX_LINE_LEN = 1024;
+
+// the lookups of the thread are not recorded, set by ReplayScope
+thread_local bool g_replaying = false;
+
+bool ParseUint32(const char *str, uint32_t &value, const char *&end)
+{
+    char *parseEnd = nullptr;
+    unsigned long result = strtoul(str, &parseEnd, 10);
+    if (parseEnd == str || result > UINT32_MAX) {
+        return false;
+    }
+    value = static_cast<uint32_t>(result);
+    end = parseEnd;
+    return true;
+}
+
+bool ParseLine(const char *line, StartupProfile::Entry &entry)
+{
+    const char *end = nullptr;
+    if (line[0] == '\0' || line[1] != ' ') {
+        return false;
+    }
+    entry.type = static_cast<StartupProfile::EntryType>(line[0]);
+    entry.id = 0;
+    entry.resType = VALUES;
+    entry.name.clear();
+    switch (entry.type) {
+        case StartupProfile::ID:
+            return ParseUint32(line + 2, entry.id, end) && *end == '\0';
+        case StartupProfile::NAME: {
+            uint32_t resType = 0;
+            if (!ParseUint32(line + 2, resType, end) || *end != ' ' || resType >= MAX_RES_TYPE) {
+                return false;
+            }
+            entry.resType = static_cast<ResType>(resType);
+            entry.name = end + 1;
+            return !entry.name.empty();
+        }
+        case StartupProfile::RAW_FILE:
+            entry.name = line + 2;
+            return !entry.name.empty();
+        default:
+            return false;
+    }
+}
+} // namespace
+
+bool StartupProfile::Start(uint32_t durationMs, const EndCallback &onEnd)
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    if (started_) {
+        return false;
+    }
+    started_ = true;
+    deadline_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(durationMs);
+    onEnd_ = onEnd;
+    recording_.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void StartupProfile::Stop()
+{
+    std::unique_lock<std::mutex> lock(lock_);
+    End(lock);
+}
+
+void StartupProfile::End(std::unique_lock<std::mutex> &lock)
+{
+    if (!recording_.load(std::memory_order_relaxed)) {
+        lock.unlock();
+        return;
+    }
+    recording_.store(false, std::memory_order_relaxed);
+    EndCallback onEnd = std::move(onEnd_);
+    onEnd_ = nullptr;
+    std::vector<Entry> entries = entries_;
+    lock.unlock();
+    if (onEnd) {
+        onEnd(entries);
+    }
+}
+
+void StartupProfile::Record(EntryType type, uint32_t id, ResType resType, const char *name)
+{
+    if (g_replaying) {
+        return;
+    }
+    // a name of several lines can not be saved
+    if (type != ID && (name == nullptr || name[0] == '\0' || strpbrk(name, "\r\n") != nullptr)) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(lock_);
+    if (!recording_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    // the window has ended, the lookup ends the recording instead of a thread waiting for it
+    if (std::chrono::steady_clock::now() >= deadline_) {
+        End(lock);
+        return;
+    }
+    if (entries_.size() >= MAX_ENTRIES) {
+        return;
+    }
+    if (type == ID) {
+        if (!ids_.insert(id).second) {
+            return;
+        }
+        entries_.push_back({ type, id, resType, std::string() });
+        return;
+    }
+    std::string key = std::string(1, static_cast<char>(type)) + std::to_string(resType) + " " + name;
+    if (!names_.insert(key).second) {
+        return;
+    }
+    entries_.push_back({ type, id, resType, std::string(name) });
+}
+
+std::vector<StartupProfile::Entry> StartupProfile::GetEntries() const
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    return entries_;
+}
+
+int32_t StartupProfile::Save(const std::string &path, const std::vector<Entry> &entries)
+{
+    std::string tempPath = path + ".tmp";
+    FILE *file = fopen(tempPath.c_str(), "w");
+    if (file == nullptr) {
+        HILOG_ERROR("open startup profile %s failed", tempPath.c_str());
+        return SYS_ERROR;
+    }
+    bool success = fprintf(file, "%s\n", PROFILE_HEADER) > 0;
+    for (size_t i = 0; i < entries.size() && success; ++i) {
+        const Entry &entry = entries[i];
+        if (entry.type == ID) {
+            success = fprintf(file, "%c %u\n", entry.type, entry.id) > 0;
+        } else if (entry.type == NAME) {
+            success = fprintf(file, "%c %d %s\n", entry.type, entry.resType, entry.name.c_str()) > 0;
+        } else {
+            success = fprintf(file, "%c %s\n", entry.type, entry.name.c_str()) > 0;
+        }
+    }
+    success = (fclose(file) == 0) && success;
+    if (!success || rename(tempPath.c_str(), path.c_str()) != 0) {
+        HILOG_ERROR("save startup profile %s failed", path.c_str());
+        remove(tempPath.c_str());
+        return SYS_ERROR;
+    }
+    return OK;
+}
+
+int32_t StartupProfile::Load(const std::string &path, std::vector<Entry> &entries)
+{
+    FILE *file = fopen(path.c_str(), "r");
+    if (file == nullptr) {
+        return SYS_ERROR;
+    }
+    char line[MAX_LINE_LEN];
+    bool valid = false;
+    entries.clear();
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        size_t len = strlen(line);
+        if (len > 0 && line[len - 1] == '\n') {
+            line[len - 1] = '\0';
+        }
+        if (!valid) {
+            valid = (strcmp(line, PROFILE_HEADER) == 0);
+            if (!valid) {
+                break;
+            }
+            continue;
+        }
+        Entry entry;
+        // the broken lines are skipped
+        if (ParseLine(line, entry) && entries.size() < MAX_ENTRIES) {
+            entries.push_back(std::move(entry));
+        }
+    }
+    fclose(file);
+    if (!valid) {
+        HILOG_ERROR("invalid startup profile %s", path.c_str());
+        return SYS_ERROR;
+    }
+    return OK;
+}
+
+StartupProfile::ReplayScope::ReplayScope()
+{
+    g_replaying = true;
+}
+
+StartupProfile::ReplayScope::~ReplayScope()
+{
+    g_replaying = false;
+}
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/string_pool.h"
+
+#include <cstdlib>
+
+#include "hilog_wrapper.h"
+#include "securec.h"
+#include "utils/errors.h"
+#include "utils/memory_usage.h"
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+StringPool::~StringPool()
+{
+    for (size_t i = 0; i < SHARD_COUNT; ++i) {
+        for (char *block : shards_[i].blocks) {
+            free(block);
+        }
+    }
+}
+
+std::string_view StringPool::Intern(std::string_view str)
+{
+    if (str.empty()) {
+        return std::string_view("");
+    }
+    Shard &shard = shards_[std::hash<std::string_view>()(str) % SHARD_COUNT];
+    std::lock_guard<std::mutex> lock(shard.lock);
+    auto iter = shard.strings.find(str);
+    if (iter != shard.strings.end()) {
+        return *iter;
+    }
+    char *data = Allocate(shard, str.size() + 1);
+    if (data == nullptr) {
+        HILOG_ERROR("allocate string failed, size: %zu", str.size());
+        return std::string_view("");
+    }
+    errno_t eret = memcpy_s(data, str.size() + 1, str.data(), str.size());
+    if (eret != OK) {
+        HILOG_ERROR("memcpy_s error : %d", eret);
+        return std::string_view("");
+    }
+    data[str.size()] = '\0';
+    std::string_view interned(data, str.size());
+    shard.strings.insert(interned);
+    return interned;
+}
+
+char *StringPool::Allocate(Shard &shard, size_t len)
+{
+    if (len <= shard.left) {
+        char *data = shard.next;
+        shard.next += len;
+        shard.left -= len;
+        return data;
+    }
+    // a long string has its own block, the space left in the current one is still used
+    if (len > shard.blockSize / 4) {
+        char *block = static_cast<char *>(malloc(len));
+        if (block == nullptr) {
+            return nullptr;
+        }
+        shard.blocks.push_back(block);
+        shard.blockBytes += len;
+        return block;
+    }
+    char *block = static_cast<char *>(malloc(shard.blockSize));
+    if (block == nullptr) {
+        return nullptr;
+    }
+    shard.blocks.push_back(block);
+    shard.blockBytes += shard.blockSize;
+    shard.next = block + len;
+    shard.left = shard.blockSize - len;
+    if (shard.blockSize < MAX_BLOCK_SIZE) {
+        shard.blockSize *= 2;
+    }
+    return block;
+}
+
+size_t StringPool::GetCount() const
+{
+    size_t count = 0;
+    for (size_t i = 0; i < SHARD_COUNT; ++i) {
+        std::lock_guard<std::mutex> lock(shards_[i].lock);
+        count += shards_[i].strings.size();
+    }
+    return count;
+}
+
+size_t StringPool::GetMemoryUsage() const
+{
+    size_t usage = 0;
+    for (size_t i = 0; i < SHARD_COUNT; ++i) {
+        const Shard &shard = shards_[i];
+        std::lock_guard<std::mutex> lock(shard.lock);
+        // a node of the set holds the view, the next link and the cached hash
+        usage += shard.blockBytes + MemoryUsage::Of(shard.blocks) + shard.strings.bucket_count() * sizeof(void *) +
+            shard.strings.size() * (sizeof(std::string_view) + 2 * sizeof(void *));
+    }
+    return usage;
+}
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/thread_pool.h"
+
+#include <atomic>
+#include <memory>
+
+#include "hilog_wrapper.h"
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+namespace {
+struct ParallelState {
+    explicit ParallelState(size_t count, const std::function<void(size_t)> *func)
+        : count_(count), func_(func)
+    {}
+
+    // run the remaining tasks until there are none left
+    void Run()
+    {
+        while (true) {
+            size_t index = next_.fetch_add(1);
+            if (index >= count_) {
+                return;
+            }
+            (*func_)(index);
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (++done_ == count_) {
+                cond_.notify_all();
+            }
+        }
+    }
+
+    size_t count_;
+    // only dereferenced while some task is unfinished, the caller is still waiting then
+    const std::function<void(size_t)> *func_;
+    std::atomic<size_t> next_ {0};
+    size_t done_ = 0;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+};
+} // namespace
+
+ThreadPool &ThreadPool::GetInstance()
+{
+    // never destroyed, workers may still be running when static objects are released
+    static ThreadPool *instance = new ThreadPool(std::thread::hardware_concurrency());
+    return *instance;
+}
+
+ThreadPool::ThreadPool(size_t threadCount) : threadCount_(threadCount == 0 ? 1 : threadCount)
+{}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+    }
+    cond_.notify_all();
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        if (workers_[i].joinable()) {
+            workers_[i].join();
+        }
+    }
+}
+
+void ThreadPool::Post(const std::function<void()> &task)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(task);
+    if (idleCount_ == 0 && workers_.size() < threadCount_) {
+        workers_.emplace_back(&ThreadPool::WorkerLoop, this);
+        HILOG_DEBUG("ThreadPool start worker %zu", workers_.size());
+    }
+    cond_.notify_one();
+}
+
+void ThreadPool::WorkerLoop()
+{
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            idleCount_++;
+            cond_.wait(lock, [this] { return stopped_ || !tasks_.empty(); });
+            idleCount_--;
+            if (tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)> &func)
+{
+    if (count == 0) {
+        return;
+    }
+    if (count == 1) {
+        func(0);
+        return;
+    }
+    auto state = std::make_shared<ParallelState>(count, &func);
+    size_t helpers = (count - 1 < threadCount_) ? (count - 1) : threadCount_;
+    for (size_t i = 0; i < helpers; ++i) {
+        Post([state] { state->Run(); });
+    }
+    state->Run();
+    std::unique_lock<std::mutex> lock(state->mutex_);
+    state->cond_.wait(lock, [&state] { return state->done_ == state->count_; });
+}
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
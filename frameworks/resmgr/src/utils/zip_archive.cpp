@@ -0,0 +1,489 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/zip_archive.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <vector>
+#include <zlib.h>
+#ifndef __WINNT__
+#include <sys/mman.h>
+#endif
+
+#include "hilog_wrapper.h"
+#include "utils/errors.h"
+#include "utils/string_utils.h"
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+namespace {
+constexpr uint32_t EOCD_SIGNATURE = 0x06054b50;
+constexpr uint32_t ZIP64_EOCD_LOCATOR_SIGNATURE = 0x07064b50;
+constexpr uint32_t ZIP64_EOCD_SIGNATURE = 0x06064b50;
+constexpr uint32_t CD_SIGNATURE = 0x02014b50;
+constexpr uint32_t LOCAL_HEADER_SIGNATURE = 0x04034b50;
+constexpr size_t EOCD_LEN = 22;
+constexpr size_t ZIP64_EOCD_LOCATOR_LEN = 20;
+constexpr size_t ZIP64_EOCD_LEN = 56;
+constexpr size_t CD_HEADER_LEN = 46;
+constexpr size_t LOCAL_HEADER_LEN = 30;
+constexpr size_t MAX_COMMENT_LEN = 0xFFFF;
+constexpr uint16_t ZIP64_EXTRA_ID = 0x0001;
+constexpr uint32_t ZIP64_MARK32 = 0xFFFFFFFF;
+constexpr uint16_t ZIP64_MARK16 = 0xFFFF;
+
+// the expired entries are swept when the registry grows beyond it
+constexpr size_t MIN_SWEEP_SIZE = 64;
+
+std::mutex g_cacheLock;
+// the archives are not kept open by it, an archive is closed when the last user releases it
+std::unordered_map<std::string, std::weak_ptr<ZipArchive>> g_archiveCache;
+size_t g_sweepSize = MIN_SWEEP_SIZE;
+
+void SweepCache()
+{
+    for (auto iter = g_archiveCache.begin(); iter != g_archiveCache.end();) {
+        if (iter->second.expired()) {
+            iter = g_archiveCache.erase(iter);
+        } else {
+            ++iter;
+        }
+    }
+    g_sweepSize = std::max(MIN_SWEEP_SIZE, g_archiveCache.size() * 2);
+}
+
+inline long GetModTimeNsec(const struct stat &fileStat)
+{
+#ifdef __WINNT__
+    return 0;
+#else
+    return fileStat.st_mtim.tv_nsec;
+#endif
+}
+
+inline uint16_t ReadU16(const unsigned char *p)
+{
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+inline uint32_t ReadU32(const unsigned char *p)
+{
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+        (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint64_t ReadU64(const unsigned char *p)
+{
+    return static_cast<uint64_t>(ReadU32(p)) | (static_cast<uint64_t>(ReadU32(p + 4)) << 32);
+}
+
+// replace the 32 bits sizes and offset which are marked as 0xFFFFFFFF by the zip64 extra field
+void ApplyZip64Extra(const unsigned char *extra, size_t extraLen, ZipArchive::Entry &entry)
+{
+    size_t pos = 0;
+    while (pos + 4 <= extraLen) {
+        uint16_t id = ReadU16(extra + pos);
+        uint16_t size = ReadU16(extra + pos + 2);
+        pos += 4;
+        if (pos + size > extraLen) {
+            return;
+        }
+        if (id == ZIP64_EXTRA_ID) {
+            const unsigned char *field = extra + pos;
+            const unsigned char *end = field + size;
+            if (entry.uncompressedSize == ZIP64_MARK32 && field + 8 <= end) {
+                entry.uncompressedSize = ReadU64(field);
+                field += 8;
+            }
+            if (entry.compressedSize == ZIP64_MARK32 && field + 8 <= end) {
+                entry.compressedSize = ReadU64(field);
+                field += 8;
+            }
+            if (entry.localHeaderOffset == ZIP64_MARK32 && field + 8 <= end) {
+                entry.localHeaderOffset = ReadU64(field);
+            }
+            return;
+        }
+        pos += size;
+    }
+}
+} // namespace
+
+ZipArchive::View::~View()
+{
+    if (base_ == nullptr) {
+        return;
+    }
+#ifndef __WINNT__
+    if (mapped_) {
+        munmap(base_, baseLen_);
+        return;
+    }
+#endif
+    free(base_);
+}
+
+std::shared_ptr<ZipArchive> ZipArchive::Open(const std::string &path, std::string &errInfo)
+{
+    struct stat fileStat = {};
+    if (stat(path.c_str(), &fileStat) != 0) {
+        errInfo = FormatString("Cannot stat %s", path.c_str());
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(g_cacheLock);
+    auto iter = g_archiveCache.find(path);
+    if (iter != g_archiveCache.end()) {
+        std::shared_ptr<ZipArchive> shared = iter->second.lock();
+        if (shared != nullptr && shared->modTime_ == fileStat.st_mtime &&
+            shared->modTimeNsec_ == GetModTimeNsec(fileStat) &&
+            shared->fileSize_ == static_cast<uint64_t>(fileStat.st_size) &&
+            shared->inode_ == static_cast<uint64_t>(fileStat.st_ino)) {
+            return shared;
+        }
+        if (shared != nullptr) {
+            HILOG_DEBUG("%s was modified, reopen it", path.c_str());
+        }
+    }
+#ifdef __WINNT__
+    int fd = open(path.c_str(), O_RDONLY | O_BINARY);
+#else
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+#endif
+    if (fd < 0) {
+        errInfo = FormatString("Cannot open %s", path.c_str());
+        return nullptr;
+    }
+    std::shared_ptr<ZipArchive> archive(new (std::nothrow) ZipArchive(path, fd,
+        static_cast<uint64_t>(fileStat.st_size), fileStat.st_mtime, GetModTimeNsec(fileStat),
+        static_cast<uint64_t>(fileStat.st_ino)));
+    if (archive == nullptr) {
+        close(fd);
+        errInfo = "new ZipArchive failed";
+        return nullptr;
+    }
+    if (archive->ParseCentralDirectory(errInfo) != OK) {
+        return nullptr;
+    }
+    if (g_archiveCache.size() >= g_sweepSize) {
+        SweepCache();
+    }
+    g_archiveCache[path] = archive;
+    return archive;
+}
+
+void ZipArchive::ReleaseCache()
+{
+    std::lock_guard<std::mutex> lock(g_cacheLock);
+    g_archiveCache.clear();
+    g_sweepSize = MIN_SWEEP_SIZE;
+}
+
+ZipArchive::ZipArchive(const std::string &path, int fd, uint64_t fileSize, time_t modTime, long modTimeNsec,
+    uint64_t inode)
+    : path_(path), fd_(fd), fileSize_(fileSize), modTime_(modTime), modTimeNsec_(modTimeNsec), inode_(inode)
+{}
+
+ZipArchive::~ZipArchive()
+{
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool ZipArchive::ReadAt(uint64_t offset, void *buf, size_t len) const
+{
+    if (offset > fileSize_ || len > fileSize_ - offset) {
+        return false;
+    }
+    char *out = static_cast<char *>(buf);
+#ifdef __WINNT__
+    std::lock_guard<std::mutex> lock(readLock_);
+    if (_lseeki64(fd_, static_cast<__int64>(offset), SEEK_SET) < 0) {
+        return false;
+    }
+#endif
+    while (len > 0) {
+#ifdef __WINNT__
+        int ret = read(fd_, out, static_cast<unsigned int>(len));
+#else
+        ssize_t ret = pread(fd_, out, len, static_cast<off_t>(offset));
+#endif
+        if (ret <= 0) {
+            return false;
+        }
+        out += ret;
+        offset += static_cast<uint64_t>(ret);
+        len -= static_cast<size_t>(ret);
+    }
+    return true;
+}
+
+int32_t ZipArchive::LocateCentralDirectory(uint64_t &cdOffset, uint64_t &cdSize, uint64_t &count,
+    std::string &errInfo)
+{
+    if (fileSize_ < EOCD_LEN) {
+        errInfo = FormatString("%s is too small to be a zip file", path_.c_str());
+        return UNKNOWN_ERROR;
+    }
+    // the end of central directory record is followed by a comment of at most 64K
+    size_t tailLen = static_cast<size_t>(std::min<uint64_t>(fileSize_, EOCD_LEN + MAX_COMMENT_LEN));
+    uint64_t tailOffset = fileSize_ - tailLen;
+    std::vector<unsigned char> tail(tailLen);
+    if (!ReadAt(tailOffset, tail.data(), tailLen)) {
+        errInfo = FormatString("Cannot read %s", path_.c_str());
+        return UNKNOWN_ERROR;
+    }
+    size_t pos = tailLen - EOCD_LEN + 1;
+    const unsigned char *eocd = nullptr;
+    while (pos-- > 0) {
+        if (ReadU32(tail.data() + pos) == EOCD_SIGNATURE) {
+            eocd = tail.data() + pos;
+            break;
+        }
+    }
+    if (eocd == nullptr) {
+        errInfo = FormatString("End of central directory not found in %s", path_.c_str());
+        return UNKNOWN_ERROR;
+    }
+    count = ReadU16(eocd + 10);
+    cdSize = ReadU32(eocd + 12);
+    cdOffset = ReadU32(eocd + 16);
+    if (count != ZIP64_MARK16 && cdSize != ZIP64_MARK32 && cdOffset != ZIP64_MARK32) {
+        return OK;
+    }
+    if (pos < ZIP64_EOCD_LOCATOR_LEN ||
+        ReadU32(tail.data() + pos - ZIP64_EOCD_LOCATOR_LEN) != ZIP64_EOCD_LOCATOR_SIGNATURE) {
+        errInfo = FormatString("Zip64 locator not found in %s", path_.c_str());
+        return UNKNOWN_ERROR;
+    }
+    uint64_t zip64EocdOffset = ReadU64(tail.data() + pos - ZIP64_EOCD_LOCATOR_LEN + 8);
+    unsigned char zip64Eocd[ZIP64_EOCD_LEN];
+    if (!ReadAt(zip64EocdOffset, zip64Eocd, ZIP64_EOCD_LEN) || ReadU32(zip64Eocd) != ZIP64_EOCD_SIGNATURE) {
+        errInfo = FormatString("Zip64 end of central directory error in %s", path_.c_str());
+        return UNKNOWN_ERROR;
+    }
+    count = ReadU64(zip64Eocd + 32);
+    cdSize = ReadU64(zip64Eocd + 40);
+    cdOffset = ReadU64(zip64Eocd + 48);
+    return OK;
+}
+
+int32_t ZipArchive::ParseCentralDirectory(std::string &errInfo)
+{
+    uint64_t cdOffset = 0;
+    uint64_t cdSize = 0;
+    uint64_t count = 0;
+    int32_t ret = LocateCentralDirectory(cdOffset, cdSize, count, errInfo);
+    if (ret != OK) {
+        return ret;
+    }
+    if (cdOffset > fileSize_ || cdSize > fileSize_ - cdOffset) {
+        errInfo = FormatString("Central directory out of range in %s", path_.c_str());
+        return UNKNOWN_ERROR;
+    }
+    // every entry takes at least a header, the count is checked before the entries are reserved by it
+    if (count > cdSize / CD_HEADER_LEN) {
+        errInfo = FormatString("Central directory of %s is too small for %llu entries", path_.c_str(),
+            static_cast<unsigned long long>(count));
+        return UNKNOWN_ERROR;
+    }
+    std::vector<unsigned char> cd(static_cast<size_t>(cdSize));
+    if (!ReadAt(cdOffset, cd.data(), cd.size())) {
+        errInfo = FormatString("Cannot read central directory of %s", path_.c_str());
+        return UNKNOWN_ERROR;
+    }
+    entries_.reserve(static_cast<size_t>(count));
+    size_t pos = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        if (pos + CD_HEADER_LEN > cd.size() || ReadU32(cd.data() + pos) != CD_SIGNATURE) {
+            errInfo = FormatString("Central directory header %llu error in %s",
+                static_cast<unsigned long long>(i), path_.c_str());
+            return UNKNOWN_ERROR;
+        }
+        const unsigned char *header = cd.data() + pos;
+        Entry entry;
+        entry.method = ReadU16(header + 10);
+        entry.crc32 = ReadU32(header + 16);
+        entry.compressedSize = ReadU32(header + 20);
+        entry.uncompressedSize = ReadU32(header + 24);
+        uint16_t nameLen = ReadU16(header + 28);
+        uint16_t extraLen = ReadU16(header + 30);
+        uint16_t commentLen = ReadU16(header + 32);
+        entry.localHeaderOffset = ReadU32(header + 42);
+        if (pos + CD_HEADER_LEN + nameLen + extraLen + commentLen > cd.size()) {
+            errInfo = FormatString("Central directory header %llu out of range in %s",
+                static_cast<unsigned long long>(i), path_.c_str());
+            return UNKNOWN_ERROR;
+        }
+        ApplyZip64Extra(header + CD_HEADER_LEN + nameLen, extraLen, entry);
+        // a stored entry is mapped and read by its uncompressed size, the data range is checked by the other
+        if (entry.method == METHOD_STORED && entry.compressedSize != entry.uncompressedSize) {
+            errInfo = FormatString("Stored entry %llu of %s has different sizes", static_cast<unsigned long long>(i),
+                path_.c_str());
+            return UNKNOWN_ERROR;
+        }
+        std::string name(reinterpret_cast<const char *>(header + CD_HEADER_LEN), nameLen);
+        entries_.emplace(std::move(name), entry);
+        pos += CD_HEADER_LEN + nameLen + extraLen + commentLen;
+    }
+    HILOG_DEBUG("%s has %zu entries", path_.c_str(), entries_.size());
+    return OK;
+}
+
+const ZipArchive::Entry *ZipArchive::GetEntry(const std::string &name) const
+{
+    auto iter = entries_.find(name);
+    if (iter == entries_.end()) {
+        return nullptr;
+    }
+    return &iter->second;
+}
+
+int32_t ZipArchive::GetDataOffset(const Entry &entry, uint64_t &offset) const
+{
+    unsigned char header[LOCAL_HEADER_LEN];
+    if (!ReadAt(entry.localHeaderOffset, header, LOCAL_HEADER_LEN) ||
+        ReadU32(header) != LOCAL_HEADER_SIGNATURE) {
+        HILOG_ERROR("local header error in %s", path_.c_str());
+        return UNKNOWN_ERROR;
+    }
+    // the extra field of the local header may differ from the one in central directory
+    offset = entry.localHeaderOffset + LOCAL_HEADER_LEN + ReadU16(header + 26) + ReadU16(header + 28);
+    if (offset > fileSize_ || entry.compressedSize > fileSize_ - offset) {
+        HILOG_ERROR("entry data out of range in %s", path_.c_str());
+        return UNKNOWN_ERROR;
+    }
+    return OK;
+}
+
+bool ZipArchive::Map(uint64_t offset, size_t len, View *view) const
+{
+#ifdef __WINNT__
+    return false;
+#else
+    static const uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    uint64_t alignedOffset = offset - offset % pageSize;
+    size_t delta = static_cast<size_t>(offset - alignedOffset);
+    void *base = mmap(nullptr, len + delta, PROT_READ, MAP_PRIVATE, fd_, static_cast<off_t>(alignedOffset));
+    if (base == MAP_FAILED) {
+        HILOG_ERROR("mmap %s failed", path_.c_str());
+        return false;
+    }
+    view->base_ = base;
+    view->baseLen_ = len + delta;
+    view->mapped_ = true;
+    view->data_ = static_cast<const char *>(base) + delta;
+    view->size_ = len;
+    return true;
+#endif
+}
+
+bool ZipArchive::Inflate(const Entry &entry, uint64_t dataOffset, View *view) const
+{
+    size_t compressedSize = static_cast<size_t>(entry.compressedSize);
+    // read the compressed bytes through a temporary mapping when possible
+    View input;
+    if (!Map(dataOffset, compressedSize, &input)) {
+        input.base_ = malloc(compressedSize == 0 ? 1 : compressedSize);
+        if (input.base_ == nullptr || !ReadAt(dataOffset, input.base_, compressedSize)) {
+            return false;
+        }
+        input.data_ = static_cast<const char *>(input.base_);
+        input.size_ = compressedSize;
+    }
+    size_t size = static_cast<size_t>(entry.uncompressedSize);
+    void *out = malloc(size == 0 ? 1 : size);
+    if (out == nullptr) {
+        HILOG_ERROR("Error allocating memory for inflate");
+        return false;
+    }
+    view->base_ = out;
+    view->data_ = static_cast<const char *>(out);
+    view->size_ = size;
+
+    z_stream stream = {};
+    // raw deflate data, no zlib header
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+        return false;
+    }
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(input.data_));
+    stream.avail_in = static_cast<uInt>(input.size_);
+    stream.next_out = static_cast<Bytef *>(out);
+    stream.avail_out = static_cast<uInt>(size);
+    int ret = inflate(&stream, Z_FINISH);
+    size_t produced = stream.total_out;
+    inflateEnd(&stream);
+    if (ret != Z_STREAM_END || produced != size) {
+        HILOG_ERROR("inflate %s failed, ret %d", path_.c_str(), ret);
+        return false;
+    }
+    if (crc32(0L, static_cast<const Bytef *>(out), static_cast<uInt>(size)) != entry.crc32) {
+        HILOG_ERROR("crc mismatch in %s", path_.c_str());
+        return false;
+    }
+    return true;
+}
+
+ZipArchive::View *ZipArchive::ReadEntry(const std::string &name, std::string &errInfo) const
+{
+    const Entry *entry = GetEntry(name);
+    if (entry == nullptr) {
+        errInfo = FormatString("File %s not found in %s", name.c_str(), path_.c_str());
+        return nullptr;
+    }
+    uint64_t dataOffset = 0;
+    if (GetDataOffset(*entry, dataOffset) != OK) {
+        errInfo = FormatString("Error local header of %s in %s", name.c_str(), path_.c_str());
+        return nullptr;
+    }
+    View *view = new (std::nothrow) View();
+    if (view == nullptr) {
+        errInfo = "new View failed";
+        return nullptr;
+    }
+    if (entry->method == METHOD_STORED) {
+        size_t size = static_cast<size_t>(entry->uncompressedSize);
+        if (size == 0 || Map(dataOffset, size, view)) {
+            return view;
+        }
+        view->base_ = malloc(size);
+        if (view->base_ != nullptr && ReadAt(dataOffset, view->base_, size)) {
+            view->data_ = static_cast<const char *>(view->base_);
+            view->size_ = size;
+            return view;
+        }
+    } else if (entry->method == METHOD_DEFLATED) {
+        if (Inflate(*entry, dataOffset, view)) {
+            return view;
+        }
+    } else {
+        errInfo = FormatString("Unsupported compression method %u of %s", entry->method, name.c_str());
+        delete view;
+        return nullptr;
+    }
+    errInfo = FormatString("Error reading %s from %s", name.c_str(), path_.c_str());
+    delete view;
+    return nullptr;
+}
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/zip_entry_reader.h"
+
+#include <algorithm>
+
+#include "hilog_wrapper.h"
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+namespace {
+// the max distance deflate refers back
+constexpr size_t WINDOW_SIZE = 32768;
+constexpr size_t INPUT_CHUNK = 16384;
+// inflate with Z_BLOCK sets these bits of data_type
+constexpr int END_OF_BLOCK = 128;
+constexpr int LAST_BLOCK = 64;
+constexpr int UNUSED_BITS_MASK = 7;
+constexpr int BITS_PER_BYTE = 8;
+} // namespace
+
+ZipEntryReader::ZipEntryReader(const std::shared_ptr<ZipArchive> &archive, const ZipArchive::Entry &entry,
+    uint64_t dataOffset, uint64_t span)
+    : archive_(archive), entry_(entry), dataOffset_(dataOffset), span_(span), stream_()
+{}
+
+ZipEntryReader::~ZipEntryReader()
+{
+    if (streamInited_) {
+        inflateEnd(&stream_);
+    }
+}
+
+bool ZipEntryReader::Init()
+{
+    if (archive_ == nullptr || entry_.method != ZipArchive::METHOD_DEFLATED) {
+        return false;
+    }
+    // raw deflate data, no zlib header
+    if (inflateInit2(&stream_, -MAX_WBITS) != Z_OK) {
+        HILOG_ERROR("inflateInit2 failed");
+        return false;
+    }
+    streamInited_ = true;
+    inBuf_.resize(INPUT_CHUNK);
+    window_.resize(WINDOW_SIZE);
+    // the beginning of the stream is the first checkpoint
+    checkpoints_.push_back(Checkpoint { 0, 0, 0, std::vector<unsigned char>() });
+    return true;
+}
+
+bool ZipEntryReader::Restore(const Checkpoint &checkpoint)
+{
+    if (inflateReset(&stream_) != Z_OK) {
+        return false;
+    }
+    stream_.next_in = nullptr;
+    stream_.avail_in = 0;
+    inPos_ = checkpoint.in;
+    if (checkpoint.bits > 0) {
+        unsigned char byte = 0;
+        if (!archive_->ReadAt(dataOffset_ + checkpoint.in - 1, &byte, 1)) {
+            return false;
+        }
+        inflatePrime(&stream_, checkpoint.bits, byte >> (BITS_PER_BYTE - checkpoint.bits));
+    }
+    size_t windowLen = checkpoint.window.size();
+    if (windowLen > 0) {
+        inflateSetDictionary(&stream_, checkpoint.window.data(), static_cast<uInt>(windowLen));
+        std::copy(checkpoint.window.begin(), checkpoint.window.end(), window_.begin());
+    }
+    winPos_ = windowLen;
+    windowFull_ = (windowLen == WINDOW_SIZE);
+    outPos_ = checkpoint.out;
+    broken_ = false;
+    return true;
+}
+
+void ZipEntryReader::AddCheckpoint()
+{
+    Checkpoint checkpoint;
+    checkpoint.out = outPos_;
+    checkpoint.in = inPos_ - stream_.avail_in;
+    checkpoint.bits = stream_.data_type & UNUSED_BITS_MASK;
+    // the oldest byte is at winPos_ once the window has wrapped
+    if (windowFull_) {
+        checkpoint.window.reserve(WINDOW_SIZE);
+        checkpoint.window.insert(checkpoint.window.end(), window_.begin() + winPos_, window_.end());
+        checkpoint.window.insert(checkpoint.window.end(), window_.begin(), window_.begin() + winPos_);
+    } else {
+        checkpoint.window.assign(window_.begin(), window_.begin() + winPos_);
+    }
+    checkpoints_.push_back(std::move(checkpoint));
+}
+
+size_t ZipEntryReader::Produce(unsigned char *out, size_t len)
+{
+    size_t produced = 0;
+    while (produced < len && outPos_ < entry_.uncompressedSize) {
+        if (winPos_ == WINDOW_SIZE) {
+            winPos_ = 0;
+            windowFull_ = true;
+        }
+        if (stream_.avail_in == 0) {
+            size_t chunk = static_cast<size_t>(std::min<uint64_t>(INPUT_CHUNK, entry_.compressedSize - inPos_));
+            if (chunk == 0 || !archive_->ReadAt(dataOffset_ + inPos_, inBuf_.data(), chunk)) {
+                HILOG_ERROR("unexpected end of the compressed data in %s", archive_->GetPath().c_str());
+                broken_ = true;
+                break;
+            }
+            inPos_ += chunk;
+            stream_.next_in = inBuf_.data();
+            stream_.avail_in = static_cast<uInt>(chunk);
+        }
+        size_t want = std::min(WINDOW_SIZE - winPos_, len - produced);
+        stream_.next_out = window_.data() + winPos_;
+        stream_.avail_out = static_cast<uInt>(want);
+        // stop at the end of every block, checkpoints are only possible there
+        int ret = inflate(&stream_, Z_BLOCK);
+        if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR) {
+            HILOG_ERROR("inflate %s failed, ret %d", archive_->GetPath().c_str(), ret);
+            broken_ = true;
+            break;
+        }
+        size_t got = want - stream_.avail_out;
+        if (out != nullptr && got > 0) {
+            std::copy(window_.begin() + winPos_, window_.begin() + winPos_ + got, out + produced);
+        }
+        produced += got;
+        winPos_ += got;
+        outPos_ += got;
+        if (ret == Z_STREAM_END) {
+            break;
+        }
+        if ((stream_.data_type & END_OF_BLOCK) != 0 && (stream_.data_type & LAST_BLOCK) == 0 &&
+            outPos_ - checkpoints_.back().out >= span_) {
+            AddCheckpoint();
+        }
+    }
+    return produced;
+}
+
+size_t ZipEntryReader::Read(uint64_t position, void *buf, size_t len)
+{
+    if (!streamInited_ || buf == nullptr || position >= entry_.uncompressedSize) {
+        return 0;
+    }
+    len = static_cast<size_t>(std::min<uint64_t>(len, entry_.uncompressedSize - position));
+    // the last checkpoint at or before position
+    auto iter = std::upper_bound(checkpoints_.begin(), checkpoints_.end(), position,
+        [](uint64_t pos, const Checkpoint &checkpoint) { return pos < checkpoint.out; });
+    const Checkpoint &nearest = *(iter - 1);
+    if (broken_ || position < outPos_ || nearest.out > outPos_) {
+        if (!Restore(nearest)) {
+            broken_ = true;
+            return 0;
+        }
+    }
+    // inflate and drop the bytes before position
+    if (outPos_ < position) {
+        uint64_t skip = position - outPos_;
+        if (Produce(nullptr, static_cast<size_t>(skip)) != skip) {
+            return 0;
+        }
+    }
+    return Produce(static_cast<unsigned char *>(buf), len);
+}
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
@@ -152,4 +152,52 @@ HWTEST_F(HapManagerTest, HapManagerFuncTest002, TestSize.Level1)
     delete (rc2);
     delete (rc);
 }
+
+/*
+ * this test shows how to load several haps at once, the lookup order follows the input order
+ * @tc.name: HapManagerFuncTest003
+ * @tc.desc: Test AddResources & UpdateResConfig function, file case.
+ * @tc.type: FUNC
+ */
+HWTEST_F(HapManagerTest, HapManagerFuncTest003, TestSize.Level1)
+{
+    std::vector<std::string> paths;
+    paths.push_back(FormatFullPath("all/assets/entry/resources.index"));
+    paths.push_back(FormatFullPath("colormode/assets/entry/resources.index"));
+    paths.push_back(FormatFullPath("mccmnc/assets/entry/resources.index"));
+    HapManager *hapManager = new HapManager(new ResConfigImpl);
+    bool ret = hapManager->AddResources(paths);
+    EXPECT_TRUE(ret);
+    ASSERT_EQ(paths.size(), hapManager->hapResources_->size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        EXPECT_EQ(paths[i], (*hapManager->hapResources_)[i]->GetIndexPath());
+    }
+
+    // loaded paths and missing paths are skipped, the others are still added
+    std::vector<std::string> others;
+    others.push_back(paths[0]);
+    others.push_back(FormatFullPath("non_exist/resources.index"));
+    ret = hapManager->AddResources(others);
+    EXPECT_FALSE(ret);
+    EXPECT_EQ(paths.size(), hapManager->hapResources_->size());
+
+    // the same file by another path is found as loaded
+    std::vector<std::string> aliases;
+    aliases.push_back(FormatFullPath("all/../all/assets/entry/resources.index"));
+    EXPECT_FALSE(hapManager->AddResources(aliases));
+    EXPECT_FALSE(hapManager->AddResource(aliases[0].c_str()));
+    EXPECT_EQ(paths.size(), hapManager->hapResources_->size());
+
+    // reload keeps the order
+    ResConfig *rc = CreateResConfig();
+    ASSERT_TRUE(rc != nullptr);
+    rc->SetLocaleInfo("zh", nullptr, "CN");
+    EXPECT_EQ(SUCCESS, hapManager->UpdateResConfig(*rc));
+    ASSERT_EQ(paths.size(), hapManager->hapResources_->size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        EXPECT_EQ(paths[i], (*hapManager->hapResources_)[i]->GetIndexPath());
+    }
+    delete rc;
+    delete hapManager;
+}
 }
\ No newline at end of file
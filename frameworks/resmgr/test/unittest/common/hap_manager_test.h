@@ -18,5 +18,6 @@
 
 int HapManagerFuncTest001(void);
 int HapManagerFuncTest002(void);
+int HapManagerFuncTest003(void);
 
 #endif
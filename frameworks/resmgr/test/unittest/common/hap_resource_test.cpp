@@ -16,6 +16,9 @@
 #include "hap_resource_test.h"
 
 #include <climits>
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
 #include <gtest/gtest.h>
 
 #include "hap_parser.h"
@@ -23,6 +26,7 @@
 #include "test_common.h"
 #include "utils/date_utils.h"
 #include "utils/errors.h"
+#include "utils/index_v2.h"
 #include "utils/string_utils.h"
 
 #define private public
@@ -302,4 +306,280 @@ HWTEST_F(HapResourceTest, HapResourceFuncTest004, TestSize.Level1)
     resDesc = LoadFromHap(FormatFullPath("err-config.json-2.hap").c_str(), nullptr);
     ASSERT_TRUE(resDesc == nullptr);
 }
+
+/*
+ * @tc.name: HapResourceFuncTest005
+ * @tc.desc: Test HapParser::ParseResHex function, the parallel mode gets the same result.
+ * @tc.type: FUNC
+ */
+HWTEST_F(HapResourceTest, HapResourceFuncTest005, TestSize.Level1)
+{
+    std::ifstream inFile(FormatFullPath(g_resFilePath), std::ios::binary | std::ios::in);
+    ASSERT_TRUE(inFile.good());
+    std::string buf((std::istreambuf_iterator<char>(inFile)), std::istreambuf_iterator<char>());
+    ASSERT_FALSE(buf.empty());
+
+    ResConfigImpl *rc = new ResConfigImpl;
+    rc->SetLocaleInfo("zh", nullptr, "CN");
+    const ResConfigImpl *configs[] = { nullptr, rc };
+    for (auto config : configs) {
+        ResDesc sequential;
+        int32_t out = HapParser::ParseResHex(buf.data(), buf.size(), sequential, config);
+        EXPECT_EQ(OK, out);
+        ResDesc parallel;
+        out = HapParser::ParseResHex(buf.data(), buf.size(), parallel, config, true);
+        EXPECT_EQ(OK, out);
+        ASSERT_EQ(sequential.keys_.size(), parallel.keys_.size());
+        EXPECT_EQ(sequential.ToString(), parallel.ToString());
+    }
+    delete rc;
+}
+
+/*
+ * @tc.name: HapResourceFuncTest006
+ * @tc.desc: Test HapResource::LoadFromHap function, the index is read from the hap without copy.
+ * @tc.type: FUNC
+ */
+HWTEST_F(HapResourceTest, HapResourceFuncTest006, TestSize.Level1)
+{
+    std::ifstream inFile(FormatFullPath(g_resFilePath), std::ios::binary | std::ios::in);
+    ASSERT_TRUE(inFile.good());
+    std::string index((std::istreambuf_iterator<char>(inFile)), std::istreambuf_iterator<char>());
+
+    // all.hap is deflated, stored.hap has the same files stored
+    const char *haps[] = { "all.hap", "stored.hap" };
+    for (auto hap : haps) {
+        std::string errInfo;
+        ZipArchive::View *view = HapParser::ReadIndexFromFile(FormatFullPath(hap).c_str(), errInfo);
+        ASSERT_TRUE(view != nullptr);
+        EXPECT_EQ(std::string(hap) == "stored.hap", view->IsMapped());
+        EXPECT_EQ(index, std::string(view->Data(), view->Size()));
+        delete view;
+
+        const HapResource *pResource = HapResource::LoadFromHap(FormatFullPath(hap).c_str(), nullptr);
+        ASSERT_TRUE(pResource != nullptr);
+        EXPECT_TRUE(pResource->GetIdValuesByName(std::string("app_name"), ResType::STRING) != nullptr);
+        delete pResource;
+    }
+
+    // the opened hap is shared while it is in use
+    std::string errInfo;
+    std::shared_ptr<ZipArchive> archive = ZipArchive::Open(FormatFullPath("stored.hap"), errInfo);
+    ASSERT_TRUE(archive != nullptr);
+    EXPECT_EQ(archive, ZipArchive::Open(FormatFullPath("stored.hap"), errInfo));
+    EXPECT_TRUE(archive->GetEntry("assets/entry/resources/rawfile/test_rawfile.txt") != nullptr);
+    EXPECT_TRUE(archive->GetEntry("assets/entry/resources/rawfile/non_exist.txt") == nullptr);
+}
+
+/*
+ * @tc.name: HapResourceFuncTest007
+ * @tc.desc: Test IndexV2::Write function, the version 2 index read in place has the same resources.
+ * @tc.type: FUNC
+ */
+HWTEST_F(HapResourceTest, HapResourceFuncTest007, TestSize.Level1)
+{
+    std::ifstream inFile(FormatFullPath(g_resFilePath), std::ios::binary | std::ios::in);
+    ASSERT_TRUE(inFile.good());
+    std::string buf((std::istreambuf_iterator<char>(inFile)), std::istreambuf_iterator<char>());
+    ResDesc resDesc;
+    ASSERT_EQ(OK, HapParser::ParseResHex(buf.data(), buf.size(), resDesc, nullptr));
+    std::string index;
+    ASSERT_EQ(OK, IndexV2::Write(resDesc, index));
+    EXPECT_TRUE(IndexV2::IsIndexV2(index.data(), index.size()));
+    EXPECT_FALSE(IndexV2::IsIndexV2(buf.data(), buf.size()));
+    std::string path = FormatFullPath("all/assets/entry/resources_v2.index");
+    std::ofstream outFile(path, std::ios::binary | std::ios::out | std::ios::trunc);
+    outFile.write(index.data(), index.size());
+    outFile.close();
+
+    ResConfigImpl *rc = new ResConfigImpl;
+    rc->SetLocaleInfo("zh", nullptr, "CN");
+    const ResConfigImpl *configs[] = { nullptr, rc };
+    for (auto config : configs) {
+        const HapResource *expected = HapResource::LoadFromIndex(FormatFullPath(g_resFilePath).c_str(), config);
+        const HapResource *actual = HapResource::LoadFromIndex(path.c_str(), config);
+        ASSERT_TRUE(expected != nullptr);
+        ASSERT_TRUE(actual != nullptr);
+        std::vector<uint32_t> ids;
+        expected->GetIds(ids);
+        std::vector<uint32_t> actualIds;
+        actual->GetIds(actualIds);
+        EXPECT_EQ(ids, actualIds);
+        for (uint32_t id : ids) {
+            const auto &expectedPaths = expected->GetIdValues(id)->GetLimitPathsConst();
+            const auto &paths = actual->GetIdValues(id)->GetLimitPathsConst();
+            ASSERT_EQ(expectedPaths.size(), paths.size());
+            for (size_t i = 0; i < paths.size(); ++i) {
+                const IdItem *expectedItem = expectedPaths[i]->GetIdItem();
+                const IdItem *idItem = paths[i]->GetIdItem();
+                EXPECT_EQ(expectedPaths[i]->GetFolder(), paths[i]->GetFolder());
+                // size_ is the length of the record in version 1
+                std::shared_ptr<const std::string> expectedHolder;
+                std::shared_ptr<const std::string> holder;
+                EXPECT_EQ(expectedItem->id_, idItem->id_);
+                EXPECT_EQ(expectedItem->resType_, idItem->resType_);
+                EXPECT_EQ(expectedItem->name_, idItem->name_);
+                EXPECT_EQ(expectedPaths[i]->GetValue(expectedHolder), paths[i]->GetValue(holder));
+                EXPECT_EQ(expectedItem->values_, idItem->values_);
+            }
+            const IdItem *idItem = paths[0]->GetIdItem();
+            EXPECT_EQ(expected->GetIdByName(idItem->name_.data(), idItem->resType_),
+                actual->GetIdByName(idItem->name_.data(), idItem->resType_));
+        }
+        EXPECT_EQ(OBJ_NOT_FOUND, actual->GetIdByName("non_existent_name", ResType::STRING));
+        EXPECT_TRUE(actual->GetIdValuesByName(std::string("app_name"), ResType::INTEGER) == nullptr);
+        delete expected;
+        delete actual;
+    }
+    delete rc;
+
+    // the tables out of the buffer are rejected
+    ResDesc truncated;
+    EXPECT_NE(OK, HapParser::ParseResHex(index.data(), index.size() / 2, truncated, nullptr));
+    remove(path.c_str());
+}
+
+/*
+ * @tc.name: HapResourceFuncTest008
+ * @tc.desc: Test ZipArchive::Open function, a zip64 count larger than the central directory is rejected.
+ * @tc.type: FUNC
+ */
+HWTEST_F(HapResourceTest, HapResourceFuncTest008, TestSize.Level1)
+{
+    auto putLe = [](std::string &out, uint64_t value, size_t len) {
+        for (size_t i = 0; i < len; ++i) {
+            out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+        }
+    };
+    // an empty central directory, the zip64 record claims 2^32 entries in it
+    std::string zip;
+    putLe(zip, 0x06064b50, 4); // zip64 end of central directory
+    putLe(zip, 44, 8);
+    putLe(zip, 45, 2);
+    putLe(zip, 45, 2);
+    putLe(zip, 0, 8);
+    putLe(zip, 0x100000000, 8);
+    putLe(zip, 0x100000000, 8);
+    putLe(zip, 0, 8);
+    putLe(zip, 0, 8);
+    putLe(zip, 0x07064b50, 4); // zip64 locator
+    putLe(zip, 0, 4);
+    putLe(zip, 0, 8);
+    putLe(zip, 1, 4);
+    putLe(zip, 0x06054b50, 4); // end of central directory
+    putLe(zip, 0, 4);
+    putLe(zip, 0xFFFF, 2);
+    putLe(zip, 0xFFFF, 2);
+    putLe(zip, 0xFFFFFFFF, 4);
+    putLe(zip, 0xFFFFFFFF, 4);
+    putLe(zip, 0, 2);
+    std::string path = FormatFullPath("zip64_count.hap");
+    std::ofstream outFile(path, std::ios::binary | std::ios::out | std::ios::trunc);
+    outFile.write(zip.data(), zip.size());
+    outFile.close();
+
+    std::string errInfo;
+    EXPECT_TRUE(ZipArchive::Open(path, errInfo) == nullptr);
+    EXPECT_FALSE(errInfo.empty());
+    remove(path.c_str());
+}
+
+/*
+ * @tc.name: HapResourceFuncTest009
+ * @tc.desc: Test ZipArchive::Open function, a stored entry whose sizes differ is rejected.
+ * @tc.type: FUNC
+ */
+HWTEST_F(HapResourceTest, HapResourceFuncTest009, TestSize.Level1)
+{
+    auto putLe = [](std::string &out, uint64_t value, size_t len) {
+        for (size_t i = 0; i < len; ++i) {
+            out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF));
+        }
+    };
+    // a stored entry of 4 bytes which claims 1M bytes uncompressed, the mapping of it would run past the end
+    const std::string name = "a.txt";
+    const uint32_t uncompressedSize = 0x100000;
+    std::string zip;
+    putLe(zip, 0x04034b50, 4); // local file header
+    putLe(zip, 10, 2);
+    putLe(zip, 0, 2);
+    putLe(zip, 0, 2); // stored
+    putLe(zip, 0, 4);
+    putLe(zip, 0, 4);
+    putLe(zip, 4, 4);
+    putLe(zip, uncompressedSize, 4);
+    putLe(zip, name.size(), 2);
+    putLe(zip, 0, 2);
+    zip.append(name).append("data");
+    size_t cdOffset = zip.size();
+    putLe(zip, 0x02014b50, 4); // central directory header
+    putLe(zip, 10, 2);
+    putLe(zip, 10, 2);
+    putLe(zip, 0, 2);
+    putLe(zip, 0, 2); // stored
+    putLe(zip, 0, 4);
+    putLe(zip, 0, 4);
+    putLe(zip, 4, 4);
+    putLe(zip, uncompressedSize, 4);
+    putLe(zip, name.size(), 2);
+    putLe(zip, 0, 2);
+    putLe(zip, 0, 2);
+    putLe(zip, 0, 2);
+    putLe(zip, 0, 2);
+    putLe(zip, 0, 4);
+    putLe(zip, 0, 4);
+    zip.append(name);
+    size_t cdSize = zip.size() - cdOffset;
+    putLe(zip, 0x06054b50, 4); // end of central directory
+    putLe(zip, 0, 4);
+    putLe(zip, 1, 2);
+    putLe(zip, 1, 2);
+    putLe(zip, cdSize, 4);
+    putLe(zip, cdOffset, 4);
+    putLe(zip, 0, 2);
+    std::string path = FormatFullPath("stored_size.hap");
+    std::ofstream outFile(path, std::ios::binary | std::ios::out | std::ios::trunc);
+    outFile.write(zip.data(), zip.size());
+    outFile.close();
+
+    std::string errInfo;
+    EXPECT_TRUE(ZipArchive::Open(path, errInfo) == nullptr);
+    EXPECT_FALSE(errInfo.empty());
+    remove(path.c_str());
+}
+
+/*
+ * @tc.name: HapResourceFuncTest010
+ * @tc.desc: Test ZipArchive::Open function, an archive is closed by its last user and a replaced file is reopened.
+ * @tc.type: FUNC
+ */
+HWTEST_F(HapResourceTest, HapResourceFuncTest010, TestSize.Level1)
+{
+    std::string path = FormatFullPath("shared.hap");
+    auto copy = [](const std::string &from, const std::string &to) {
+        std::ifstream in(from.c_str(), std::ios::binary);
+        std::ofstream out(to.c_str(), std::ios::binary | std::ios::trunc);
+        out << in.rdbuf();
+    };
+    copy(FormatFullPath("stored.hap"), path);
+    std::string errInfo;
+    std::shared_ptr<ZipArchive> archive = ZipArchive::Open(path, errInfo);
+    ASSERT_TRUE(archive != nullptr);
+    EXPECT_EQ(archive, ZipArchive::Open(path, errInfo));
+
+    // the same size in the same second, replaced by a rename
+    std::string tmpPath = path + ".tmp";
+    copy(path, tmpPath);
+    ASSERT_EQ(0, rename(tmpPath.c_str(), path.c_str()));
+    std::shared_ptr<ZipArchive> reopened = ZipArchive::Open(path, errInfo);
+    ASSERT_TRUE(reopened != nullptr);
+    EXPECT_NE(archive, reopened);
+
+    // the registry does not keep the file open
+    int fd = reopened->GetFd();
+    archive = nullptr;
+    reopened = nullptr;
+    EXPECT_EQ(-1, fcntl(fd, F_GETFD));
+    remove(path.c_str());
+}
 }
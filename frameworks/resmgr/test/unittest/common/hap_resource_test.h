@@ -20,5 +20,11 @@ int HapResourceFuncTest001(void);
 int HapResourceFuncTest002(void);
 int HapResourceFuncTest003(void);
 int HapResourceFuncTest004(void);
+int HapResourceFuncTest005(void);
+int HapResourceFuncTest006(void);
+int HapResourceFuncTest007(void);
+int HapResourceFuncTest008(void);
+int HapResourceFuncTest009(void);
+int HapResourceFuncTest010(void);
 
 #endif
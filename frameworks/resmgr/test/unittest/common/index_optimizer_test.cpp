@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2021-2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "index_optimizer_test.h"
+#include <algorithm>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include "index_optimizer.h"
+#include "test_common.h"
+#include "utils/errors.h"
+
+using namespace OHOS::Global::Resource;
+using namespace testing::ext;
+namespace {
+class IndexOptimizerTest : public testing::Test {
+public:
+    static void SetUpTestCase(void);
+
+    static void TearDownTestCase(void);
+
+    void SetUp();
+
+    void TearDown();
+};
+
+void IndexOptimizerTest::SetUpTestCase(void)
+{
+    // step 1: input testsuit setup step
+    g_logLevel = LOG_DEBUG;
+}
+
+void IndexOptimizerTest::TearDownTestCase(void)
+{
+    // step 2: input testsuit teardown step
+}
+
+void IndexOptimizerTest::SetUp()
+{
+    // step 3: input testcase setup step
+}
+
+void IndexOptimizerTest::TearDown()
+{
+    // step 4: input testcase teardown step
+}
+
+/*
+ * @tc.name: IndexOptimizerFuncTest001
+ * @tc.desc: Test IndexOptimizer, the optimized index and the index of a locale resolve the same values.
+ * @tc.type: FUNC
+ */
+HWTEST_F(IndexOptimizerTest, IndexOptimizerFuncTest001, TestSize.Level1)
+{
+    IndexOptimizer optimizer;
+    ASSERT_EQ(OK, optimizer.Load(FormatFullPath(g_resFilePath)));
+    EXPECT_GT(optimizer.PrelinkReferences(), 0u);
+    std::vector<std::string> invalid;
+    optimizer.NormalizeTypedValues(invalid);
+    EXPECT_TRUE(invalid.empty());
+
+    std::string path = FormatFullPath("all/assets/entry/resources_opt.index");
+    ASSERT_EQ(OK, optimizer.Write(path));
+    std::string errInfo;
+    EXPECT_EQ(OK, optimizer.Verify(path, "", errInfo)) << errInfo;
+
+    std::vector<std::string> locales = optimizer.GetLocales();
+    ASSERT_TRUE(std::find(locales.begin(), locales.end(), "zh_CN") != locales.end());
+    std::string localePath = FormatFullPath("all/assets/entry/zh_CN.index");
+    ASSERT_EQ(OK, optimizer.WriteLocale("zh_CN", localePath));
+    EXPECT_EQ(OK, optimizer.Verify(localePath, "zh_CN", errInfo)) << errInfo;
+    // the other locales are not in it
+    EXPECT_NE(OK, optimizer.Verify(localePath, "", errInfo));
+    remove(path.c_str());
+    remove(localePath.c_str());
+}
+}
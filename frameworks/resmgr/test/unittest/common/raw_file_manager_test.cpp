@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "raw_file_manager_test.h"
+
+#include <chrono>
+#include <fstream>
+#include <future>
+#include <gtest/gtest.h>
+#include <memory>
+#include <unistd.h>
+
+#include "raw_file.h"
+#include "raw_file_manager.h"
+#include "resource_manager.h"
+#include "test_common.h"
+
+using namespace OHOS::Global::Resource;
+using namespace testing::ext;
+
+// the same as in raw_file_manager.cpp, it is created from a js object there
+struct NativeResourceManager {
+    std::shared_ptr<ResourceManager> resManager = nullptr;
+};
+
+namespace {
+class RawFileManagerTest : public testing::Test {
+public:
+    static void SetUpTestCase(void);
+
+    static void TearDownTestCase(void);
+
+    void SetUp();
+
+    void TearDown();
+
+    // the content of rawfile/test_rawfile.txt, it is the same in all the haps
+    static std::string ReadExpected();
+
+    // a native resource manager of the hap, it is released by TearDown
+    NativeResourceManager *CreateNativeResourceManager(const char *hap);
+
+protected:
+    std::unique_ptr<NativeResourceManager> mgr_;
+};
+
+// the batch is given to the callback after it is submitted, the callback releases it
+struct BatchReleaser {
+    std::promise<RawFileBatch *> batch;
+    std::promise<long> released;
+};
+
+void ReleaseBatch(RawFileReadRequest *requests, size_t count, void *userData)
+{
+    BatchReleaser *releaser = static_cast<BatchReleaser *>(userData);
+    OH_ResourceManager_ReleaseRawFileBatch(releaser->batch.get_future().get());
+    releaser->released.set_value(requests[0].result);
+}
+
+void RawFileManagerTest::SetUpTestCase(void)
+{
+    // step 1: input testsuit setup step
+    g_logLevel = LOG_DEBUG;
+}
+
+void RawFileManagerTest::TearDownTestCase(void)
+{
+    // step 2: input testsuit teardown step
+}
+
+void RawFileManagerTest::SetUp()
+{
+    // step 3: input testcase setup step
+    HILOG_DEBUG("RawFileManagerTest setup");
+}
+
+void RawFileManagerTest::TearDown()
+{
+    // step 4: input testcase teardown step
+    HILOG_DEBUG("RawFileManagerTest teardown");
+    mgr_ = nullptr;
+}
+
+std::string RawFileManagerTest::ReadExpected()
+{
+    std::ifstream inFile(FormatFullPath("all/assets/entry/resources/rawfile/test_rawfile.txt"), std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(inFile)), std::istreambuf_iterator<char>());
+}
+
+NativeResourceManager *RawFileManagerTest::CreateNativeResourceManager(const char *hap)
+{
+    std::shared_ptr<ResourceManager> resManager(CreateResourceManager());
+    if (resManager == nullptr || !resManager->AddResource(FormatFullPath(hap).c_str())) {
+        return nullptr;
+    }
+    mgr_ = std::make_unique<NativeResourceManager>();
+    mgr_->resManager = resManager;
+    return mgr_.get();
+}
+
+/*
+ * test read a raw file stored in a hap at the given offsets
+ * @tc.name: RawFileManagerReadAtTest001
+ * @tc.desc: Test OH_ResourceManager_ReadRawFileAt function, stored hap case.
+ * @tc.type: FUNC
+ */
+HWTEST_F(RawFileManagerTest, RawFileManagerReadAtTest001, TestSize.Level1)
+{
+    std::string expected = ReadExpected();
+    ASSERT_GT(expected.size(), 4u);
+    NativeResourceManager *mgr = CreateNativeResourceManager("stored.hap");
+    ASSERT_TRUE(mgr != nullptr);
+    RawFile *rawFile = OH_ResourceManager_OpenRawFile(mgr, "test_rawfile.txt");
+    ASSERT_TRUE(rawFile != nullptr);
+    ASSERT_EQ(static_cast<long>(expected.size()), OH_ResourceManager_GetRawFileSize(rawFile));
+
+    // the raw file is a range of the hap, the offsets are relative to its start
+    RawFileDescriptor descriptor;
+    ASSERT_TRUE(OH_ResourceManager_GetRawFileDescriptor(rawFile, descriptor));
+    EXPECT_GT(descriptor.start, 0);
+    EXPECT_TRUE(OH_ResourceManager_ReleaseRawFileDescriptor(descriptor));
+
+    std::string data(expected.size() + 4, '\0');
+    EXPECT_EQ(static_cast<long>(expected.size()), OH_ResourceManager_ReadRawFileAt(rawFile, &data[0], data.size(), 0));
+    EXPECT_EQ(expected, data.substr(0, expected.size()));
+    EXPECT_EQ(3, OH_ResourceManager_ReadRawFileAt(rawFile, &data[0], 3, 4));
+    EXPECT_EQ(expected.substr(4, 3), data.substr(0, 3));
+    // the end of the raw file is not the end of the hap
+    EXPECT_EQ(2, OH_ResourceManager_ReadRawFileAt(rawFile, &data[0], data.size(), expected.size() - 2));
+    EXPECT_EQ(expected.substr(expected.size() - 2), data.substr(0, 2));
+    EXPECT_EQ(0, OH_ResourceManager_ReadRawFileAt(rawFile, &data[0], data.size(), expected.size()));
+    EXPECT_EQ(-1, OH_ResourceManager_ReadRawFileAt(rawFile, &data[0], data.size(), -1));
+    EXPECT_EQ(-1, OH_ResourceManager_ReadRawFileAt(rawFile, nullptr, data.size(), 0));
+
+    // the current offset is not used nor moved
+    char head[2] = {0};
+    ASSERT_EQ(2, OH_ResourceManager_ReadRawFile(rawFile, head, sizeof(head)));
+    EXPECT_EQ(3, OH_ResourceManager_ReadRawFileAt(rawFile, &data[0], 3, 0));
+    EXPECT_EQ(2, OH_ResourceManager_GetRawFileOffset(rawFile));
+    ASSERT_EQ(2, OH_ResourceManager_ReadRawFile(rawFile, head, sizeof(head)));
+    EXPECT_EQ(expected.substr(2, 2), std::string(head, sizeof(head)));
+
+    EXPECT_TRUE(OH_ResourceManager_AdviseRawFile(rawFile, RAWFILE_ADVICE_SEQUENTIAL));
+    EXPECT_FALSE(OH_ResourceManager_AdviseRawFile(rawFile, RAWFILE_ADVICE_DONTNEED + 1));
+    EXPECT_FALSE(OH_ResourceManager_AdviseRawFile(rawFile, -1));
+    OH_ResourceManager_CloseRawFile(rawFile);
+}
+
+/*
+ * test read a raw file compressed in a hap at the given offsets
+ * @tc.name: RawFileManagerReadAtTest002
+ * @tc.desc: Test OH_ResourceManager_ReadRawFileAt function, deflated hap case.
+ * @tc.type: FUNC
+ */
+HWTEST_F(RawFileManagerTest, RawFileManagerReadAtTest002, TestSize.Level1)
+{
+    std::string expected = ReadExpected();
+    ASSERT_GT(expected.size(), 4u);
+    NativeResourceManager *mgr = CreateNativeResourceManager("all.hap");
+    ASSERT_TRUE(mgr != nullptr);
+    RawFile *rawFile = OH_ResourceManager_OpenRawFile(mgr, "test_rawfile.txt");
+    ASSERT_TRUE(rawFile != nullptr);
+
+    // it is inflated, the offsets are in the uncompressed content
+    std::string data(expected.size(), '\0');
+    EXPECT_EQ(3, OH_ResourceManager_ReadRawFileAt(rawFile, &data[0], 3, 4));
+    EXPECT_EQ(expected.substr(4, 3), data.substr(0, 3));
+    EXPECT_EQ(static_cast<long>(expected.size()), OH_ResourceManager_ReadRawFileAt(rawFile, &data[0], data.size(), 0));
+    EXPECT_EQ(expected, data);
+    EXPECT_EQ(0, OH_ResourceManager_ReadRawFileAt(rawFile, &data[0], data.size(), expected.size()));
+    EXPECT_EQ(0, OH_ResourceManager_GetRawFileOffset(rawFile));
+
+    // there is no range of the hap to advise on
+    EXPECT_FALSE(OH_ResourceManager_AdviseRawFile(rawFile, RAWFILE_ADVICE_SEQUENTIAL));
+    OH_ResourceManager_CloseRawFile(rawFile);
+}
+
+/*
+ * test map a raw file stored in a hap, the mapping outlives the raw file
+ * @tc.name: RawFileManagerMapTest001
+ * @tc.desc: Test OH_ResourceManager_MapRawFile and OH_ResourceManager_UnmapRawFile function, stored hap case.
+ * @tc.type: FUNC
+ */
+HWTEST_F(RawFileManagerTest, RawFileManagerMapTest001, TestSize.Level1)
+{
+    std::string expected = ReadExpected();
+    const char *haps[] = { "stored.hap", "deflated.hap" };
+    for (const char *hap : haps) {
+        NativeResourceManager *mgr = CreateNativeResourceManager(hap);
+        ASSERT_TRUE(mgr != nullptr);
+        RawFile *rawFile = OH_ResourceManager_OpenRawFile(mgr, "test_rawfile.txt");
+        ASSERT_TRUE(rawFile != nullptr);
+        long length = -1;
+        const void *data = OH_ResourceManager_MapRawFile(rawFile, &length);
+        ASSERT_TRUE(data != nullptr);
+        OH_ResourceManager_CloseRawFile(rawFile);
+
+        // the entry does not start at a page boundary of the hap
+        long pageSize = sysconf(_SC_PAGESIZE);
+        EXPECT_NE(0u, reinterpret_cast<uintptr_t>(data) % pageSize);
+        ASSERT_EQ(static_cast<long>(expected.size()), length);
+        EXPECT_EQ(expected, std::string(static_cast<const char *>(data), length));
+        EXPECT_TRUE(OH_ResourceManager_AdviseMappedRawFile(data, length, RAWFILE_ADVICE_WILLNEED));
+        EXPECT_FALSE(OH_ResourceManager_AdviseMappedRawFile(data, length, RAWFILE_ADVICE_DONTNEED + 1));
+        EXPECT_TRUE(OH_ResourceManager_UnmapRawFile(data, length));
+    }
+    EXPECT_FALSE(OH_ResourceManager_UnmapRawFile(nullptr, 1));
+    EXPECT_FALSE(OH_ResourceManager_AdviseMappedRawFile(nullptr, 1, RAWFILE_ADVICE_NORMAL));
+}
+
+/*
+ * test map a raw file compressed in a hap, it is rejected
+ * @tc.name: RawFileManagerMapTest002
+ * @tc.desc: Test OH_ResourceManager_MapRawFile function, deflated hap case.
+ * @tc.type: FUNC
+ */
+HWTEST_F(RawFileManagerTest, RawFileManagerMapTest002, TestSize.Level1)
+{
+    NativeResourceManager *mgr = CreateNativeResourceManager("deflated.hap");
+    ASSERT_TRUE(mgr != nullptr);
+    RawFile *rawFile = OH_ResourceManager_OpenRawFile(mgr, "large.txt");
+    ASSERT_TRUE(rawFile != nullptr);
+    EXPECT_GT(OH_ResourceManager_GetRawFileSize(rawFile), 0);
+    long length = -1;
+    EXPECT_TRUE(OH_ResourceManager_MapRawFile(rawFile, &length) == nullptr);
+    EXPECT_EQ(0, length);
+    EXPECT_TRUE(OH_ResourceManager_MapRawFile(rawFile, nullptr) == nullptr);
+    RawFileDescriptor descriptor;
+    EXPECT_FALSE(OH_ResourceManager_GetRawFileDescriptor(rawFile, descriptor));
+    OH_ResourceManager_CloseRawFile(rawFile);
+}
+
+/*
+ * test release a batch from its callback
+ * @tc.name: RawFileManagerBatchTest001
+ * @tc.desc: Test OH_ResourceManager_SubmitRawFileBatch and OH_ResourceManager_ReleaseRawFileBatch function.
+ * @tc.type: FUNC
+ */
+HWTEST_F(RawFileManagerTest, RawFileManagerBatchTest001, TestSize.Level1)
+{
+    std::string expected = ReadExpected();
+    NativeResourceManager *mgr = CreateNativeResourceManager("stored.hap");
+    ASSERT_TRUE(mgr != nullptr);
+    std::string data(expected.size(), '\0');
+    RawFileReadRequest request = { "test_rawfile.txt", 0, data.size(), &data[0], 0 };
+    BatchReleaser releaser;
+    std::future<long> released = releaser.released.get_future();
+    RawFileBatch *batch = OH_ResourceManager_SubmitRawFileBatch(mgr, &request, 1, ReleaseBatch, &releaser);
+    ASSERT_TRUE(batch != nullptr);
+    releaser.batch.set_value(batch);
+
+    // the batch is done before the callback is called, the release does not wait for the callback
+    ASSERT_EQ(std::future_status::ready, released.wait_for(std::chrono::seconds(5)));
+    EXPECT_EQ(static_cast<long>(expected.size()), released.get());
+    EXPECT_EQ(expected, data);
+}
+}
@@ -15,17 +15,29 @@
 
 #include "resource_manager_test.h"
 
+#include <algorithm>
+#include <chrono>
 #include <climits>
 #include <cstring>
+#include <fstream>
+#include <future>
 #include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
 #define private public
 
+#include "auto_mutex.h"
 #include "res_config.h"
 #include "resource_manager.h"
 #include "resource_manager_impl.h"
 #include "test_common.h"
 #include "utils/errors.h"
+#include "utils/mapped_file.h"
+#include "utils/raw_file_descriptor_cache.h"
+#include "utils/startup_profile.h"
 #include "utils/string_utils.h"
+#include "utils/zip_entry_reader.h"
 
 using namespace OHOS::Global::Resource;
 using namespace testing::ext;
@@ -243,6 +255,523 @@ HWTEST_F(ResourceManagerTest, ResourceManagerAddResourceTest003, TestSize.Level1
     ASSERT_TRUE(!ret);
 }
 
+/*
+ * @tc.name: ResourceManagerAddResourceTest004
+ * @tc.desc: Test AddResourceAsync function, file case.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ResourceManagerTest, ResourceManagerAddResourceTest004, TestSize.Level1)
+{
+    std::future<bool> result = rm->AddResourceAsync(FormatFullPath(g_resFilePath));
+    ASSERT_TRUE(result.get());
+    TestStringByName("app_name", "App Name");
+
+    // reload the same path, the callback gets the result
+    std::promise<bool> promise;
+    rm->AddResourceAsync(FormatFullPath(g_resFilePath), [&promise](bool ret) { promise.set_value(ret); });
+    ASSERT_FALSE(promise.get_future().get());
+}
+
+/*
+ * @tc.name: ResourceManagerAddResourceTest005
+ * @tc.desc: Test AddResource function, the managers share the resources of the same file and locale.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ResourceManagerTest, ResourceManagerAddResourceTest005, TestSize.Level1)
+{
+    size_t count = HapResource::GetSharedCount();
+    ASSERT_TRUE(rm->AddResource(FormatFullPath(g_resFilePath).c_str()));
+    EXPECT_EQ(count + 1, HapResource::GetSharedCount());
+
+    ResourceManager *other = CreateResourceManager();
+    ASSERT_TRUE(other != nullptr);
+    ASSERT_TRUE(other->AddResource(FormatFullPath(g_resFilePath).c_str()));
+    EXPECT_EQ(count + 1, HapResource::GetSharedCount());
+
+    // another locale is parsed again
+    auto rc = CreateResConfig();
+    ASSERT_TRUE(rc != nullptr);
+    rc->SetLocaleInfo("zh", nullptr, "CN");
+    EXPECT_EQ(SUCCESS, other->UpdateResConfig(*rc));
+    delete rc;
+    EXPECT_EQ(count + 2, HapResource::GetSharedCount());
+    std::string outValue;
+    EXPECT_EQ(SUCCESS, other->GetStringByName("app_name", outValue));
+    EXPECT_EQ("应用名称", outValue);
+
+    // the resources are released with the last manager holding them
+    delete other;
+    EXPECT_EQ(count + 1, HapResource::GetSharedCount());
+    TestStringByName("app_name", "App Name");
+
+    // a file replaced by another one of the same size is loaded again, the config of a manager is not kept
+    std::ifstream inFile(FormatFullPath(g_resFilePath), std::ios::binary);
+    std::string index((std::istreambuf_iterator<char>(inFile)), std::istreambuf_iterator<char>());
+    std::string path = FormatFullPath("all/assets/entry/resources_shared.index");
+    std::string tmpPath = path + ".tmp";
+    std::ofstream(path, std::ios::binary | std::ios::trunc).write(index.data(), index.size());
+    const HapResource *first = HapResource::Acquire(path.c_str(), nullptr);
+    ASSERT_TRUE(first != nullptr);
+    EXPECT_TRUE(first->defaultConfig_ == nullptr);
+    const HapResource *shared = HapResource::Acquire(path.c_str(), nullptr);
+    EXPECT_EQ(first, shared);
+    HapResource::Release(shared);
+    std::ofstream(tmpPath, std::ios::binary | std::ios::trunc).write(index.data(), index.size());
+    ASSERT_EQ(0, rename(tmpPath.c_str(), path.c_str()));
+    const HapResource *replaced = HapResource::Acquire(path.c_str(), nullptr);
+    EXPECT_NE(first, replaced);
+    HapResource::Release(replaced);
+    HapResource::Release(first);
+    remove(path.c_str());
+}
+
+/*
+ * @tc.name: ResourceManagerAddResourceTest006
+ * @tc.desc: Test AddResource function with overlays, the target is shared and parsed once.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ResourceManagerTest, ResourceManagerAddResourceTest006, TestSize.Level1)
+{
+    ASSERT_TRUE(rm->AddResource(FormatFullPath(g_resFilePath).c_str()));
+    size_t count = HapResource::GetSharedCount();
+
+    ResourceManagerImpl *other = static_cast<ResourceManagerImpl *>(CreateResourceManager());
+    ASSERT_TRUE(other != nullptr);
+    std::vector<std::string> overlayPaths;
+    overlayPaths.push_back(FormatFullPath("colormode/assets/entry/resources.index"));
+    ASSERT_TRUE(other->AddResource(FormatFullPath(g_resFilePath), overlayPaths));
+    // the overlay is not shared, the target is the one already loaded
+    EXPECT_EQ(count, HapResource::GetSharedCount());
+
+    // the overlay value of the same name is found by the id of the target
+    int id = GetResId("mainability_description", ResType::STRING);
+    ASSERT_TRUE(id > 0);
+    std::string outValue;
+    EXPECT_EQ(SUCCESS, other->GetStringById(id, outValue));
+    EXPECT_EQ("JS_Empty Ability", outValue);
+    EXPECT_EQ(SUCCESS, other->GetStringByName("mainability_description", outValue));
+    EXPECT_EQ("JS_Empty Ability", outValue);
+    delete other;
+    EXPECT_EQ(count, HapResource::GetSharedCount());
+}
+
+/*
+ * @tc.name: ResourceManagerAddOverlayTest001
+ * @tc.desc: Test AddOverlay and RemoveOverlay function
+ * @tc.type: FUNC
+ */
+HWTEST_F(ResourceManagerTest, ResourceManagerAddOverlayTest001, TestSize.Level1)
+{
+    ResourceManagerImpl *impl = static_cast<ResourceManagerImpl *>(rm);
+    std::string path = FormatFullPath(g_resFilePath);
+    std::string overlayPath = FormatFullPath("colormode/assets/entry/resources.index");
+    EXPECT_FALSE(impl->AddOverlay(path, overlayPath));
+    ASSERT_TRUE(rm->AddResource(path.c_str()));
+    int id = GetResId("mainability_description", ResType::STRING);
+    ASSERT_TRUE(id > 0);
+    std::string outValue;
+    EXPECT_EQ(SUCCESS, rm->GetStringById(id, outValue));
+    std::string targetValue = outValue;
+
+    // the overlay is mapped to the target in use, the target is not loaded again
+    size_t count = HapResource::GetSharedCount();
+    std::shared_ptr<const HapManager::Resources> resources = impl->hapManager_->GetResources();
+    ASSERT_TRUE(impl->AddOverlay(path, overlayPath));
+    EXPECT_EQ(count, HapResource::GetSharedCount());
+    std::shared_ptr<const HapManager::Resources> added = impl->hapManager_->GetResources();
+    ASSERT_EQ(resources->size() + 1, added->size());
+    EXPECT_EQ(resources->back(), (*added)[added->size() - 2]);
+    EXPECT_EQ(overlayPath, added->back()->GetIndexPath());
+    EXPECT_FALSE(impl->AddOverlay(path, overlayPath));
+    // the overlays are matched by their canonical paths
+    std::string aliasPath = FormatFullPath("colormode/../colormode/assets/entry/resources.index");
+    EXPECT_FALSE(impl->AddOverlay(path, aliasPath));
+    EXPECT_EQ(SUCCESS, rm->GetStringById(id, outValue));
+    EXPECT_EQ("JS_Empty Ability", outValue);
+    // the other ids are not changed
+    TestStringByName("app_name", "App Name");
+
+    // the overlay is kept by the reload
+    auto rc = CreateResConfig();
+    ASSERT_TRUE(rc != nullptr);
+    rc->SetLocaleInfo("en", nullptr, "US");
+    EXPECT_EQ(SUCCESS, rm->UpdateResConfig(*rc));
+    delete rc;
+    EXPECT_EQ(SUCCESS, rm->GetStringById(id, outValue));
+    EXPECT_EQ("JS_Empty Ability", outValue);
+
+    ASSERT_TRUE(impl->RemoveOverlay(path, aliasPath));
+    EXPECT_FALSE(impl->RemoveOverlay(path, overlayPath));
+    EXPECT_EQ(added->size() - 1, impl->hapManager_->GetResources()->size());
+    EXPECT_EQ(SUCCESS, rm->GetStringById(id, outValue));
+    EXPECT_EQ(targetValue, outValue);
+}
+
+/*
+ * @tc.name: ResourceManagerReloadChangedTest001
+ * @tc.desc: Test ReloadChanged and SetAutoReload function, the changed index file is reloaded
+ * @tc.type: FUNC
+ */
+HWTEST_F(ResourceManagerTest, ResourceManagerReloadChangedTest001, TestSize.Level1)
+{
+    ResourceManagerImpl *impl = static_cast<ResourceManagerImpl *>(rm);
+    const std::string path = FormatFullPath("reload.index");
+    {
+        std::ifstream in(FormatFullPath(g_resFilePath).c_str(), std::ios::binary);
+        std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+        out << in.rdbuf();
+    }
+    ASSERT_TRUE(rm->AddResource(path.c_str()));
+    EXPECT_FALSE(impl->ReloadChanged());
+    std::string outValue;
+    EXPECT_EQ(SUCCESS, rm->GetStringByName("mainability_description", outValue));
+    EXPECT_EQ("Java_Phone_About Feature Ability", outValue);
+
+    {
+        std::ifstream in(FormatFullPath("colormode/assets/entry/resources.index").c_str(), std::ios::binary);
+        std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+        out << in.rdbuf();
+    }
+    // the lookup finds the change with the auto reload
+    impl->SetAutoReload(true);
+    EXPECT_EQ(SUCCESS, rm->GetStringByName("mainability_description", outValue));
+    EXPECT_EQ("JS_Empty Ability", outValue);
+    EXPECT_FALSE(impl->ReloadChanged());
+    unlink(path.c_str());
+}
+
+/*
+ * @tc.name: ResourceManagerReloadChangedTest002
+ * @tc.desc: Test SetAutoReload function, a lookup does not wait for an update in progress
+ * @tc.type: FUNC
+ */
+HWTEST_F(ResourceManagerTest, ResourceManagerReloadChangedTest002, TestSize.Level1)
+{
+    ResourceManagerImpl *impl = static_cast<ResourceManagerImpl *>(rm);
+    const std::string path = FormatFullPath("reload.index");
+    {
+        std::ifstream in(FormatFullPath(g_resFilePath).c_str(), std::ios::binary);
+        std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+        out << in.rdbuf();
+    }
+    ASSERT_TRUE(rm->AddResource(path.c_str()));
+    {
+        std::ifstream in(FormatFullPath("colormode/assets/entry/resources.index").c_str(), std::ios::binary);
+        std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+        out << in.rdbuf();
+    }
+    impl->SetAutoReload(true);
+
+    // another thread holds the update lock, the lookup gets the loaded value
+    std::promise<void> locked;
+    std::promise<void> done;
+    std::thread updater([impl, &locked, &done] {
+        impl->hapManager_->updateLock_.lock();
+        locked.set_value();
+        done.get_future().wait();
+        impl->hapManager_->updateLock_.unlock();
+    });
+    locked.get_future().wait();
+    impl->hapManager_->lastCheckTime_ = 0;
+    std::string outValue;
+    EXPECT_EQ(SUCCESS, rm->GetStringByName("mainability_description", outValue));
+    EXPECT_EQ("Java_Phone_About Feature Ability", outValue);
+    done.set_value();
+    updater.join();
+
+    // the next lookup checks again
+    EXPECT_EQ(SUCCESS, rm->GetStringByName("mainability_description", outValue));
+    EXPECT_EQ("JS_Empty Ability", outValue);
+    unlink(path.c_str());
+}
+
+/*
+ * @tc.name: ResourceManagerReloadChangedTest003
+ * @tc.desc: Test ReloadChanged function, the values cached before a rewrite of the same size are read after it
+ * @tc.type: FUNC
+ */
+HWTEST_F(ResourceManagerTest, ResourceManagerReloadChangedTest003, TestSize.Level1)
+{
+    ResourceManagerImpl *impl = static_cast<ResourceManagerImpl *>(rm);
+    const std::string path = FormatFullPath("reload.index");
+    auto copy = [&path]() {
+        std::ifstream in(FormatFullPath(g_resFilePath).c_str(), std::ios::binary);
+        std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+        out << in.rdbuf();
+    };
+    copy();
+    ASSERT_TRUE(rm->AddResource(path.c_str()));
+    std::vector<uint32_t> ids;
+    impl->hapManager_->GetResources()->front()->GetIds(ids);
+    ASSERT_FALSE(ids.empty());
+    std::map<uint32_t, std::string> values;
+    for (uint32_t id : ids) {
+        std::string outValue;
+        if (rm->GetStringById(id, outValue) == SUCCESS) {
+            values[id] = outValue;
+        }
+    }
+    ASSERT_FALSE(values.empty());
+
+    // the same content in the same second, the file is rewritten in place after the mod time moves on
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    copy();
+    ASSERT_TRUE(impl->ReloadChanged());
+    for (auto iter = values.begin(); iter != values.end(); ++iter) {
+        std::string outValue;
+        EXPECT_EQ(SUCCESS, rm->GetStringById(iter->first, outValue));
+        EXPECT_EQ(iter->second, outValue);
+    }
+    EXPECT_FALSE(impl->ReloadChanged());
+    unlink(path.c_str());
+}
+
+/*
+ * @tc.name: ResourceManagerGetMemoryUsageTest001
+ * @tc.desc: Test GetMemoryUsage function
+ * @tc.type: FUNC
+ */
+HWTEST_F(ResourceManagerTest, ResourceManagerGetMemoryUsageTest001, TestSize.Level1)
+{
+    ResourceManagerImpl *impl = static_cast<ResourceManagerImpl *>(rm);
+    MemoryReport empty;
+    impl->GetMemoryUsage(empty);
+    EXPECT_EQ(0u, empty.resources.size());
+
+    ASSERT_TRUE(rm->AddResource(FormatFullPath(g_resFilePath).c_str()));
+    MemoryReport report;
+    impl->GetMemoryUsage(report);
+    ASSERT_EQ(1u, report.resources.size());
+    EXPECT_EQ(FormatFullPath(g_resFilePath), report.resources[0].first);
+    const MemoryUsage &usage = report.resources[0].second;
+    EXPECT_GT(usage.resDesc, 0u);
+    EXPECT_GT(usage.idItems, 0u);
+    EXPECT_GT(usage.values, 0u);
+    EXPECT_GT(usage.configs, 0u);
+    EXPECT_GT(usage.maps, 0u);
+    EXPECT_EQ(usage.values, report.total.values);
+    EXPECT_GE(report.total.Total(), usage.Total());
+
+    // the resolved values and the raw file index are counted once they are there
+    TestStringByName("app_name", "App Name");
+    int id = GetResId("app_name", ResType::STRING);
+    std::string outValue;
+    EXPECT_EQ(SUCCESS, rm->GetStringById(id, outValue));
+    std::vector<std::string> names;
+    EXPECT_EQ(SUCCESS, impl->GetRawFileList("", false, names));
+    MemoryReport later;
+    impl->GetMemoryUsage(later);
+    EXPECT_GT(later.total.valueCache, 0u);
+    EXPECT_GT(later.total.rawFileIndex, 0u);
+    EXPECT_EQ(usage.idItems, later.total.idItems);
+}
+
+/*
+ * @tc.name: ResourceManagerTrimTest001
+ * @tc.desc: Test Trim function, the caches are released and the resources held by a reader are kept
+ * @tc.type: FUNC
+ */
+HWTEST_F(ResourceManagerTest, ResourceManagerTrimTest001, TestSize.Level1)
+{
+    ResourceManagerImpl *impl = static_cast<ResourceManagerImpl *>(rm);
+    size_t count = HapResource::GetSharedCount();
+    ASSERT_TRUE(rm->AddResource(FormatFullPath(g_resFilePath).c_str()));
+    std::shared_ptr<const HapManager::Resources> held = impl->hapManager_->GetResources();
+    auto rc = CreateResConfig();
+    ASSERT_TRUE(rc != nullptr);
+    rc->SetLocaleInfo("zh", nullptr, "CN");
+    EXPECT_EQ(SUCCESS, rm->UpdateResConfig(*rc));
+    delete rc;
+    // the resources of the last locale are kept while a reader holds them
+    EXPECT_EQ(count + 2, HapResource::GetSharedCount());
+    int id = GetResId("app_name", ResType::STRING);
+    std::string outValue;
+    EXPECT_EQ(SUCCESS, rm->GetStringById(id, outValue));
+    MemoryReport before;
+    impl->GetMemoryUsage(before);
+
+    impl->Trim(TRIM_CACHES);
+    MemoryReport after;
+    impl->GetMemoryUsage(after);
+    EXPECT_LT(after.total.valueCache, before.total.valueCache);
+    EXPECT_EQ(count + 2, HapResource::GetSharedCount());
+    EXPECT_EQ(SUCCESS, rm->GetStringById(id, outValue));
+    EXPECT_EQ("应用名称", outValue);
+
+    impl->Trim(TRIM_ALL);
+    EXPECT_EQ(count + 2, HapResource::GetSharedCount());
+    held = nullptr;
+    EXPECT_EQ(count + 1, HapResource::GetSharedCount());
+    EXPECT_EQ(SUCCESS, rm->GetStringById(id, outValue));
+    EXPECT_EQ("应用名称", outValue);
+}
+
+/*
+ * @tc.name: ResourceManagerLongStringTest001
+ * @tc.desc: Test SetLongStringThreshold function, the long strings are kept compressed and read the same
+ * @tc.type: FUNC
+ */
+HWTEST_F(ResourceManagerTest, ResourceManagerLongStringTest001, TestSize.Level1)
+{
+    std::string path = FormatFullPath(g_resFilePath);
+    const HapResource *plain = HapResource::LoadFromIndex(path.c_str(), nullptr);
+    ASSERT_TRUE(plain != nullptr);
+    HapResource::SetLongStringThreshold(16);
+    const HapResource *compressed = HapResource::LoadFromIndex(path.c_str(), nullptr);
+    ASSERT_TRUE(compressed != nullptr);
+    std::vector<uint32_t> ids;
+    plain->GetIds(ids);
+    size_t compressedCount = 0;
+    for (uint32_t id : ids) {
+        const std::vector<HapResource::ValueUnderQualifierDir *> &plainPaths =
+            plain->GetIdValues(id)->GetLimitPathsConst();
+        const std::vector<HapResource::ValueUnderQualifierDir *> &paths =
+            compressed->GetIdValues(id)->GetLimitPathsConst();
+        ASSERT_EQ(plainPaths.size(), paths.size());
+        for (size_t i = 0; i < paths.size(); ++i) {
+            const IdItem *idItem = paths[i]->GetIdItem();
+            std::shared_ptr<const std::string> plainHolder;
+            std::shared_ptr<const std::string> holder;
+            EXPECT_EQ(plainPaths[i]->GetValue(plainHolder), paths[i]->GetValue(holder));
+            EXPECT_EQ(plainPaths[i]->GetIdItem()->values_, idItem->values_);
+            if (idItem->isCompressed_) {
+                compressedCount++;
+                EXPECT_EQ(ResType::STRING, idItem->resType_);
+                EXPECT_LT(idItem->value_.size(), idItem->valueLen_);
+                // the value is inflated by the store of its index only
+                std::shared_ptr<const std::string> noStoreHolder;
+                EXPECT_TRUE(idItem->GetValue(nullptr, noStoreHolder).empty());
+            }
+        }
+    }
+    EXPECT_GT(compressedCount, 0u);
+    HapResource::Release(compressed);
+    HapResource::Release(plain);
+
+    // the reference is compressed, the strings short in the test index hardly get smaller
+    ResourceManagerImpl *impl = static_cast<ResourceManagerImpl *>(rm);
+    AddResource("en", nullptr, nullptr);
+    HapResource::SetLongStringThreshold(0);
+    MemoryReport before;
+    impl->GetMemoryUsage(before);
+    TestStringByName("string_ref", "XXXXXX All rights reserved. ©2011-2019");
+    MemoryReport report;
+    impl->GetMemoryUsage(report);
+    EXPECT_GT(report.total.valueCache, before.total.valueCache);
+
+    impl->Trim(TRIM_CACHES);
+    MemoryReport trimmed;
+    impl->GetMemoryUsage(trimmed);
+    EXPECT_LT(trimmed.total.valueCache, report.total.valueCache);
+    TestStringByName("string_ref", "XXXXXX All rights reserved. ©2011-2019");
+}
+
+/*
+ * @tc.name: ResourceManagerStartupProfileTest001
+ * @tc.desc: Test StartStartupProfile function, the lookups recorded by a start are replayed by the next one
+ * @tc.type: FUNC
+ */
+HWTEST_F(ResourceManagerTest, ResourceManagerStartupProfileTest001, TestSize.Level1)
+{
+    std::string path = FormatFullPath("all/assets/entry/startup.profile");
+    remove(path.c_str());
+    AddResource("en", nullptr, nullptr);
+    ResourceManagerImpl *impl = static_cast<ResourceManagerImpl *>(rm);
+    ASSERT_TRUE(impl->StartStartupProfile(path, 60000));
+    EXPECT_FALSE(impl->StartStartupProfile(path, 60000));
+    TestStringByName("string_ref", "XXXXXX All rights reserved. ©2011-2019");
+    int id = GetResId("app_name", ResType::STRING);
+    ASSERT_GT(id, 0);
+    std::string outValue;
+    EXPECT_EQ(SUCCESS, rm->GetStringById(id, outValue));
+    ResourceManager::RawFileDescriptor descriptor;
+    ASSERT_EQ(SUCCESS, rm->GetRawFileDescriptor("test_rawfile.txt", descriptor));
+    EXPECT_EQ(SUCCESS, rm->CloseRawFileDescriptor("test_rawfile.txt"));
+    // the manager saves what is recorded so far when it is destroyed
+    delete rm;
+    rm = CreateResourceManager();
+    ASSERT_TRUE(rm != nullptr);
+
+    std::vector<StartupProfile::Entry> entries;
+    ASSERT_EQ(OK, StartupProfile::Load(path, entries));
+    auto find = [&entries](StartupProfile::EntryType type, uint32_t entryId, const std::string &name) {
+        return std::find_if(entries.begin(), entries.end(), [&](const StartupProfile::Entry &entry) {
+            return entry.type == type && entry.id == entryId && entry.name == name;
+        }) != entries.end();
+    };
+    EXPECT_TRUE(find(StartupProfile::NAME, 0, "string_ref"));
+    EXPECT_TRUE(find(StartupProfile::ID, static_cast<uint32_t>(id), ""));
+    EXPECT_TRUE(find(StartupProfile::RAW_FILE, 0, "test_rawfile.txt"));
+
+    // the next start resolves the ids into the cache and opens the raw files on a worker thread
+    AddResource("en", nullptr, nullptr);
+    impl = static_cast<ResourceManagerImpl *>(rm);
+    ASSERT_TRUE(impl->StartStartupProfile(path, 0));
+    RawFileDescriptorCache::Descriptor cached;
+    bool replayed = false;
+    for (int i = 0; i < 200 && !replayed; ++i) {
+        replayed = impl->rawFileDescriptors_.Acquire("test_rawfile.txt", cached);
+        if (!replayed) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    ASSERT_TRUE(replayed);
+    impl->rawFileDescriptors_.Release("test_rawfile.txt");
+    {
+        AutoMutex mutex(impl->hapManager_->lock_);
+        EXPECT_EQ(1u, impl->hapManager_->idValueCache_.count(static_cast<uint32_t>(id)));
+    }
+    // wait for the profile of this start to be saved
+    delete rm;
+    rm = CreateResourceManager();
+    remove(path.c_str());
+}
+
+/*
+ * @tc.name: ResourceManagerStartupProfileTest002
+ * @tc.desc: Test StartStartupProfile function, no worker thread waits for the window, the first lookup after it saves
+ * @tc.type: FUNC
+ */
+HWTEST_F(ResourceManagerTest, ResourceManagerStartupProfileTest002, TestSize.Level1)
+{
+    std::string path = FormatFullPath("all/assets/entry/startup.profile");
+    remove(path.c_str());
+    AddResource("en", nullptr, nullptr);
+    ResourceManagerImpl *impl = static_cast<ResourceManagerImpl *>(rm);
+    const uint32_t durationMs = 200;
+    ASSERT_TRUE(impl->StartStartupProfile(path, durationMs));
+    TestStringByName("app_name", "App Name");
+    // the replay of the missing profile is the only task, it ends before the window
+    bool idle = false;
+    for (int i = 0; i < 200 && !idle; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(impl->pendingMutex_);
+            idle = (impl->pendingTasks_ == 0);
+        }
+        if (!idle) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    EXPECT_TRUE(idle);
+    std::vector<StartupProfile::Entry> entries;
+    EXPECT_NE(OK, StartupProfile::Load(path, entries));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(durationMs));
+    TestStringByName("app_name", "App Name");
+    bool saved = false;
+    for (int i = 0; i < 200 && !saved; ++i) {
+        saved = (StartupProfile::Load(path, entries) == OK);
+        if (!saved) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    ASSERT_TRUE(saved);
+    ASSERT_EQ(1u, entries.size());
+    EXPECT_EQ(StartupProfile::NAME, entries[0].type);
+    EXPECT_EQ("app_name", entries[0].name);
+    remove(path.c_str());
+}
+
 /*
  * @tc.name: ResourceManagerUpdateResConfigTest001
  * @tc.desc: Test UpdateResConfig function
@@ -352,8 +881,11 @@ HWTEST_F(ResourceManagerTest, ResourceManagerUpdateResConfigTest005, TestSize.Le
 
     // make a fake hapResource, then reload will fail
     HapResource *hapResource = new HapResource("/data/test/non_exist", 0, nullptr, nullptr);
-    ((ResourceManagerImpl *)rm)->hapManager_->hapResources_.push_back(hapResource);
-    ((ResourceManagerImpl *)rm)->hapManager_->loadedHapPaths_["/data/test/non_exist"] = std::vector<std::string>();
+    HapManager *hapManager = ((ResourceManagerImpl *)rm)->hapManager_;
+    HapManager::Resources resources(*hapManager->hapResources_);
+    resources.push_back(std::shared_ptr<const HapResource>(hapResource, HapResource::Release));
+    hapManager->hapResources_ = std::make_shared<const HapManager::Resources>(resources);
+    hapManager->loadedHapPaths_["/data/test/non_exist"] = std::vector<std::string>();
     RState state;
     ResConfig *rc = CreateResConfig();
     if (rc == nullptr) {
@@ -366,6 +898,102 @@ HWTEST_F(ResourceManagerTest, ResourceManagerUpdateResConfigTest005, TestSize.Le
     EXPECT_EQ(HAP_INIT_FAILED, state);
 }
 
+/*
+ * @tc.name: ResourceManagerUpdateResConfigTest006
+ * @tc.desc: Test UpdateResConfigAsync function, the old values are readable until the update is published
+ * @tc.type: FUNC
+ */
+HWTEST_F(ResourceManagerTest, ResourceManagerUpdateResConfigTest006, TestSize.Level1)
+{
+    AddResource("en", nullptr, nullptr);
+    TestStringByName("app_name", "App Name");
+
+    ResConfig *rc = CreateResConfig();
+    ASSERT_TRUE(rc != nullptr);
+    rc->SetLocaleInfo("zh", nullptr, nullptr);
+    std::future<RState> result = rm->UpdateResConfigAsync(*rc);
+    delete rc;
+    while (result.wait_for(std::chrono::milliseconds(0)) != std::future_status::ready) {
+        std::string outValue;
+        EXPECT_EQ(SUCCESS, rm->GetStringByName("app_name", outValue));
+        EXPECT_TRUE(outValue == "App Name" || outValue == "应用名称");
+    }
+    EXPECT_EQ(SUCCESS, result.get());
+    TestStringByName("app_name", "应用名称");
+
+    // the callback gets the result
+    rc = CreateResConfig();
+    ASSERT_TRUE(rc != nullptr);
+    rc->SetLocaleInfo("en", nullptr, "US");
+    std::promise<RState> promise;
+    rm->UpdateResConfigAsync(*rc, [&promise](RState state) { promise.set_value(state); });
+    delete rc;
+    EXPECT_EQ(SUCCESS, promise.get_future().get());
+    TestStringByName("app_name", "App Name");
+}
+
+/*
+ * @tc.name: ResourceManagerUpdateResConfigTest007
+ * @tc.desc: Test UpdateResConfig function, a value found before the updates stays valid while its resources are held
+ * @tc.type: FUNC
+ */
+HWTEST_F(ResourceManagerTest, ResourceManagerUpdateResConfigTest007, TestSize.Level1)
+{
+    AddResource("en", nullptr, nullptr);
+    int id = GetResId("app_name", ResType::STRING);
+    ASSERT_TRUE(id > 0);
+    HapManager *hapManager = ((ResourceManagerImpl *)rm)->hapManager_;
+    std::shared_ptr<const HapManager::Resources> resources;
+    const HapResource::ValueUnderQualifierDir *vuqd = hapManager->FindQualifierValueById(id, resources);
+    ASSERT_TRUE(vuqd != nullptr);
+
+    // two updates in a row replace the resources the value is found in
+    const char *languages[] = { "zh", "en" };
+    for (const char *language : languages) {
+        ResConfig *rc = CreateResConfig();
+        ASSERT_TRUE(rc != nullptr);
+        rc->SetLocaleInfo(language, nullptr, nullptr);
+        EXPECT_EQ(SUCCESS, rm->UpdateResConfig(*rc));
+        delete rc;
+    }
+    EXPECT_NE(resources, hapManager->GetResources());
+    std::shared_ptr<const std::string> holder;
+    EXPECT_EQ("App Name", std::string(vuqd->GetValue(holder)));
+
+    // a lookup in the held resources does not use the cache of the current ones
+    EXPECT_EQ(vuqd->GetIdItem(), hapManager->FindResourceById(id, resources));
+}
+
+/*
+ * @tc.name: ResourceManagerGenerationTest001
+ * @tc.desc: Test GetGeneration function, it changes with the resources and the config only
+ * @tc.type: FUNC
+ */
+HWTEST_F(ResourceManagerTest, ResourceManagerGenerationTest001, TestSize.Level1)
+{
+    uint32_t first = 0;
+    ASSERT_TRUE(rm->GetGeneration(first));
+    AddResource("en", nullptr, nullptr);
+    uint32_t second = 0;
+    ASSERT_TRUE(rm->GetGeneration(second));
+    EXPECT_NE(first, second);
+
+    // the getters keep it, so the values got before are still valid
+    std::string outValue;
+    EXPECT_EQ(SUCCESS, rm->GetStringByName("app_name", outValue));
+    uint32_t generation = 0;
+    ASSERT_TRUE(rm->GetGeneration(generation));
+    EXPECT_EQ(second, generation);
+
+    ResConfig *rc = CreateResConfig();
+    ASSERT_TRUE(rc != nullptr);
+    rc->SetLocaleInfo("zh", nullptr, nullptr);
+    EXPECT_EQ(SUCCESS, rm->UpdateResConfig(*rc));
+    delete rc;
+    ASSERT_TRUE(rm->GetGeneration(generation));
+    EXPECT_NE(second, generation);
+}
+
 /*
  * @tc.name: ResourceManagerGetResConfigTest001
  * @tc.desc: Test GetResConfig function
@@ -2553,12 +3181,13 @@ HWTEST_F(ResourceManagerTest, ResourceManagerResolveParentReferenceTest001, Test
     rm->AddResource(FormatFullPath(g_resFilePath).c_str());
     int id;
     std::map<std::string, std::string> outValue;
+    std::shared_ptr<const HapManager::Resources> resources;
     const IdItem *idItem;
     RState ret;
 
     id = GetResId("base", ResType::PATTERN);
     EXPECT_TRUE(id > 0);
-    idItem = ((ResourceManagerImpl *)rm)->hapManager_->FindResourceById(id);
+    idItem = ((ResourceManagerImpl *)rm)->hapManager_->FindResourceById(id, resources);
     ASSERT_TRUE(idItem != nullptr);
     ret = ((ResourceManagerImpl *)rm)->ResolveParentReference(idItem, outValue);
     ASSERT_EQ(SUCCESS, ret);
@@ -2566,7 +3195,7 @@ HWTEST_F(ResourceManagerTest, ResourceManagerResolveParentReferenceTest001, Test
 
     HILOG_DEBUG("=====");
     id = GetResId("child", ResType::PATTERN);
-    idItem = ((ResourceManagerImpl *)rm)->hapManager_->FindResourceById(id);
+    idItem = ((ResourceManagerImpl *)rm)->hapManager_->FindResourceById(id, resources);
     ASSERT_TRUE(idItem != nullptr);
     ret = ((ResourceManagerImpl *)rm)->ResolveParentReference(idItem, outValue);
     ASSERT_EQ(SUCCESS, ret);
@@ -2574,7 +3203,7 @@ HWTEST_F(ResourceManagerTest, ResourceManagerResolveParentReferenceTest001, Test
 
     HILOG_DEBUG("=====");
     id = GetResId("ccchild", ResType::PATTERN);
-    idItem = ((ResourceManagerImpl *)rm)->hapManager_->FindResourceById(id);
+    idItem = ((ResourceManagerImpl *)rm)->hapManager_->FindResourceById(id, resources);
     ASSERT_TRUE(idItem != nullptr);
     ret = ((ResourceManagerImpl *)rm)->ResolveParentReference(idItem, outValue);
     ASSERT_EQ(SUCCESS, ret);
@@ -2639,4 +3268,320 @@ HWTEST_F(ResourceManagerTest, RawFileTest001, TestSize.Level1)
     TestGetRawFilePathByName("test_rawfile.txt",
         "/data/test/all/assets/entry/resources/rawfile/test_rawfile.txt");
 }
+
+/*
+ * test get raw file descriptor of a raw file inside a hap
+ * @tc.name: RawFileTest002
+ * @tc.desc: Test GetRawFileDescriptor, hap case.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ResourceManagerTest, RawFileTest002, TestSize.Level1)
+{
+    std::ifstream inFile(FormatFullPath("all/assets/entry/resources/rawfile/test_rawfile.txt"), std::ios::binary);
+    ASSERT_TRUE(inFile.good());
+    std::string content((std::istreambuf_iterator<char>(inFile)), std::istreambuf_iterator<char>());
+
+    // the entries of stored.hap are not compressed, the descriptor is the hap fd with the entry range
+    ASSERT_TRUE(rm->AddResource(FormatFullPath("stored.hap").c_str()));
+    TestStringByName("app_name", "App Name");
+    ResourceManager::RawFileDescriptor descriptor;
+    RState state = rm->GetRawFileDescriptor("test_rawfile.txt", descriptor);
+    ASSERT_EQ(SUCCESS, state);
+    EXPECT_GT(descriptor.offset, 0);
+    ASSERT_EQ(static_cast<long>(content.size()), descriptor.length);
+    std::string data(descriptor.length, '\0');
+    EXPECT_EQ(descriptor.length, pread(descriptor.fd, &data[0], descriptor.length, descriptor.offset));
+    EXPECT_EQ(content, data);
+    EXPECT_EQ(SUCCESS, rm->CloseRawFileDescriptor("test_rawfile.txt"));
+
+    // the media and profiles in the hap have no file path
+    std::string outValue;
+    EXPECT_EQ(ERROR, rm->GetMediaByName("icon", outValue));
+    EXPECT_EQ(ERROR, rm->GetProfileByName("test_profile", outValue));
+    int id = GetResId("icon", ResType::MEDIA);
+    ASSERT_GT(id, 0);
+    EXPECT_EQ(ERROR, rm->GetMediaById(id, outValue));
+
+    // the raw files of all.hap are deflated, they can not be read in place
+    ResourceManager *deflated = CreateResourceManager();
+    ASSERT_TRUE(deflated != nullptr);
+    ASSERT_TRUE(deflated->AddResource(FormatFullPath("all.hap").c_str()));
+    EXPECT_EQ(ERROR, deflated->GetRawFileDescriptor("test_rawfile.txt", descriptor));
+    delete deflated;
+}
+
+/*
+ * test read a deflated raw file inside a hap at random positions
+ * @tc.name: RawFileTest003
+ * @tc.desc: Test ZipEntryReader, seek back and forth with checkpoints.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ResourceManagerTest, RawFileTest003, TestSize.Level1)
+{
+    ASSERT_TRUE(rm->AddResource(FormatFullPath("deflated.hap").c_str()));
+    ResourceManagerImpl *impl = static_cast<ResourceManagerImpl *>(rm);
+    HapManager::RawFileLocation location;
+    ASSERT_EQ(SUCCESS, impl->GetRawFileLocation("large.txt", location));
+    ASSERT_TRUE(location.entry != nullptr);
+    ASSERT_TRUE(location.entry->method == ZipArchive::METHOD_DEFLATED);
+
+    // a small span, so there are checkpoints inside the test file
+    const uint64_t span = 16 * 1024;
+    ZipEntryReader reader(location.archive, *location.entry, location.offset, span);
+    ASSERT_TRUE(reader.Init());
+    ASSERT_EQ(location.entry->uncompressedSize, reader.GetSize());
+    std::string content(reader.GetSize(), '\0');
+    const size_t chunk = 4096;
+    for (size_t pos = 0; pos < content.size(); pos += chunk) {
+        size_t len = std::min(chunk, content.size() - pos);
+        ASSERT_EQ(len, reader.Read(pos, &content[pos], len));
+    }
+    EXPECT_EQ(0u, reader.Read(content.size(), &content[0], chunk));
+    uLong crc = crc32(0L, reinterpret_cast<const Bytef *>(content.data()), content.size());
+    EXPECT_EQ(location.entry->crc32, crc);
+    EXPECT_GT(reader.GetCheckpointCount(), 2u);
+
+    // seek back and forth, every read resumes from the nearest checkpoint
+    const uint64_t positions[] = { 150000, 3, 65536, 196000, 40000, 40001, 0, 100000 };
+    for (uint64_t pos : positions) {
+        std::string data(1000, '\0');
+        size_t len = std::min<size_t>(data.size(), content.size() - pos);
+        ASSERT_EQ(len, reader.Read(pos, &data[0], data.size()));
+        EXPECT_EQ(content.substr(pos, len), data.substr(0, len));
+    }
+
+    // a small raw file, it is one block
+    std::ifstream inFile(FormatFullPath("all/assets/entry/resources/rawfile/test_rawfile.txt"), std::ios::binary);
+    ASSERT_TRUE(inFile.good());
+    std::string expected((std::istreambuf_iterator<char>(inFile)), std::istreambuf_iterator<char>());
+    std::string errInfo;
+    std::shared_ptr<ZipArchive> archive = ZipArchive::Open(FormatFullPath("all.hap"), errInfo);
+    ASSERT_TRUE(archive != nullptr);
+    const ZipArchive::Entry *entry = archive->GetEntry("assets/entry/resources/rawfile/test_rawfile.txt");
+    ASSERT_TRUE(entry != nullptr);
+    uint64_t dataOffset = 0;
+    ASSERT_EQ(OK, archive->GetDataOffset(*entry, dataOffset));
+    ZipEntryReader small(archive, *entry, dataOffset);
+    ASSERT_TRUE(small.Init());
+    std::string data(expected.size() + 1, '\0');
+    ASSERT_EQ(expected.size(), small.Read(0, &data[0], data.size()));
+    EXPECT_EQ(expected, data.substr(0, expected.size()));
+    EXPECT_EQ(1u, small.GetCheckpointCount());
+}
+
+/*
+ * test list and find raw files from the raw file indexes
+ * @tc.name: RawFileTest004
+ * @tc.desc: Test GetRawFileList and RescanRawFiles, file and hap case.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ResourceManagerTest, RawFileTest004, TestSize.Level1)
+{
+    ASSERT_TRUE(rm->AddResource(FormatFullPath(g_resFilePath).c_str()));
+    ASSERT_TRUE(rm->AddResource(FormatFullPath("deflated.hap").c_str()));
+    ResourceManagerImpl *impl = static_cast<ResourceManagerImpl *>(rm);
+
+    // test_rawfile.txt is in both, it is listed once
+    std::vector<std::string> names;
+    ASSERT_EQ(SUCCESS, impl->GetRawFileList("", false, names));
+    std::vector<std::string> expected = { "rawfile/large.txt", "rawfile/test_rawfile.txt" };
+    std::sort(names.begin(), names.end());
+    EXPECT_EQ(expected, names);
+    names.clear();
+    EXPECT_EQ(RState::NOT_FOUND, impl->GetRawFileList("nonexistent", true, names));
+
+    HapManager::RawFileLocation location;
+    EXPECT_EQ(SUCCESS, impl->GetRawFileLocation("rawfile/./test_rawfile.txt", location));
+    EXPECT_TRUE(location.archive != nullptr);
+    EXPECT_EQ(RState::NOT_FOUND, impl->GetRawFileLocation("../resources.index", location));
+
+    // a new file on the disk changes the mod time of its directory, it is found without a rescan
+    const std::string rawFileDir = FormatFullPath("all/assets/entry/resources/rawfile/");
+    ASSERT_EQ(0, mkdir((rawFileDir + "sub").c_str(), S_IRWXU));
+    std::ofstream((rawFileDir + "sub/new.txt").c_str()) << "new";
+    EXPECT_EQ(SUCCESS, impl->GetRawFileLocation("sub/new.txt", location));
+    EXPECT_EQ(rawFileDir + "sub/new.txt", location.path);
+    EXPECT_EQ(3u, location.length);
+    names.clear();
+    ASSERT_EQ(SUCCESS, impl->GetRawFileList("", true, names));
+    EXPECT_EQ(3u, names.size());
+    EXPECT_TRUE(std::find(names.begin(), names.end(), "rawfile/sub/new.txt") != names.end());
+    names.clear();
+    ASSERT_EQ(SUCCESS, impl->GetRawFileList("sub", false, names));
+    EXPECT_EQ(std::vector<std::string>(1, "rawfile/sub/new.txt"), names);
+    // a file added to a directory which is already indexed
+    std::ofstream((rawFileDir + "sub/newer.txt").c_str()) << "newer";
+    names.clear();
+    ASSERT_EQ(SUCCESS, impl->GetRawFileList("sub", false, names));
+    EXPECT_EQ(2u, names.size());
+    unlink((rawFileDir + "sub/newer.txt").c_str());
+
+    unlink((rawFileDir + "sub/new.txt").c_str());
+    rmdir((rawFileDir + "sub").c_str());
+    impl->RescanRawFiles();
+    EXPECT_EQ(RState::NOT_FOUND, impl->GetRawFileLocation("sub/new.txt", location));
+}
+
+/*
+ * test find several raw files at once
+ * @tc.name: RawFileTest005
+ * @tc.desc: Test GetRawFileLocations, file and hap case.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ResourceManagerTest, RawFileTest005, TestSize.Level1)
+{
+    ASSERT_TRUE(rm->AddResource(FormatFullPath(g_resFilePath).c_str()));
+    ASSERT_TRUE(rm->AddResource(FormatFullPath("deflated.hap").c_str()));
+    ResourceManagerImpl *impl = static_cast<ResourceManagerImpl *>(rm);
+
+    std::vector<std::string> names = { "large.txt", "nonexistent.txt", "rawfile/test_rawfile.txt" };
+    std::vector<HapManager::RawFileLocation> locations;
+    EXPECT_EQ(RState::NOT_FOUND, impl->GetRawFileLocations(names, locations));
+    ASSERT_EQ(names.size(), locations.size());
+    EXPECT_EQ(FormatFullPath("deflated.hap"), locations[0].path);
+    EXPECT_EQ(196608u, locations[0].length);
+    EXPECT_TRUE(locations[1].path.empty());
+    for (size_t i = 0; i < names.size(); ++i) {
+        HapManager::RawFileLocation location;
+        if (impl->GetRawFileLocation(names[i], location) == SUCCESS) {
+            EXPECT_EQ(location.path, locations[i].path);
+            EXPECT_EQ(location.offset, locations[i].offset);
+        }
+    }
+
+    names.erase(names.begin() + 1);
+    EXPECT_EQ(SUCCESS, impl->GetRawFileLocations(names, locations));
+}
+
+/*
+ * test the raw file descriptors are shared and reference counted
+ * @tc.name: RawFileTest006
+ * @tc.desc: Test GetRawFileDescriptor and CloseRawFileDescriptor, shared fd and limits.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ResourceManagerTest, RawFileTest006, TestSize.Level1)
+{
+    ASSERT_TRUE(rm->AddResource(FormatFullPath("stored.hap").c_str()));
+    ResourceManagerImpl *impl = static_cast<ResourceManagerImpl *>(rm);
+    ResourceManager::RawFileDescriptor first;
+    ResourceManager::RawFileDescriptor second;
+    ASSERT_EQ(SUCCESS, rm->GetRawFileDescriptor("test_rawfile.txt", first));
+    ASSERT_EQ(SUCCESS, rm->GetRawFileDescriptor("test_rawfile.txt", second));
+    EXPECT_EQ(first.fd, second.fd);
+
+    // one close does not invalidate the descriptor of the other holder
+    EXPECT_EQ(SUCCESS, rm->CloseRawFileDescriptor("test_rawfile.txt"));
+    char data[4] = {0};
+    EXPECT_EQ(4, pread(second.fd, data, sizeof(data), second.offset));
+
+    // another name of the same hap shares the fd
+    ResourceManager::RawFileDescriptor other;
+    ASSERT_EQ(SUCCESS, rm->GetRawFileDescriptor("rawfile/test_rawfile.txt", other));
+    EXPECT_EQ(second.fd, other.fd);
+    EXPECT_EQ(second.offset, other.offset);
+    EXPECT_EQ(SUCCESS, rm->CloseRawFileDescriptor("rawfile/test_rawfile.txt"));
+    EXPECT_EQ(SUCCESS, rm->CloseRawFileDescriptor("test_rawfile.txt"));
+
+    // at most one file open, a held file keeps the other one from opening
+    RawFileDescriptorCache cache(1, 1);
+    RawFileDescriptorCache::Descriptor held;
+    RawFileDescriptorCache::Descriptor blocked;
+    ASSERT_TRUE(cache.Open("a", FormatFullPath("stored.hap"), 0, 1, held));
+    EXPECT_FALSE(cache.Open("b", FormatFullPath("deflated.hap"), 0, 1, blocked));
+    EXPECT_TRUE(cache.Release("a"));
+    EXPECT_FALSE(cache.Release("a"));
+    EXPECT_EQ(1u, cache.GetOpenFileCount());
+    ASSERT_TRUE(cache.Open("b", FormatFullPath("deflated.hap"), 0, 1, blocked));
+    EXPECT_EQ(1u, cache.GetOpenFileCount());
+    EXPECT_EQ(1u, cache.GetEntryCount());
+    EXPECT_FALSE(cache.Acquire("a", held));
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([this] {
+            for (int j = 0; j < 100; ++j) {
+                ResourceManager::RawFileDescriptor descriptor;
+                if (rm->GetRawFileDescriptor("test_rawfile.txt", descriptor) == SUCCESS) {
+                    rm->CloseRawFileDescriptor("test_rawfile.txt");
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    impl->SetRawFileDescriptorLimits(1, 0);
+
+    // the name opened by several threads at once is held once by each of them
+    RawFileDescriptorCache shared;
+    std::vector<std::thread> openers;
+    for (int i = 0; i < 4; ++i) {
+        openers.emplace_back([&shared] {
+            RawFileDescriptorCache::Descriptor descriptor;
+            EXPECT_TRUE(shared.Open("a", FormatFullPath("stored.hap"), 0, 1, descriptor));
+        });
+    }
+    for (auto &thread : openers) {
+        thread.join();
+    }
+    EXPECT_EQ(1u, shared.GetEntryCount());
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(shared.Release("a"));
+    }
+    EXPECT_FALSE(shared.Release("a"));
+    shared.ReleaseIdle();
+    EXPECT_EQ(0u, shared.GetOpenFileCount());
+}
+
+/*
+ * test the raw files are mapped once and shared
+ * @tc.name: RawFileTest007
+ * @tc.desc: Test MappedFile, shared mapping case.
+ * @tc.type: FUNC
+ */
+HWTEST_F(ResourceManagerTest, RawFileTest007, TestSize.Level1)
+{
+    rm->AddResource(FormatFullPath(g_resFilePath).c_str());
+    std::string path;
+    ASSERT_EQ(SUCCESS, rm->GetRawFilePathByName("test_rawfile.txt", path));
+    std::ifstream inFile(path, std::ios::binary);
+    ASSERT_TRUE(inFile.good());
+    std::string content((std::istreambuf_iterator<char>(inFile)), std::istreambuf_iterator<char>());
+
+    size_t count = MappedFile::GetSharedCount();
+    std::shared_ptr<const MappedFile> first = MappedFile::Open(path);
+    ASSERT_TRUE(first != nullptr);
+    EXPECT_TRUE(first->IsMapped());
+    ASSERT_EQ(content.size(), first->Size());
+    EXPECT_EQ(content, std::string(first->Data(), first->Size()));
+
+    // the second open of the file shares the mapping
+    std::shared_ptr<const MappedFile> second = MappedFile::Open(path);
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_EQ(count + 1, MappedFile::GetSharedCount());
+
+    // the mapping is released with the last holder
+    first.reset();
+    EXPECT_EQ(count + 1, MappedFile::GetSharedCount());
+    second.reset();
+    EXPECT_EQ(count, MappedFile::GetSharedCount());
+
+    // a private mapping is not shared, its writes reach neither the shared mapping nor the file
+    std::shared_ptr<const MappedFile> shared = MappedFile::Open(path);
+    ASSERT_TRUE(shared != nullptr);
+    std::shared_ptr<MappedFile> owned = MappedFile::OpenPrivate(path);
+    ASSERT_TRUE(owned != nullptr);
+    EXPECT_NE(shared.get(), owned.get());
+    ASSERT_EQ(content.size(), owned->Size());
+    ASSERT_GT(owned->Size(), 0u);
+    owned->Data()[0] = static_cast<char>(~content[0]);
+    EXPECT_EQ(content, std::string(shared->Data(), shared->Size()));
+    EXPECT_EQ(count + 1, MappedFile::GetSharedCount());
+    owned.reset();
+    std::ifstream reread(path, std::ios::binary);
+    EXPECT_EQ(content, std::string((std::istreambuf_iterator<char>(reread)), std::istreambuf_iterator<char>()));
+
+    EXPECT_TRUE(MappedFile::Open(FormatFullPath("all/not_exist.txt")) == nullptr);
+    EXPECT_TRUE(MappedFile::OpenPrivate(FormatFullPath("all/not_exist.txt")) == nullptr);
+}
 }
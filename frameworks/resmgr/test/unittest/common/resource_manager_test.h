@@ -19,11 +19,29 @@
 int ResourceManagerAddResourceTest001(void);
 int ResourceManagerAddResourceTest002(void);
 int ResourceManagerAddResourceTest003(void);
+int ResourceManagerAddResourceTest004(void);
+int ResourceManagerAddResourceTest005(void);
+int ResourceManagerAddResourceTest006(void);
+int ResourceManagerAddOverlayTest001(void);
+int ResourceManagerReloadChangedTest001(void);
+int ResourceManagerReloadChangedTest002(void);
+
+int ResourceManagerReloadChangedTest003(void);
+int ResourceManagerGetMemoryUsageTest001(void);
+int ResourceManagerTrimTest001(void);
+
+int ResourceManagerLongStringTest001(void);
+int ResourceManagerStartupProfileTest001(void);
+
+int ResourceManagerStartupProfileTest002(void);
 int ResourceManagerUpdateResConfigTest001(void);
 int ResourceManagerUpdateResConfigTest002(void);
 int ResourceManagerUpdateResConfigTest003(void);
 int ResourceManagerUpdateResConfigTest004(void);
 int ResourceManagerUpdateResConfigTest005(void);
+int ResourceManagerUpdateResConfigTest006(void);
+int ResourceManagerUpdateResConfigTest007(void);
+int ResourceManagerGenerationTest001(void);
 int ResourceManagerGetResConfigTest001(void);
 int ResourceManagerGetResConfigTest002(void);
 int ResourceManagerGetStringByIdTest001(void);
@@ -129,5 +147,11 @@ int ResourceManagerResolveReferenceTest001(void);
 int ResourceManagerResolveParentReferenceTest001(void);
 int ResourceManagerSameNameTest001(void);
 int RawFileTest001(void);
+int RawFileTest002(void);
+int RawFileTest003(void);
+int RawFileTest004(void);
+int RawFileTest005(void);
+int RawFileTest006(void);
+int RawFileTest007(void);
 
 #endif
@@ -15,10 +15,14 @@
 
 #include "string_utils_test.h"
 #include <climits>
+#include <cstring>
 #include <gtest/gtest.h>
 #include <thread>
 #include "auto_mutex.h"
 #include "test_common.h"
+#include "utils/base64.h"
+#include "utils/media_base64_cache.h"
+#include "utils/string_pool.h"
 #include "utils/string_utils.h"
 
 using namespace OHOS::Global::Resource;
@@ -103,4 +107,136 @@ HWTEST_F(StringUtilsTest, LockFuncTest001, TestSize.Level1)
     TestThread(&num, threadNum, &lock);
     EXPECT_EQ(result, num);
 }
-}
\ No newline at end of file
+
+/*
+ * @tc.name: Base64FuncTest001
+ * @tc.desc: Test Base64 Encode, none file case.
+ * @tc.type: FUNC
+ */
+HWTEST_F(StringUtilsTest, Base64FuncTest001, TestSize.Level1)
+{
+    std::string result;
+    Base64::Encode("", 0, result);
+    EXPECT_EQ("", result);
+    const char *cases[][2] = {
+        {"f", "Zg=="}, {"fo", "Zm8="}, {"foo", "Zm9v"}, {"foob", "Zm9vYg=="},
+        {"fooba", "Zm9vYmE="}, {"foobar", "Zm9vYmFy"},
+    };
+    for (auto &item : cases) {
+        result.clear();
+        Base64::Encode(item[0], strlen(item[0]), result);
+        EXPECT_EQ(item[1], result);
+    }
+
+    // every length around the SIMD steps, with every byte value
+    std::string data;
+    for (int i = 0; i < 512; ++i) {
+        data.push_back(static_cast<char>((i * 167 + 13) & 0xFF));
+    }
+    for (size_t len = 0; len <= data.size(); ++len) {
+        std::string expect(Base64::EncodedLength(len), '\0');
+        ASSERT_EQ(expect.size(), Base64::EncodeScalar(data.data(), len, &expect[0]));
+        result.clear();
+        Base64::Encode(data.data(), len, result);
+        ASSERT_EQ(expect, result) << "len " << len;
+    }
+}
+
+/*
+ * @tc.name: MediaBase64CacheFuncTest001
+ * @tc.desc: Test MediaBase64Cache, the modified files miss and the least recently used are evicted.
+ * @tc.type: FUNC
+ */
+HWTEST_F(StringUtilsTest, MediaBase64CacheFuncTest001, TestSize.Level1)
+{
+    MediaBase64Cache cache(8);
+    std::string value;
+    EXPECT_FALSE(cache.Get("a", 1, 1, value));
+    cache.Put("a", 1, 1, "aaa");
+    cache.Put("b", 1, 1, "bbb");
+    EXPECT_TRUE(cache.Get("a", 1, 1, value));
+    EXPECT_EQ("aaa", value);
+    EXPECT_EQ(6u, cache.GetSize());
+
+    // a modified file drops its entry
+    EXPECT_FALSE(cache.Get("b", 2, 1, value));
+    EXPECT_FALSE(cache.Get("b", 1, 1, value));
+    EXPECT_FALSE(cache.Get("a", 1, 2, value));
+    EXPECT_EQ(0u, cache.GetEntryCount());
+    EXPECT_EQ(0u, cache.GetSize());
+
+    // b is evicted for c, a was used after it
+    cache.Put("a", 1, 1, "aaa");
+    cache.Put("b", 1, 1, "bbb");
+    EXPECT_TRUE(cache.Get("a", 1, 1, value));
+    cache.Put("c", 1, 1, "ccc");
+    EXPECT_EQ(2u, cache.GetEntryCount());
+    EXPECT_EQ(6u, cache.GetSize());
+    EXPECT_FALSE(cache.Get("b", 1, 1, value));
+    EXPECT_TRUE(cache.Get("a", 1, 1, value));
+    EXPECT_TRUE(cache.Get("c", 1, 1, value));
+
+    // the value of a path is replaced, a value longer than the max size is not cached
+    cache.Put("a", 1, 1, "a");
+    EXPECT_EQ(4u, cache.GetSize());
+    cache.Put("d", 1, 1, "ddddddddd");
+    EXPECT_FALSE(cache.Get("d", 1, 1, value));
+    EXPECT_EQ(2u, cache.GetEntryCount());
+
+    cache.Clear();
+    EXPECT_EQ(0u, cache.GetEntryCount());
+    EXPECT_EQ(0u, cache.GetSize());
+    EXPECT_FALSE(cache.Get("a", 1, 1, value));
+}
+
+/*
+ * @tc.name: StringPoolFuncTest001
+ * @tc.desc: Test StringPool Intern, the equal strings share one copy, also when interned by several threads.
+ * @tc.type: FUNC
+ */
+HWTEST_F(StringUtilsTest, StringPoolFuncTest001, TestSize.Level1)
+{
+    StringPool pool;
+    std::string_view empty = pool.Intern("");
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ('\0', empty.data()[0]);
+
+    std::string app("app_name");
+    std::string_view first = pool.Intern(app);
+    app[0] = 'x';
+    EXPECT_EQ("app_name", first);
+    EXPECT_EQ('\0', first.data()[first.size()]);
+    EXPECT_EQ(first.data(), pool.Intern(std::string("app_name")).data());
+    EXPECT_NE(first.data(), pool.Intern("app_names").data());
+
+    // a string longer than the blocks has its own one
+    std::string longStr(64 * 1024, 'a');
+    std::string_view interned = pool.Intern(longStr);
+    EXPECT_EQ(longStr, interned);
+    EXPECT_EQ(interned.data(), pool.Intern(longStr).data());
+    EXPECT_EQ(3u, pool.GetCount());
+    EXPECT_GT(pool.GetMemoryUsage(), longStr.size());
+
+    const int threadNum = 4;
+    const int strNum = 1000;
+    std::vector<std::vector<std::string_view>> results(threadNum);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadNum; ++t) {
+        threads.emplace_back([&pool, &results, t] {
+            for (int i = 0; i < strNum; ++i) {
+                results[t].push_back(pool.Intern("string_" + std::to_string(i)));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(3u + strNum, pool.GetCount());
+    for (int i = 0; i < strNum; ++i) {
+        EXPECT_EQ("string_" + std::to_string(i), results[0][i]);
+        for (int t = 1; t < threadNum; ++t) {
+            EXPECT_EQ(results[0][i].data(), results[t][i].data());
+        }
+    }
+}
+}
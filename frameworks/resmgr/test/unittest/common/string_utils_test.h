@@ -18,5 +18,8 @@
 
 int StringUtilsFuncTest001(void);
 int LockFuncTest001(void);
+int Base64FuncTest001(void);
+int MediaBase64CacheFuncTest001(void);
+int StringPoolFuncTest001(void);
 
 #endif
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OHOS_RESOURCE_MANAGER_INDEX_OPTIMIZER_H
+#define OHOS_RESOURCE_MANAGER_INDEX_OPTIMIZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "res_config_impl.h"
+#include "res_desc.h"
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+/**
+ * Optimize a resources.index offline: it is parsed by HapParser with all the qualifier directories, the references
+ * are linked and the typed values are normalized, then it is written as version 2, whose strings are deduplicated,
+ * ids are sorted and names are hashed. An index of every locale can also be written, it holds the directories
+ * loaded under that locale.
+ */
+class IndexOptimizer {
+public:
+    IndexOptimizer();
+
+    ~IndexOptimizer();
+
+    /**
+     * Load an index
+     * @param indexPath the path of resources.index, version 1 or 2
+     * @return OK if success, else SYS_ERROR
+     */
+    int32_t Load(const std::string &indexPath);
+
+    /**
+     * Replace the references by the values they resolve to, when every target on the way has a single value in the
+     * default directory. The references to the resources redefined by an overlay must be kept, so do not call it for
+     * an index which has overlays
+     * @return the number of the values linked
+     */
+    size_t PrelinkReferences();
+
+    /**
+     * Decode the integers and colors with the decoders of the runtime and write them in the canonical form, so that
+     * the equal values share a string. The integers, colors and booleans which can not be decoded are reported
+     * @param invalid the names of the values which can not be decoded are appended to it
+     * @return the number of the values rewritten
+     */
+    size_t NormalizeTypedValues(std::vector<std::string> &invalid);
+
+    /**
+     * Write the index as version 2
+     * @param outPath the path of the optimized index
+     * @return OK if success, else SYS_ERROR
+     */
+    int32_t Write(const std::string &outPath) const;
+
+    /**
+     * Get the locales of the qualifier directories, such as "zh_Hant_TW"
+     */
+    std::vector<std::string> GetLocales() const;
+
+    /**
+     * Write an index with the directories loaded under a locale as version 2
+     * @param locale one of GetLocales()
+     * @param outPath the path of the index of the locale
+     * @return OK if success, else SYS_ERROR
+     */
+    int32_t WriteLocale(const std::string &locale, const std::string &outPath) const;
+
+    /**
+     * Check an index resolves every id and name to the same value as the loaded index, under the config of every
+     * qualifier directory
+     * @param indexPath the path of the index to check
+     * @param locale the locale the index is written for by WriteLocale(), or empty for all the locales
+     * @param errInfo the first difference
+     * @return OK if they are the same, else SYS_ERROR
+     */
+    int32_t Verify(const std::string &indexPath, const std::string &locale, std::string &errInfo) const;
+
+private:
+    // the values of an id in the directories
+    typedef std::vector<std::pair<const ResKey *, IdItem *>> Variants;
+
+    bool Resolve(std::string_view value, std::string_view &resolved) const;
+
+    // the configs of the directories loaded under the locale, and the names of the directories
+    std::vector<ResConfigImpl *> CreateConfigs(const std::string &locale, std::vector<std::string> &folders) const;
+
+    std::vector<ResKey *> GetKeysOfLocale(const std::string &locale) const;
+
+    static std::string GetLocale(const ResKey &key);
+
+    static ResConfigImpl *CreateLocaleConfig(const std::string &locale);
+
+    std::string indexPath_;
+
+    ResDesc *resDesc_;
+
+    std::unordered_map<uint32_t, Variants> variants_;
+
+    // the integers can not be decoded, they are not looked up by Verify()
+    bool hasInvalidIntegers_;
+
+    IndexOptimizer(const IndexOptimizer &src) = delete;
+
+    IndexOptimizer &operator=(const IndexOptimizer &src) = delete;
+};
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
+#endif
@@ -0,0 +1,577 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "index_optimizer.h"
+
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <set>
+
+#include "hap_parser.h"
+#include "hilog_wrapper.h"
+#include "locale_matcher.h"
+#include "resource_manager.h"
+#include "utils/common.h"
+#include "utils/errors.h"
+#include "utils/index_v2.h"
+#include "utils/mapped_file.h"
+#include "utils/string_utils.h"
+#include "utils/utils.h"
+
+namespace OHOS {
+namespace Global {
+namespace Resource {
+namespace {
+// the locale of the configs of the directories without a language, a config must have one
+const char *DEFAULT_LANGUAGE = "en";
+
+// the quantities the plurals are looked up with by Verify()
+const int PLURAL_QUANTITIES[] = { 0, 1, 2, 5 };
+
+// the types whose values are resolved by ResourceManager when they are references
+bool IsResolvedType(ResType type)
+{
+    return type == ResType::STRING || type == ResType::INTEGER || type == ResType::BOOLEAN ||
+        type == ResType::COLOR || type == ResType::FLOAT || type == ResType::STRINGARRAY ||
+        type == ResType::INTARRAY;
+}
+
+// the same as std::stoi of GetInteger(), which throws when it fails
+bool DecodeInteger(std::string_view value, int &out)
+{
+    std::string str(value);
+    errno = 0;
+    char *end = nullptr;
+    long result = strtol(str.c_str(), &end, 10);
+    if (end == str.c_str() || errno == ERANGE || result < INT_MIN || result > INT_MAX) {
+        return false;
+    }
+    out = static_cast<int>(result);
+    return true;
+}
+
+bool NormalizeValue(ResType type, std::string_view value, std::string &normalized, bool &valid)
+{
+    ResType refType;
+    int refId;
+    valid = true;
+    if (IdItem::IsRef(value, refType, refId)) {
+        return false;
+    }
+    if (type == ResType::INTEGER || type == ResType::INTARRAY) {
+        int result = 0;
+        valid = DecodeInteger(value, result);
+        normalized = std::to_string(result);
+    } else if (type == ResType::COLOR) {
+        uint32_t color = 0;
+        uint32_t check = 0;
+        valid = Utils::ConvertColorToUInt32(std::string(value).c_str(), color) == SUCCESS;
+        normalized = FormatString("#%08X", color);
+        // only the form decoded to the same color is used
+        if (Utils::ConvertColorToUInt32(normalized.c_str(), check) != SUCCESS || check != color) {
+            return false;
+        }
+    } else if (type == ResType::BOOLEAN) {
+        valid = (value == "true" || value == "false");
+        return false;
+    } else {
+        return false;
+    }
+    return valid && normalized != value;
+}
+
+std::string Describe(RState state, const std::string &value)
+{
+    return std::to_string(state) + ":" + value;
+}
+
+std::string Describe(RState state, const std::vector<std::string> &values)
+{
+    std::string result = std::to_string(state) + ":[";
+    for (const std::string &value : values) {
+        result.append(value).append(",");
+    }
+    return result + "]";
+}
+
+std::string Describe(RState state, const std::vector<int> &values)
+{
+    std::string result = std::to_string(state) + ":[";
+    for (int value : values) {
+        result.append(std::to_string(value)).append(",");
+    }
+    return result + "]";
+}
+
+std::string Describe(RState state, const std::map<std::string, std::string> &values)
+{
+    std::string result = std::to_string(state) + ":{";
+    for (const auto &value : values) {
+        result.append(value.first).append("=").append(value.second).append(",");
+    }
+    return result + "}";
+}
+
+// the directory the paths of the media and profiles start with, the same as HapResource::Init()
+std::string GetResourcePath(const std::string &indexPath)
+{
+    auto index = indexPath.rfind('/');
+#ifndef __IDE_PREVIEW__
+    if (index != std::string::npos && index > 0) {
+        index = indexPath.rfind('/', index - 1);
+    }
+#endif
+    return (index == std::string::npos) ? std::string() : indexPath.substr(0, index + 1);
+}
+
+std::string DescribePath(RState state, const std::string &value, const std::string &resourcePath)
+{
+    if (!resourcePath.empty() && value.compare(0, resourcePath.size(), resourcePath) == 0) {
+        return Describe(state, value.substr(resourcePath.size()));
+    }
+    return Describe(state, value);
+}
+
+// look up a resource by its id or name with the getter of its type, the paths are relative to resourcePath
+std::string Lookup(ResourceManager &manager, uint32_t id, const char *name, ResType type, bool byName,
+    const std::string &resourcePath)
+{
+    switch (type) {
+        case ResType::STRING: {
+            std::string value;
+            return Describe(byName ? manager.GetStringByName(name, value) : manager.GetStringById(id, value), value);
+        }
+        case ResType::STRINGARRAY: {
+            std::vector<std::string> values;
+            return Describe(byName ? manager.GetStringArrayByName(name, values) :
+                manager.GetStringArrayById(id, values), values);
+        }
+        case ResType::INTEGER: {
+            int value = 0;
+            RState state = byName ? manager.GetIntegerByName(name, value) : manager.GetIntegerById(id, value);
+            return Describe(state, std::to_string(value));
+        }
+        case ResType::INTARRAY: {
+            std::vector<int> values;
+            return Describe(byName ? manager.GetIntArrayByName(name, values) :
+                manager.GetIntArrayById(id, values), values);
+        }
+        case ResType::BOOLEAN: {
+            bool value = false;
+            RState state = byName ? manager.GetBooleanByName(name, value) : manager.GetBooleanById(id, value);
+            return Describe(state, value ? "true" : "false");
+        }
+        case ResType::COLOR: {
+            uint32_t value = 0;
+            RState state = byName ? manager.GetColorByName(name, value) : manager.GetColorById(id, value);
+            return Describe(state, std::to_string(value));
+        }
+        case ResType::FLOAT: {
+            float value = 0;
+            std::string unit;
+            RState state = byName ? manager.GetFloatByName(name, value, unit) :
+                manager.GetFloatById(id, value, unit);
+            return Describe(state, std::to_string(value) + unit);
+        }
+        case ResType::PLURALS: {
+            std::vector<std::string> values;
+            RState state = SUCCESS;
+            for (int quantity : PLURAL_QUANTITIES) {
+                std::string value;
+                state = byName ? manager.GetPluralStringByName(name, quantity, value) :
+                    manager.GetPluralStringById(id, quantity, value);
+                values.push_back(Describe(state, value));
+            }
+            return Describe(state, values);
+        }
+        case ResType::THEME: {
+            std::map<std::string, std::string> values;
+            return Describe(byName ? manager.GetThemeByName(name, values) : manager.GetThemeById(id, values), values);
+        }
+        case ResType::PATTERN: {
+            std::map<std::string, std::string> values;
+            return Describe(byName ? manager.GetPatternByName(name, values) :
+                manager.GetPatternById(id, values), values);
+        }
+        case ResType::MEDIA: {
+            std::string value;
+            return DescribePath(byName ? manager.GetMediaByName(name, value) : manager.GetMediaById(id, value),
+                value, resourcePath);
+        }
+        case ResType::PROF: {
+            std::string value;
+            return DescribePath(byName ? manager.GetProfileByName(name, value) :
+                manager.GetProfileById(id, value), value, resourcePath);
+        }
+        default:
+            return std::string();
+    }
+}
+
+int32_t WriteFile(const std::string &path, const std::string &data)
+{
+    FILE *file = fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        HILOG_ERROR("open %s failed", path.c_str());
+        return SYS_ERROR;
+    }
+    size_t written = fwrite(data.data(), 1, data.size(), file);
+    int ret = fclose(file);
+    return (written == data.size() && ret == 0) ? OK : SYS_ERROR;
+}
+} // namespace
+
+IndexOptimizer::IndexOptimizer() : resDesc_(nullptr), hasInvalidIntegers_(false)
+{}
+
+IndexOptimizer::~IndexOptimizer()
+{
+    delete (resDesc_);
+}
+
+int32_t IndexOptimizer::Load(const std::string &indexPath)
+{
+    std::shared_ptr<const MappedFile> file = MappedFile::Open(indexPath);
+    if (file == nullptr || file->Size() == 0) {
+        HILOG_ERROR("open index %s failed", indexPath.c_str());
+        return SYS_ERROR;
+    }
+    ResDesc *resDesc = new (std::nothrow) ResDesc();
+    if (resDesc == nullptr) {
+        HILOG_ERROR("new ResDesc failed when IndexOptimizer::Load");
+        return SYS_ERROR;
+    }
+    // the strings of a version 2 index are read in place
+    resDesc->buffer_ = file;
+    // all the directories are parsed without a default config
+    if (HapParser::ParseResHex(file->Data(), file->Size(), *resDesc, nullptr) != OK) {
+        HILOG_ERROR("parse index %s failed", indexPath.c_str());
+        delete (resDesc);
+        return SYS_ERROR;
+    }
+    delete (resDesc_);
+    resDesc_ = resDesc;
+    indexPath_ = indexPath;
+    hasInvalidIntegers_ = false;
+    variants_.clear();
+    for (const ResKey *resKey : resDesc_->keys_) {
+        if (resKey->resId_ == nullptr) {
+            continue;
+        }
+        for (const IdParam *idParam : resKey->resId_->idParams_) {
+            if (idParam->idItem_ != nullptr) {
+                variants_[idParam->id_].emplace_back(resKey, idParam->idItem_);
+            }
+        }
+    }
+    return OK;
+}
+
+bool IndexOptimizer::Resolve(std::string_view value, std::string_view &resolved) const
+{
+    ResType resType;
+    int id;
+    std::string_view current = value;
+    for (uint8_t depth = 0; depth <= MAX_DEPTH_REF_SEARCH; ++depth) {
+        if (!IdItem::IsRef(current, resType, id)) {
+            resolved = current;
+            return true;
+        }
+        auto iter = variants_.find(static_cast<uint32_t>(id));
+        // the target must be the same under any config
+        if (IdItem::IsArrayOfType(resType) || iter == variants_.end() || iter->second.size() != 1 ||
+            !iter->second[0].first->keyParams_.empty() || iter->second[0].second->resType_ != resType ||
+            iter->second[0].second->isCompressed_) {
+            return false;
+        }
+        current = iter->second[0].second->value_;
+    }
+    return false;
+}
+
+size_t IndexOptimizer::PrelinkReferences()
+{
+    if (resDesc_ == nullptr) {
+        return 0;
+    }
+    size_t count = 0;
+    for (auto &idVariants : variants_) {
+        for (auto &variant : idVariants.second) {
+            IdItem *idItem = variant.second;
+            if (!IsResolvedType(idItem->resType_)) {
+                continue;
+            }
+            std::string_view resolved;
+            if (!idItem->isArray_) {
+                if (Resolve(idItem->value_, resolved) &&
+                    resolved.data() != idItem->value_.data()) {
+                    idItem->value_ = resolved;
+                    idItem->valueLen_ = static_cast<uint16_t>(resolved.size());
+                    ++count;
+                }
+                continue;
+            }
+            for (std::string_view &value : idItem->values_) {
+                if (Resolve(value, resolved) && resolved.data() != value.data()) {
+                    value = resolved;
+                    ++count;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+size_t IndexOptimizer::NormalizeTypedValues(std::vector<std::string> &invalid)
+{
+    if (resDesc_ == nullptr) {
+        return 0;
+    }
+    size_t count = 0;
+    for (auto &idVariants : variants_) {
+        for (auto &variant : idVariants.second) {
+            IdItem *idItem = variant.second;
+            std::string normalized;
+            bool valid = true;
+            bool allValid = true;
+            if (!idItem->isArray_) {
+                if (NormalizeValue(idItem->resType_, idItem->value_, normalized, valid)) {
+                    idItem->value_ = resDesc_->stringPool_.Intern(normalized);
+                    idItem->valueLen_ = static_cast<uint16_t>(normalized.size());
+                    ++count;
+                }
+                allValid = valid;
+            } else if (idItem->resType_ == ResType::INTARRAY) {
+                for (std::string_view &value : idItem->values_) {
+                    if (NormalizeValue(idItem->resType_, value, normalized, valid)) {
+                        value = resDesc_->stringPool_.Intern(normalized);
+                        ++count;
+                    }
+                    allValid = allValid && valid;
+                }
+            }
+            if (allValid) {
+                continue;
+            }
+            invalid.push_back(FormatString("%s %s", IdItem::resTypeStrList[idItem->resType_].c_str(),
+                std::string(idItem->name_).c_str()));
+            if (idItem->resType_ == ResType::INTEGER || idItem->resType_ == ResType::INTARRAY) {
+                hasInvalidIntegers_ = true;
+            }
+        }
+    }
+    return count;
+}
+
+int32_t IndexOptimizer::Write(const std::string &outPath) const
+{
+    if (resDesc_ == nullptr) {
+        return SYS_ERROR;
+    }
+    std::string out;
+    if (IndexV2::Write(*resDesc_, out) != OK) {
+        HILOG_ERROR("write index failed");
+        return SYS_ERROR;
+    }
+    return WriteFile(outPath, out);
+}
+
+std::string IndexOptimizer::GetLocale(const ResKey &key)
+{
+    std::string language;
+    std::string script;
+    std::string region;
+    for (const KeyParam *keyParam : key.keyParams_) {
+        if (keyParam->type_ == LANGUAGES) {
+            language = keyParam->GetStr();
+        } else if (keyParam->type_ == SCRIPT) {
+            script = keyParam->GetStr();
+        } else if (keyParam->type_ == REGION) {
+            region = keyParam->GetStr();
+        }
+    }
+    if (language.empty()) {
+        return language;
+    }
+    std::string locale = language;
+    if (!script.empty()) {
+        locale.append("_").append(script);
+    }
+    if (!region.empty()) {
+        locale.append("_").append(region);
+    }
+    return locale;
+}
+
+ResConfigImpl *IndexOptimizer::CreateLocaleConfig(const std::string &locale)
+{
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (start <= locale.size()) {
+        size_t end = locale.find('_', start);
+        end = (end == std::string::npos) ? locale.size() : end;
+        parts.push_back(locale.substr(start, end - start));
+        start = end + 1;
+    }
+    if (parts[0].empty()) {
+        return nullptr;
+    }
+    std::string script;
+    std::string region;
+    // the script has 4 letters and the region has 2 letters or 3 digits
+    for (size_t i = 1; i < parts.size(); ++i) {
+        (parts[i].size() == 4 ? script : region) = parts[i];
+    }
+    ResConfigImpl *config = new (std::nothrow) ResConfigImpl();
+    if (config == nullptr) {
+        return nullptr;
+    }
+    if (config->SetLocaleInfo(parts[0].c_str(), script.empty() ? nullptr : script.c_str(),
+        region.empty() ? nullptr : region.c_str()) != SUCCESS) {
+        delete (config);
+        return nullptr;
+    }
+    return config;
+}
+
+std::vector<std::string> IndexOptimizer::GetLocales() const
+{
+    std::set<std::string> locales;
+    if (resDesc_ != nullptr) {
+        for (const ResKey *resKey : resDesc_->keys_) {
+            std::string locale = GetLocale(*resKey);
+            if (!locale.empty()) {
+                locales.insert(locale);
+            }
+        }
+    }
+    return std::vector<std::string>(locales.begin(), locales.end());
+}
+
+std::vector<ResKey *> IndexOptimizer::GetKeysOfLocale(const std::string &locale) const
+{
+    std::vector<ResKey *> keys;
+    std::unique_ptr<ResConfigImpl> localeConfig(CreateLocaleConfig(locale));
+    if (resDesc_ == nullptr || localeConfig == nullptr) {
+        return keys;
+    }
+    // the same as the directories parsed under a default config of the locale
+    for (ResKey *resKey : resDesc_->keys_) {
+        std::unique_ptr<ResConfigImpl> keyConfig(HapParser::CreateResConfigFromKeyParams(resKey->keyParams_));
+        if (keyConfig != nullptr && LocaleMatcher::Match(localeConfig->GetResLocale(), keyConfig->GetResLocale())) {
+            keys.push_back(resKey);
+        }
+    }
+    return keys;
+}
+
+int32_t IndexOptimizer::WriteLocale(const std::string &locale, const std::string &outPath) const
+{
+    std::vector<ResKey *> keys = GetKeysOfLocale(locale);
+    if (keys.empty()) {
+        HILOG_ERROR("no resources of locale %s", locale.c_str());
+        return SYS_ERROR;
+    }
+    std::string out;
+    if (IndexV2::Write(keys, resDesc_->longStrings_, out) != OK) {
+        HILOG_ERROR("write index of locale %s failed", locale.c_str());
+        return SYS_ERROR;
+    }
+    return WriteFile(outPath, out);
+}
+
+std::vector<ResConfigImpl *> IndexOptimizer::CreateConfigs(const std::string &locale,
+    std::vector<std::string> &folders) const
+{
+    std::vector<ResConfigImpl *> configs;
+    std::vector<ResKey *> keys = locale.empty() ? resDesc_->keys_ : GetKeysOfLocale(locale);
+    for (const ResKey *resKey : keys) {
+        ResConfigImpl *config = HapParser::CreateResConfigFromKeyParams(resKey->keyParams_);
+        if (config == nullptr) {
+            continue;
+        }
+        if (config->GetResLocale() == nullptr) {
+            std::unique_ptr<ResConfigImpl> localeConfig(CreateLocaleConfig(locale.empty() ? DEFAULT_LANGUAGE :
+                locale));
+            if (localeConfig == nullptr || config->SetLocaleInfo(localeConfig->GetResLocale()->GetLanguage(),
+                localeConfig->GetResLocale()->GetScript(), localeConfig->GetResLocale()->GetRegion()) != SUCCESS) {
+                delete (config);
+                continue;
+            }
+        }
+        configs.push_back(config);
+        folders.push_back(HapParser::ToFolderPath(resKey->keyParams_));
+    }
+    return configs;
+}
+
+int32_t IndexOptimizer::Verify(const std::string &indexPath, const std::string &locale, std::string &errInfo) const
+{
+    if (resDesc_ == nullptr) {
+        errInfo = "no index loaded";
+        return SYS_ERROR;
+    }
+    std::vector<std::string> folders;
+    std::vector<ResConfigImpl *> configs = CreateConfigs(locale, folders);
+    std::string originalPath = GetResourcePath(indexPath_);
+    std::string optimizedPath = GetResourcePath(indexPath);
+    int32_t ret = OK;
+    for (size_t i = 0; i < configs.size() && ret == OK; ++i) {
+        std::unique_ptr<ResourceManager> original(CreateResourceManager());
+        std::unique_ptr<ResourceManager> optimized(CreateResourceManager());
+        if (original == nullptr || optimized == nullptr || original->UpdateResConfig(*configs[i]) != SUCCESS ||
+            optimized->UpdateResConfig(*configs[i]) != SUCCESS || !original->AddResource(indexPath_.c_str()) ||
+            !optimized->AddResource(indexPath.c_str())) {
+            errInfo = "load index failed";
+            ret = SYS_ERROR;
+            break;
+        }
+        for (const auto &idVariants : variants_) {
+            const IdItem *idItem = idVariants.second[0].second;
+            if (hasInvalidIntegers_ && (idItem->resType_ == ResType::INTEGER ||
+                idItem->resType_ == ResType::INTARRAY)) {
+                continue;
+            }
+            std::string name(idItem->name_);
+            for (bool byName : { false, true }) {
+                std::string expected = Lookup(*original, idItem->id_, name.c_str(), idItem->resType_, byName,
+                    originalPath);
+                std::string actual = Lookup(*optimized, idItem->id_, name.c_str(), idItem->resType_, byName,
+                    optimizedPath);
+                if (expected != actual) {
+                    errInfo = FormatString("%s %s under %s: expected '%s', got '%s'",
+                        IdItem::resTypeStrList[idItem->resType_].c_str(), name.c_str(), folders[i].c_str(),
+                        expected.c_str(), actual.c_str());
+                    ret = SYS_ERROR;
+                    break;
+                }
+            }
+            if (ret != OK) {
+                break;
+            }
+        }
+    }
+    for (ResConfigImpl *config : configs) {
+        delete (config);
+    }
+    return ret;
+}
+} // namespace Resource
+} // namespace Global
+} // namespace OHOS
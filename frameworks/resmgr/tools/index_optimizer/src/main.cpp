@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2022 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "index_optimizer.h"
+#include "utils/errors.h"
+
+using namespace OHOS::Global::Resource;
+
+namespace {
+void PrintUsage(const char *name)
+{
+    fprintf(stderr,
+        "usage: %s [options] <resources.index> <output index>\n"
+        "  --prelink      replace the references by their values, not for an index whose resources are redefined\n"
+        "                 by overlays, the references to them must be kept\n"
+        "  --split <dir>  also write the index of every locale as <dir>/<locale>.index\n"
+        "  --verify       check the outputs resolve every resource to the same value as the input\n",
+        name);
+}
+
+int Verify(const IndexOptimizer &optimizer, const std::string &path, const std::string &locale)
+{
+    std::string errInfo;
+    if (optimizer.Verify(path, locale, errInfo) != OK) {
+        fprintf(stderr, "verify %s failed: %s\n", path.c_str(), errInfo.c_str());
+        return 1;
+    }
+    return 0;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    bool prelink = false;
+    bool verify = false;
+    std::string splitDir;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--prelink") == 0) {
+            prelink = true;
+        } else if (strcmp(argv[i], "--verify") == 0) {
+            verify = true;
+        } else if (strcmp(argv[i], "--split") == 0 && i + 1 < argc) {
+            splitDir = argv[++i];
+        } else if (argv[i][0] == '-') {
+            PrintUsage(argv[0]);
+            return 1;
+        } else {
+            paths.push_back(argv[i]);
+        }
+    }
+    if (paths.size() != 2) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    IndexOptimizer optimizer;
+    if (optimizer.Load(paths[0]) != OK) {
+        fprintf(stderr, "load %s failed\n", paths[0].c_str());
+        return 1;
+    }
+    if (prelink) {
+        printf("prelinked %zu references\n", optimizer.PrelinkReferences());
+    }
+    std::vector<std::string> invalid;
+    printf("normalized %zu values\n", optimizer.NormalizeTypedValues(invalid));
+    for (const std::string &name : invalid) {
+        fprintf(stderr, "warning: %s can not be decoded\n", name.c_str());
+    }
+    if (optimizer.Write(paths[1]) != OK) {
+        fprintf(stderr, "write %s failed\n", paths[1].c_str());
+        return 1;
+    }
+    if (verify && Verify(optimizer, paths[1], "") != 0) {
+        return 1;
+    }
+    if (splitDir.empty()) {
+        return 0;
+    }
+    for (const std::string &locale : optimizer.GetLocales()) {
+        std::string path = splitDir + "/" + locale + ".index";
+        if (optimizer.WriteLocale(locale, path) != OK) {
+            fprintf(stderr, "write %s failed\n", path.c_str());
+            return 1;
+        }
+        if (verify && Verify(optimizer, path, locale) != 0) {
+            return 1;
+        }
+        printf("wrote %s\n", path.c_str());
+    }
+    return 0;
+}
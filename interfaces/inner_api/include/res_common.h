@@ -128,6 +128,17 @@ enum Direction {
     DIRECTION_VERTICAL = 0,
     DIRECTION_HORIZONTAL = 1
 };
+
+/**
+ * How much a resource manager gives back when it is trimmed, a level does what the lower ones do
+ */
+enum TrimLevel {
+    // drop the caches, they are filled again by the lookups, such as when the app goes to the background
+    TRIM_CACHES = 0,
+
+    // also return the free heap to the system, such as under memory pressure
+    TRIM_ALL = 1,
+};
 } // namespace Resource
 } // namespace Global
 } // namespace OHOS
@@ -15,6 +15,8 @@
 #ifndef OHOS_RESOURCE_MANAGER_RESOURCEMANAGER_H
 #define OHOS_RESOURCE_MANAGER_RESOURCEMANAGER_H
 
+#include <functional>
+#include <future>
 #include <map>
 #include <string>
 #include <vector>
@@ -110,6 +112,30 @@ public:
     virtual RState GetRawFileDescriptor(const std::string &name, RawFileDescriptor &descriptor) = 0;
 
     virtual RState CloseRawFileDescriptor(const std::string &name) = 0;
+
+    // the methods below are not pure, so the implementations built before them keep working
+    virtual bool AddResources(const std::vector<std::string> &paths);
+
+    virtual std::future<bool> AddResourceAsync(const std::string &path);
+
+    virtual void AddResourceAsync(const std::string &path, const std::function<void(bool)> &callback);
+
+    virtual std::future<RState> UpdateResConfigAsync(ResConfig &resConfig);
+
+    virtual void UpdateResConfigAsync(ResConfig &resConfig, const std::function<void(RState)> &callback);
+
+    /**
+     * Get the generation of the resources and the config, it changes whenever either of them is changed
+     * @param generation the generation
+     * @return false if the generation is not tracked, then the values got can not be cached by it
+     */
+    virtual bool GetGeneration(uint32_t &generation);
+
+    /**
+     * Shrink the manager, such as when the app goes to the background or under memory pressure
+     * @param level the trim level
+     */
+    virtual void Trim(TrimLevel level);
 };
 
 EXPORT_FUNC ResourceManager *CreateResourceManager();
@@ -18,6 +18,8 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "napi/native_api.h"
 #include "napi/native_node_api.h"
@@ -26,6 +28,9 @@
 namespace OHOS {
 namespace Global {
 namespace Resource {
+class MappedFile;
+struct ResMgrAsyncContext;
+
 class ResourceManagerAddon {
 public:
     static napi_value Create(
@@ -47,10 +52,17 @@ public:
     std::string GetLocale(std::unique_ptr<ResConfig> &cfg);
 
 private:
+    // what the first param of a getter is, given by each getter rather than taken from its name
+    enum ParamKind {
+        PARAM_ID,
+        PARAM_NAME,
+        PARAM_PATH,
+    };
+
     static int GetResId(napi_env env, size_t argc, napi_value *argv);
 
     static napi_value ProcessOnlyIdParam(napi_env env, napi_callback_info info, const std::string &name,
-        napi_async_execute_callback execute);
+        napi_async_execute_callback execute, ParamKind kind);
 
     static napi_value GetString(napi_env env, napi_callback_info info);
 
@@ -81,6 +93,12 @@ private:
 
     static napi_value Release(napi_env env, napi_callback_info info);
 
+    /**
+     * Drop the caches of the addon and trim the resource manager, trim(level?: number), the level is 0 to drop
+     * the caches, and 1 to also return the memory of the resources no longer used
+     */
+    static napi_value Trim(napi_env env, napi_callback_info info);
+
     static std::string GetResName(napi_env env, size_t argc, napi_value *argv);
 
     static napi_value GetMediaByName(napi_env env, napi_callback_info info);
@@ -108,8 +126,72 @@ private:
 
     static napi_value GetStringByNameSync(napi_env env, napi_callback_info info);
 
+    // the getters of an id reject the other types of the param up front
+    static napi_value ProcessSync(napi_env env, napi_callback_info info, const std::string &name,
+        napi_async_execute_callback execute, ParamKind kind, bool cacheable);
+
+    static napi_value GetColor(napi_env env, napi_callback_info info);
+
+    static napi_value GetColorByName(napi_env env, napi_callback_info info);
+
+    static napi_value GetColorSync(napi_env env, napi_callback_info info);
+
+    static napi_value GetColorByNameSync(napi_env env, napi_callback_info info);
+
+    static napi_value GetStringArraySync(napi_env env, napi_callback_info info);
+
+    static napi_value GetStringArrayByNameSync(napi_env env, napi_callback_info info);
+
+    static napi_value GetPluralStringSync(napi_env env, napi_callback_info info);
+
+    static napi_value GetPluralStringByNameSync(napi_env env, napi_callback_info info);
+
+    static napi_value GetMediaSync(napi_env env, napi_callback_info info);
+
+    static napi_value GetMediaByNameSync(napi_env env, napi_callback_info info);
+
+    static napi_value GetMediaBase64Sync(napi_env env, napi_callback_info info);
+
+    static napi_value GetMediaBase64ByNameSync(napi_env env, napi_callback_info info);
+
+    static napi_value GetRawFileSync(napi_env env, napi_callback_info info);
+
+    static bool GetBatchKeys(napi_env env, napi_value array, ResMgrAsyncContext &context);
+
+    static napi_value ProcessBatchParam(napi_env env, napi_callback_info info, const std::string &name,
+        napi_async_execute_callback execute);
+
+    static napi_value ProcessBatchParamSync(napi_env env, napi_callback_info info, const std::string &name,
+        napi_async_execute_callback execute);
+
+    static napi_value GetStrings(napi_env env, napi_callback_info info);
+
+    static napi_value GetStringsSync(napi_env env, napi_callback_info info);
+
+    static napi_value GetNumbers(napi_env env, napi_callback_info info);
+
+    static napi_value GetNumbersSync(napi_env env, napi_callback_info info);
+
+    /**
+     * Get the value created by a sync getter before, at the current generation of the resources
+     * @param env the env of the JS thread
+     * @param key the getter and its params
+     * @return the value, or nullptr if it is not cached
+     */
+    napi_value GetCachedValue(napi_env env, const std::string &key);
+
+    void CacheValue(napi_env env, const std::string &key, napi_value value);
+
+    void ClearValueCache(napi_env env);
+
+    static constexpr size_t MAX_VALUE_CACHE_SIZE = 512;
+
     std::string bundleName_;
     std::shared_ptr<ResourceManager> resMgr_;
+
+    // the values created by the sync getters, only used on the JS thread
+    std::unordered_map<std::string, napi_ref> valueCache_;
+    uint32_t valueCacheGeneration_ = 0;
 };
 
 struct ResMgrAsyncContext {
@@ -123,14 +205,21 @@ struct ResMgrAsyncContext {
     int iValue_;
     float fValue_;
     bool bValue_;
+    uint32_t colorValue_;
 
     typedef napi_value (*CreateNapiValue)(napi_env env, ResMgrAsyncContext &context);
     CreateNapiValue createValueFunc_;
     std::string value_;
     std::vector<std::string> arrayValue_;
 
-    std::unique_ptr<char[]> mediaData;
-    int len_;
+    // the keys of a batch request, an id, or a name when the id is 0, and the results of them
+    std::vector<int32_t> resIds_;
+    std::vector<std::string> resNames_;
+    std::vector<double> numberValues_;
+    std::vector<bool> resolved_;
+
+    // owned by the request, written by js through the array buffer and released by its finalizer
+    std::shared_ptr<MappedFile> mediaData;
 
     napi_deferred deferred_;
     napi_ref callbackRef_;
@@ -142,7 +231,7 @@ struct ResMgrAsyncContext {
     std::shared_ptr<ResourceManager> resMgr_;
 
     ResMgrAsyncContext() : work_(nullptr), resId_(0), param_(0),  iValue_(0), fValue_(0.0f), bValue_(false),
-        createValueFunc_(nullptr), len_(0), deferred_(nullptr), callbackRef_(nullptr), success_(true) {}
+        colorValue_(0), createValueFunc_(nullptr), deferred_(nullptr), callbackRef_(nullptr), success_(true) {}
 
     void SetErrorMsg(const std::string &msg, bool withResId = false);
 
@@ -15,12 +15,15 @@
 
 #include "resource_manager_addon.h"
 
-#include <fstream>
 #include <memory>
+#include <sys/stat.h>
 #include <vector>
 
 #include "hilog/log.h"
 #include "node_api.h"
+#include "utils/base64.h"
+#include "utils/mapped_file.h"
+#include "utils/media_base64_cache.h"
 
 namespace OHOS {
 namespace Global {
@@ -35,13 +38,11 @@ namespace Resource {
 static constexpr OHOS::HiviewDFX::HiLogLabel LABEL = { LOG_CORE, 0xD001E00, "ResourceManagerJs" };
 using namespace OHOS::HiviewDFX;
 static thread_local napi_ref* g_constructor = nullptr;
-std::vector<char> g_codes = {
-    'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M',
-    'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z',
-    'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm',
-    'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z',
-    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/'
-};
+namespace {
+// the data uris of the media encoded recently, the least recently used are dropped beyond the size
+constexpr size_t MAX_MEDIA_BASE64_CACHE_SIZE = 4 * 1024 * 1024;
+MediaBase64Cache g_mediaBase64Cache(MAX_MEDIA_BASE64_CACHE_SIZE);
+} // namespace
 
 napi_value ResourceManagerAddon::Create(
     napi_env env, const std::string& bundleName, const std::shared_ptr<ResourceManager>& resMgr)
@@ -88,6 +89,9 @@ void ResourceManagerAddon::Destructor(napi_env env, void *nativeObject, void *hi
 {
     std::unique_ptr<std::shared_ptr<ResourceManagerAddon>> addonPtr;
     addonPtr.reset(static_cast<std::shared_ptr<ResourceManagerAddon>*>(nativeObject));
+    if (addonPtr != nullptr && *addonPtr != nullptr) {
+        (*addonPtr)->ClearValueCache(env);
+    }
 }
 
 void ResMgrAsyncContext::SetErrorMsg(const std::string &msg, bool withResId)
@@ -129,6 +133,24 @@ bool ResourceManagerAddon::Init(napi_env env)
         DECLARE_NAPI_FUNCTION("getNumber", GetNumber),
         DECLARE_NAPI_FUNCTION("getBooleanByName", GetBooleanByName),
         DECLARE_NAPI_FUNCTION("getNumberByName", GetNumberByName),
+        DECLARE_NAPI_FUNCTION("getColor", GetColor),
+        DECLARE_NAPI_FUNCTION("getColorByName", GetColorByName),
+        DECLARE_NAPI_FUNCTION("getColorSync", GetColorSync),
+        DECLARE_NAPI_FUNCTION("getColorByNameSync", GetColorByNameSync),
+        DECLARE_NAPI_FUNCTION("getStringArraySync", GetStringArraySync),
+        DECLARE_NAPI_FUNCTION("getStringArrayByNameSync", GetStringArrayByNameSync),
+        DECLARE_NAPI_FUNCTION("getPluralStringSync", GetPluralStringSync),
+        DECLARE_NAPI_FUNCTION("getPluralStringByNameSync", GetPluralStringByNameSync),
+        DECLARE_NAPI_FUNCTION("getMediaSync", GetMediaSync),
+        DECLARE_NAPI_FUNCTION("getMediaByNameSync", GetMediaByNameSync),
+        DECLARE_NAPI_FUNCTION("getMediaBase64Sync", GetMediaBase64Sync),
+        DECLARE_NAPI_FUNCTION("getMediaBase64ByNameSync", GetMediaBase64ByNameSync),
+        DECLARE_NAPI_FUNCTION("getRawFileSync", GetRawFileSync),
+        DECLARE_NAPI_FUNCTION("getStrings", GetStrings),
+        DECLARE_NAPI_FUNCTION("getStringsSync", GetStringsSync),
+        DECLARE_NAPI_FUNCTION("getNumbers", GetNumbers),
+        DECLARE_NAPI_FUNCTION("getNumbersSync", GetNumbersSync),
+        DECLARE_NAPI_FUNCTION("trim", Trim),
         DECLARE_NAPI_FUNCTION("release", Release)
     };
 
@@ -274,7 +296,7 @@ std::string ResourceManagerAddon::GetResNameOrPath(napi_env env, size_t argc, na
 }
 
 napi_value ResourceManagerAddon::ProcessOnlyIdParam(napi_env env, napi_callback_info info, const std::string &name,
-    napi_async_execute_callback execute)
+    napi_async_execute_callback execute, ParamKind kind)
 {
     GET_PARAMS(env, info, 2);
 
@@ -295,7 +317,7 @@ napi_value ResourceManagerAddon::ProcessOnlyIdParam(napi_env env, napi_callback_
             napi_create_reference(env, argv[i], 1, &asyncContext->callbackRef_);
             break;
         } else if (i == 0 && valueType == napi_string) {
-            if (name.find("Name") != std::string::npos) {
+            if (kind == PARAM_NAME) {
                 asyncContext->resName_ = GetResNameOrPath(env, argc, argv);
             } else {
                 asyncContext->path_ = GetResNameOrPath(env, argc, argv);
@@ -348,7 +370,7 @@ auto getStringByNameFunc = [](napi_env env, void* data) {
 
 napi_value ResourceManagerAddon::GetStringByName(napi_env env, napi_callback_info info)
 {
-    return ProcessOnlyIdParam(env, info, "getStringByName", getStringByNameFunc);
+    return ProcessOnlyIdParam(env, info, "getStringByName", getStringByNameFunc, PARAM_NAME);
 }
 
 auto getStringFunc = [](napi_env env, void* data) {
@@ -370,7 +392,7 @@ auto getStringFunc = [](napi_env env, void* data) {
 
 napi_value ResourceManagerAddon::GetString(napi_env env, napi_callback_info info)
 {
-    return ProcessOnlyIdParam(env, info, "getString", getStringFunc);
+    return ProcessOnlyIdParam(env, info, "getString", getStringFunc, PARAM_ID);
 }
 
 auto getStringArrayFunc = [](napi_env env, void* data) {
@@ -414,97 +436,64 @@ auto getStringArrayFunc = [](napi_env env, void* data) {
 
 napi_value ResourceManagerAddon::GetStringArrayByName(napi_env env, napi_callback_info info)
 {
-    return ProcessOnlyIdParam(env, info, "GetStringArrayByName", getStringArrayFunc);
+    return ProcessOnlyIdParam(env, info, "GetStringArrayByName", getStringArrayFunc, PARAM_NAME);
 }
 
 napi_value ResourceManagerAddon::GetStringArray(napi_env env, napi_callback_info info)
 {
-    return ProcessOnlyIdParam(env, info, "getStringArray", getStringArrayFunc);
-}
-
-std::unique_ptr<char[]> EncodeBase64(std::unique_ptr<char[]> &data, int srcLen)
-{
-    int len = (srcLen / 3) * 4; // Split 3 bytes to 4 parts, each containing 6 bits.
-    int outLen = ((srcLen % 3) != 0) ? (len + 4) : len;
-    const char *srcData = data.get();
-    std::unique_ptr<char[]>  result = std::make_unique<char[]>(outLen + 1);
-    char *dstData = result.get();
-    int j = 0;
-    int i = 0;
-
-    for (; i < srcLen - 3; i += 3) {
-        unsigned char byte1 = static_cast<unsigned char>(srcData[i]);
-        unsigned char byte2 = static_cast<unsigned char>(srcData[i + 1]);
-        unsigned char byte3 = static_cast<unsigned char>(srcData[i + 2]);
-        dstData[j++] = g_codes[byte1 >> 2];
-        dstData[j++] = g_codes[((byte1 & 0x3) << 4) | (byte2 >> 4)];
-        dstData[j++] = g_codes[((byte2 & 0xF) << 2) | (byte3 >> 6)];
-        dstData[j++] = g_codes[byte3 & 0x3F];
-    }
-    // Handle the case where there is one element left
-    if (srcLen % 3 == 1) {
-        unsigned char byte1 = static_cast<unsigned char>(srcData[i]);
-        dstData[j++] = g_codes[byte1 >> 2];
-        dstData[j++] = g_codes[(byte1 & 0x3) << 4];
-        dstData[j++] = '=';
-        dstData[j++] = '=';
-    } else {
-        unsigned char byte1 = static_cast<unsigned char>(srcData[i]);
-        unsigned char byte2 = static_cast<unsigned char>(srcData[i + 1]);
-        dstData[j++] = g_codes[byte1 >> 2];
-        dstData[j++] = g_codes[((byte1 & 0x3) << 4) | (byte2 >> 4)];
-        dstData[j++] = g_codes[(byte2 & 0xF) << 2];
-        dstData[j++] = '=';
-    }
-    dstData[outLen] = '\0';
-
-    return result;
+    return ProcessOnlyIdParam(env, info, "getStringArray", getStringArrayFunc, PARAM_ID);
 }
 
-std::unique_ptr<char[]> LoadResourceFile(std::string &path, ResMgrAsyncContext &asyncContext, int &len)
+std::shared_ptr<const MappedFile> LoadResourceFile(const std::string &path, ResMgrAsyncContext &asyncContext)
 {
-    std::ifstream mediaStream(path, std::ios::binary);
-    if (!mediaStream.is_open()) {
+    std::shared_ptr<const MappedFile> mediaData = MappedFile::Open(path);
+    if (mediaData == nullptr) {
         asyncContext.SetErrorMsg("Failed to open media");
-        return nullptr;
     }
-    mediaStream.seekg(0, std::ios::end);
-    len = mediaStream.tellg();
-    std::unique_ptr<char[]> tempData = std::make_unique<char[]>(len);
-    if (tempData == nullptr) {
-        asyncContext.SetErrorMsg("Failed to create media buffer");
-        return nullptr;
-    }
-    mediaStream.seekg(0, std::ios::beg);
-    mediaStream.read((tempData.get()), len);
-    return tempData;
+    return mediaData;
 }
 
 void GetResourcesBufferData(std::string path, ResMgrAsyncContext &asyncContext)
 {
-    asyncContext.mediaData = LoadResourceFile(path, asyncContext, asyncContext.len_);
+    // js may write the array buffer, every request maps the file copy on write for its own
+    asyncContext.mediaData = MappedFile::OpenPrivate(path);
     if (asyncContext.mediaData == nullptr) {
+        asyncContext.SetErrorMsg("Failed to open media");
         return;
     }
     asyncContext.createValueFunc_ = [](napi_env env, ResMgrAsyncContext& context) -> napi_value {
         napi_value buffer;
-        napi_status status = napi_create_external_arraybuffer(env, context.mediaData.get(), context.len_,
-            [](napi_env env, void *data, void *hint) {
-                HiLog::Error(LABEL, "Media buffer finalized");
-                delete[] static_cast<char*>(data);
-            }, nullptr, &buffer);
+        size_t len = context.mediaData->Size();
+        napi_status status;
+        if (len == 0) {
+            void *data = nullptr;
+            status = napi_create_arraybuffer(env, 0, &data, &buffer);
+        } else {
+            // the array buffer keeps a reference of the mapping, it is unmapped by the finalizer
+            auto hint = new (std::nothrow) std::shared_ptr<MappedFile>(context.mediaData);
+            if (hint == nullptr) {
+                context.SetErrorMsg("Failed to create media buffer");
+                return nullptr;
+            }
+            status = napi_create_external_arraybuffer(env, context.mediaData->Data(), len,
+                [](napi_env env, void *data, void *hint) {
+                    delete static_cast<std::shared_ptr<MappedFile> *>(hint);
+                }, hint, &buffer);
+            if (status != napi_ok) {
+                delete hint;
+            }
+        }
         if (status != napi_ok) {
             context.SetErrorMsg("Failed to create media external array buffer");
             return nullptr;
         }
 
         napi_value result = nullptr;
-        status = napi_create_typedarray(env, napi_uint8_array, context.len_, buffer, 0, &result);
+        status = napi_create_typedarray(env, napi_uint8_array, len, buffer, 0, &result);
         if (status != napi_ok) {
             context.SetErrorMsg("Failed to create media typed array");
             return nullptr;
         }
-        context.mediaData.release();
         return result;
     };
 }
@@ -522,7 +511,7 @@ auto getMediaByNameFunc = [](napi_env env, void *data) {
 
 napi_value ResourceManagerAddon::GetMediaByName(napi_env env, napi_callback_info info)
 {
-    return ProcessOnlyIdParam(env, info, "getMediaByName", getMediaByNameFunc);
+    return ProcessOnlyIdParam(env, info, "getMediaByName", getMediaByNameFunc, PARAM_NAME);
 }
 
 auto getMediaFunc = [](napi_env env, void *data) {
@@ -538,12 +527,11 @@ auto getMediaFunc = [](napi_env env, void *data) {
 
 napi_value ResourceManagerAddon::GetMedia(napi_env env, napi_callback_info info)
 {
-    return ProcessOnlyIdParam(env, info, "getMedia", getMediaFunc);
+    return ProcessOnlyIdParam(env, info, "getMedia", getMediaFunc, PARAM_ID);
 }
 
 auto getMediaBase64Func = [](napi_env env, void *data) {
     ResMgrAsyncContext *asyncContext = static_cast<ResMgrAsyncContext*>(data);
-    int len = 0;
     std::string path;
     RState state;
     if (asyncContext->resId_ != 0) {
@@ -555,17 +543,26 @@ auto getMediaBase64Func = [](napi_env env, void *data) {
         asyncContext->SetErrorMsg("GetMedia path failed", true);
         return;
     }
-    std::unique_ptr<char[]> tempData = LoadResourceFile(path, *asyncContext, len);
-    if (tempData == nullptr) {
+    struct stat fileStat = {};
+    if (stat(path.c_str(), &fileStat) != 0) {
+        asyncContext->SetErrorMsg("Failed to open media");
         return;
     }
-    auto pos = path.find_last_of('.');
-    std::string imgType;
-    if (pos != std::string::npos) {
-        imgType = path.substr(pos + 1);
+    if (!g_mediaBase64Cache.Get(path, fileStat.st_mtime, fileStat.st_size, asyncContext->value_)) {
+        std::shared_ptr<const MappedFile> tempData = LoadResourceFile(path, *asyncContext);
+        if (tempData == nullptr) {
+            return;
+        }
+        auto pos = path.find_last_of('.');
+        std::string imgType;
+        if (pos != std::string::npos) {
+            imgType = path.substr(pos + 1);
+        }
+        std::string &value = asyncContext->value_;
+        value = "data:image/" + imgType + ";base64,";
+        Base64::Encode(tempData->Data(), tempData->Size(), value);
+        g_mediaBase64Cache.Put(path, fileStat.st_mtime, fileStat.st_size, value);
     }
-    std::unique_ptr<char[]> base64Data = EncodeBase64(tempData, len);
-    asyncContext->value_ = "data:image/" + imgType + ";base64," + base64Data.get();
     asyncContext->createValueFunc_ = [](napi_env env, ResMgrAsyncContext &context) {
         napi_value result;
         if (napi_create_string_utf8(env, context.value_.c_str(), NAPI_AUTO_LENGTH, &result) != napi_ok) {
@@ -578,12 +575,12 @@ auto getMediaBase64Func = [](napi_env env, void *data) {
 
 napi_value ResourceManagerAddon::GetMediaBase64(napi_env env, napi_callback_info info)
 {
-    return ProcessOnlyIdParam(env, info, "GetMediaBase64", getMediaBase64Func);
+    return ProcessOnlyIdParam(env, info, "GetMediaBase64", getMediaBase64Func, PARAM_ID);
 }
 
 napi_value ResourceManagerAddon::GetMediaBase64ByName(napi_env env, napi_callback_info info)
 {
-    return ProcessOnlyIdParam(env, info, "GetMediaBase64ByName", getMediaBase64Func);
+    return ProcessOnlyIdParam(env, info, "GetMediaBase64ByName", getMediaBase64Func, PARAM_NAME);
 }
 
 napi_value ResourceManagerAddon::Release(napi_env env, napi_callback_info info)
@@ -854,7 +851,7 @@ auto g_getRawFileFunc = [](napi_env env, void* data) {
 
 napi_value ResourceManagerAddon::GetRawFile(napi_env env, napi_callback_info info)
 {
-    return ProcessOnlyIdParam(env, info, "getRawFile", g_getRawFileFunc);
+    return ProcessOnlyIdParam(env, info, "getRawFile", g_getRawFileFunc, PARAM_PATH);
 }
 
 auto g_getRawFileDescriptorFunc = [](napi_env env, void* data) {
@@ -914,7 +911,7 @@ auto g_getRawFileDescriptorFunc = [](napi_env env, void* data) {
 
 napi_value ResourceManagerAddon::GetRawFileDescriptor(napi_env env, napi_callback_info info)
 {
-    return ProcessOnlyIdParam(env, info, "getRawFileDescriptor", g_getRawFileDescriptorFunc);
+    return ProcessOnlyIdParam(env, info, "getRawFileDescriptor", g_getRawFileDescriptorFunc, PARAM_PATH);
 }
 
 auto closeRawFileDescriptorFunc = [](napi_env env, void* data) {
@@ -935,7 +932,7 @@ auto closeRawFileDescriptorFunc = [](napi_env env, void* data) {
 
 napi_value ResourceManagerAddon::CloseRawFileDescriptor(napi_env env, napi_callback_info info)
 {
-    return ProcessOnlyIdParam(env, info, "closeRawFileDescriptor", closeRawFileDescriptorFunc);
+    return ProcessOnlyIdParam(env, info, "closeRawFileDescriptor", closeRawFileDescriptorFunc, PARAM_PATH);
 }
 
 std::shared_ptr<ResourceManagerAddon> getResourceManagerAddon(napi_env env, napi_callback_info info)
@@ -977,55 +974,148 @@ bool isNapiString(napi_env env, napi_callback_info info)
     return true;
 }
 
-napi_value ResourceManagerAddon::GetStringSync(napi_env env, napi_callback_info info)
+napi_value ResourceManagerAddon::GetCachedValue(napi_env env, const std::string &key)
 {
-    GET_PARAMS(env, info, 2);
-
-    if (!isNapiNumber(env, info)) {
+    uint32_t generation = 0;
+    if (!resMgr_->GetGeneration(generation)) {
         return nullptr;
     }
-
-    std::unique_ptr<ResMgrAsyncContext> asyncContext = std::make_unique<ResMgrAsyncContext>();
-    asyncContext->addon_ = getResourceManagerAddon(env, info);
-    asyncContext->resId_ = GetResId(env, argc, argv);
-
-    RState state = asyncContext->addon_->GetResMgr()->GetStringById(asyncContext->resId_, asyncContext->value_);
-    if (state != RState::SUCCESS) {
-        asyncContext->SetErrorMsg("GetStringSync failed state", true);
+    if (generation != valueCacheGeneration_) {
+        // the resources or the config are changed, none of the values is valid
+        ClearValueCache(env);
+        valueCacheGeneration_ = generation;
         return nullptr;
     }
+    auto iter = valueCache_.find(key);
+    if (iter == valueCache_.end()) {
+        return nullptr;
+    }
+    napi_value value = nullptr;
+    if (napi_get_reference_value(env, iter->second, &value) != napi_ok) {
+        return nullptr;
+    }
+    return value;
+}
 
-    napi_value jsValue = nullptr;
-    if (napi_create_string_utf8(env, asyncContext->value_.c_str(), NAPI_AUTO_LENGTH, &jsValue) != napi_ok) {
-        asyncContext->SetErrorMsg("Failed to create jsValue");
+void ResourceManagerAddon::CacheValue(napi_env env, const std::string &key, napi_value value)
+{
+    // the values can not be invalidated without the generation
+    uint32_t generation = 0;
+    if (!resMgr_->GetGeneration(generation)) {
+        return;
     }
-    return jsValue;
+    if (valueCache_.size() >= MAX_VALUE_CACHE_SIZE) {
+        ClearValueCache(env);
+    }
+    napi_ref ref = nullptr;
+    if (napi_create_reference(env, value, 1, &ref) != napi_ok) {
+        return;
+    }
+    auto iter = valueCache_.find(key);
+    if (iter != valueCache_.end()) {
+        napi_delete_reference(env, iter->second);
+        iter->second = ref;
+        return;
+    }
+    valueCache_.emplace(key, ref);
 }
 
-napi_value ResourceManagerAddon::GetStringByNameSync(napi_env env, napi_callback_info info)
+void ResourceManagerAddon::ClearValueCache(napi_env env)
 {
-    GET_PARAMS(env, info, 2);
+    for (auto iter = valueCache_.begin(); iter != valueCache_.end(); ++iter) {
+        napi_delete_reference(env, iter->second);
+    }
+    valueCache_.clear();
+}
 
-    if (!isNapiString(env, info)) {
+napi_value ResourceManagerAddon::Trim(napi_env env, napi_callback_info info)
+{
+    GET_PARAMS(env, info, 1);
+
+    napi_value undefined;
+    if (napi_get_undefined(env, &undefined) != napi_ok) {
         return nullptr;
     }
+    int32_t level = TRIM_CACHES;
+    napi_valuetype valueType = napi_undefined;
+    if (argc > 0 && napi_typeof(env, argv[0], &valueType) == napi_ok && valueType == napi_number &&
+        napi_get_value_int32(env, argv[0], &level) != napi_ok) {
+        HiLog::Error(LABEL, "Failed to get trim level");
+        return undefined;
+    }
+    std::shared_ptr<ResourceManagerAddon> addon = getResourceManagerAddon(env, info);
+    if (addon == nullptr) {
+        return undefined;
+    }
+    // the values are referenced on the JS thread only, so they are dropped here rather than by the manager
+    addon->ClearValueCache(env);
+    g_mediaBase64Cache.Clear();
+    addon->resMgr_->Trim((level >= TRIM_ALL) ? TRIM_ALL : TRIM_CACHES);
+    return undefined;
+}
+
+napi_value ResourceManagerAddon::ProcessSync(napi_env env, napi_callback_info info, const std::string &name,
+    napi_async_execute_callback execute, ParamKind kind, bool cacheable)
+{
+    GET_PARAMS(env, info, 2);
 
     std::unique_ptr<ResMgrAsyncContext> asyncContext = std::make_unique<ResMgrAsyncContext>();
     asyncContext->addon_ = getResourceManagerAddon(env, info);
-    asyncContext->resName_ = GetResNameOrPath(env, argc, argv);
-
-    RState state = asyncContext->addon_->GetResMgr()->GetStringByName(asyncContext->resName_.c_str(),
-        asyncContext->value_);
-    if (state != RState::SUCCESS) {
-        asyncContext->SetErrorMsg("GetStringByNameSync failed state", true);
+    if (asyncContext->addon_ == nullptr || argc == 0) {
+        HiLog::Error(LABEL, "Invalid params of %{public}s", name.c_str());
         return nullptr;
     }
+    if (kind == PARAM_ID) {
+        if (!isNapiNumber(env, info)) {
+            return nullptr;
+        }
+        asyncContext->resId_ = GetResId(env, argc, argv);
+    } else {
+        if (!isNapiString(env, info)) {
+            return nullptr;
+        }
+        if (kind == PARAM_NAME) {
+            asyncContext->resName_ = GetResNameOrPath(env, argc, argv);
+        } else {
+            asyncContext->path_ = GetResNameOrPath(env, argc, argv);
+        }
+    }
+    if (argc > 1) {
+        napi_valuetype valueType = napi_valuetype::napi_undefined;
+        napi_typeof(env, argv[1], &valueType);
+        if (valueType == napi_number) {
+            napi_get_value_int32(env, argv[1], &asyncContext->param_);
+        }
+    }
 
-    napi_value jsValue = nullptr;
-    if (napi_create_string_utf8(env, asyncContext->value_.c_str(), NAPI_AUTO_LENGTH, &jsValue) != napi_ok) {
-        asyncContext->SetErrorMsg("Failed to create jsValue");
+    std::string key;
+    if (cacheable) {
+        key = name + ":" + ((asyncContext->resId_ != 0) ? std::to_string(asyncContext->resId_) :
+            asyncContext->resName_) + ":" + std::to_string(asyncContext->param_);
+        napi_value cached = asyncContext->addon_->GetCachedValue(env, key);
+        if (cached != nullptr) {
+            return cached;
+        }
     }
-    return jsValue;
+    execute(env, asyncContext.get());
+    if (!asyncContext->success_ || asyncContext->createValueFunc_ == nullptr) {
+        return nullptr;
+    }
+    napi_value result = asyncContext->createValueFunc_(env, *asyncContext);
+    if (cacheable && result != nullptr && asyncContext->success_) {
+        asyncContext->addon_->CacheValue(env, key, result);
+    }
+    return result;
+}
+
+napi_value ResourceManagerAddon::GetStringSync(napi_env env, napi_callback_info info)
+{
+    return ProcessSync(env, info, "getStringSync", getStringFunc, PARAM_ID, true);
+}
+
+napi_value ResourceManagerAddon::GetStringByNameSync(napi_env env, napi_callback_info info)
+{
+    return ProcessSync(env, info, "getStringByNameSync", getStringByNameFunc, PARAM_NAME, true);
 }
 
 napi_value ResourceManagerAddon::GetBoolean(napi_env env, napi_callback_info info)
@@ -1145,6 +1235,276 @@ napi_value ResourceManagerAddon::GetNumberByName(napi_env env, napi_callback_inf
     }
     return jsValue;
 }
+
+auto getColorFunc = [](napi_env env, void *data) {
+    ResMgrAsyncContext *asyncContext = static_cast<ResMgrAsyncContext*>(data);
+    RState state;
+    if (asyncContext->resId_ != 0) {
+        state = asyncContext->addon_->GetResMgr()->GetColorById(asyncContext->resId_, asyncContext->colorValue_);
+    } else {
+        state = asyncContext->addon_->GetResMgr()->GetColorByName(asyncContext->resName_.c_str(),
+            asyncContext->colorValue_);
+    }
+    if (state != RState::SUCCESS) {
+        asyncContext->SetErrorMsg("GetColor failed state", true);
+        return;
+    }
+    asyncContext->createValueFunc_ = [](napi_env env, ResMgrAsyncContext &context) {
+        napi_value jsValue = nullptr;
+        if (napi_create_uint32(env, context.colorValue_, &jsValue) != napi_ok) {
+            context.SetErrorMsg("Failed to create result", true);
+        }
+        return jsValue;
+    };
+};
+
+napi_value ResourceManagerAddon::GetColor(napi_env env, napi_callback_info info)
+{
+    return ProcessOnlyIdParam(env, info, "getColor", getColorFunc, PARAM_ID);
+}
+
+napi_value ResourceManagerAddon::GetColorByName(napi_env env, napi_callback_info info)
+{
+    return ProcessOnlyIdParam(env, info, "getColorByName", getColorFunc, PARAM_NAME);
+}
+
+napi_value ResourceManagerAddon::GetColorSync(napi_env env, napi_callback_info info)
+{
+    return ProcessSync(env, info, "getColorSync", getColorFunc, PARAM_ID, true);
+}
+
+napi_value ResourceManagerAddon::GetColorByNameSync(napi_env env, napi_callback_info info)
+{
+    return ProcessSync(env, info, "getColorByNameSync", getColorFunc, PARAM_NAME, true);
+}
+
+napi_value ResourceManagerAddon::GetStringArraySync(napi_env env, napi_callback_info info)
+{
+    return ProcessSync(env, info, "getStringArraySync", getStringArrayFunc, PARAM_ID, false);
+}
+
+napi_value ResourceManagerAddon::GetStringArrayByNameSync(napi_env env, napi_callback_info info)
+{
+    return ProcessSync(env, info, "getStringArrayByNameSync", getStringArrayFunc, PARAM_NAME, false);
+}
+
+napi_value ResourceManagerAddon::GetPluralStringSync(napi_env env, napi_callback_info info)
+{
+    return ProcessSync(env, info, "getPluralStringSync", getPluralCapFunc, PARAM_ID, true);
+}
+
+napi_value ResourceManagerAddon::GetPluralStringByNameSync(napi_env env, napi_callback_info info)
+{
+    return ProcessSync(env, info, "getPluralStringByNameSync", getPluralCapFunc, PARAM_NAME, true);
+}
+
+napi_value ResourceManagerAddon::GetMediaSync(napi_env env, napi_callback_info info)
+{
+    return ProcessSync(env, info, "getMediaSync", getMediaFunc, PARAM_ID, false);
+}
+
+napi_value ResourceManagerAddon::GetMediaByNameSync(napi_env env, napi_callback_info info)
+{
+    return ProcessSync(env, info, "getMediaByNameSync", getMediaByNameFunc, PARAM_NAME, false);
+}
+
+napi_value ResourceManagerAddon::GetMediaBase64Sync(napi_env env, napi_callback_info info)
+{
+    return ProcessSync(env, info, "getMediaBase64Sync", getMediaBase64Func, PARAM_ID, false);
+}
+
+napi_value ResourceManagerAddon::GetMediaBase64ByNameSync(napi_env env, napi_callback_info info)
+{
+    return ProcessSync(env, info, "getMediaBase64ByNameSync", getMediaBase64Func, PARAM_NAME, false);
+}
+
+napi_value ResourceManagerAddon::GetRawFileSync(napi_env env, napi_callback_info info)
+{
+    return ProcessSync(env, info, "getRawFileSync", g_getRawFileFunc, PARAM_PATH, false);
+}
+
+bool ResourceManagerAddon::GetBatchKeys(napi_env env, napi_value array, ResMgrAsyncContext &context)
+{
+    bool isArray = false;
+    if (napi_is_array(env, array, &isArray) != napi_ok || !isArray) {
+        HiLog::Error(LABEL, "Invalid param, not array");
+        return false;
+    }
+    uint32_t length = 0;
+    if (napi_get_array_length(env, array, &length) != napi_ok) {
+        HiLog::Error(LABEL, "Failed to get array length");
+        return false;
+    }
+    context.resIds_.resize(length, 0);
+    context.resNames_.resize(length);
+    for (uint32_t i = 0; i < length; i++) {
+        napi_value element = nullptr;
+        if (napi_get_element(env, array, i, &element) != napi_ok) {
+            HiLog::Error(LABEL, "Failed to get element %{public}u", i);
+            return false;
+        }
+        napi_valuetype valueType = napi_valuetype::napi_undefined;
+        napi_typeof(env, element, &valueType);
+        if (valueType == napi_number) {
+            context.resIds_[i] = GetResId(env, 1, &element);
+        } else if (valueType == napi_string) {
+            context.resNames_[i] = GetResNameOrPath(env, 1, &element);
+        } else {
+            HiLog::Error(LABEL, "Invalid element %{public}u, neither id nor name", i);
+            return false;
+        }
+    }
+    context.resolved_.resize(length, false);
+    return true;
+}
+
+napi_value ResourceManagerAddon::ProcessBatchParam(napi_env env, napi_callback_info info, const std::string &name,
+    napi_async_execute_callback execute)
+{
+    GET_PARAMS(env, info, 2);
+
+    std::unique_ptr<ResMgrAsyncContext> asyncContext = std::make_unique<ResMgrAsyncContext>();
+    asyncContext->addon_ = getResourceManagerAddon(env, info);
+    if (asyncContext->addon_ == nullptr || argc == 0 || !GetBatchKeys(env, argv[0], *asyncContext)) {
+        HiLog::Error(LABEL, "Invalid params of %{public}s", name.c_str());
+        return nullptr;
+    }
+    if (argc > 1) {
+        napi_valuetype valueType = napi_valuetype::napi_undefined;
+        napi_typeof(env, argv[1], &valueType);
+        if (valueType == napi_function) {
+            napi_create_reference(env, argv[1], 1, &asyncContext->callbackRef_);
+        }
+    }
+
+    napi_value result = nullptr;
+    if (asyncContext->callbackRef_ == nullptr) {
+        napi_create_promise(env, &asyncContext->deferred_, &result);
+    } else {
+        napi_get_undefined(env, &result);
+    }
+
+    // all the keys are resolved by one work, and the results handed back by one complete
+    napi_value resource = nullptr;
+    napi_create_string_utf8(env, name.c_str(), NAPI_AUTO_LENGTH, &resource);
+    if (napi_create_async_work(env, nullptr, resource, execute, ResMgrAsyncContext::Complete,
+        static_cast<void*>(asyncContext.get()), &asyncContext->work_) != napi_ok) {
+        HiLog::Error(LABEL, "Failed to create async work for %{public}s", name.c_str());
+        return result;
+    }
+    if (napi_queue_async_work(env, asyncContext->work_) != napi_ok) {
+        HiLog::Error(LABEL, "Failed to queue async work for %{public}s", name.c_str());
+        return result;
+    }
+
+    asyncContext.release();
+    return result;
+}
+
+napi_value ResourceManagerAddon::ProcessBatchParamSync(napi_env env, napi_callback_info info,
+    const std::string &name, napi_async_execute_callback execute)
+{
+    GET_PARAMS(env, info, 2);
+
+    std::unique_ptr<ResMgrAsyncContext> asyncContext = std::make_unique<ResMgrAsyncContext>();
+    asyncContext->addon_ = getResourceManagerAddon(env, info);
+    if (asyncContext->addon_ == nullptr || argc == 0 || !GetBatchKeys(env, argv[0], *asyncContext)) {
+        HiLog::Error(LABEL, "Invalid params of %{public}s", name.c_str());
+        return nullptr;
+    }
+    execute(env, asyncContext.get());
+    return asyncContext->createValueFunc_(env, *asyncContext);
+}
+
+// the keys failed to resolve are undefined in the result array
+napi_value CreateBatchValue(napi_env env, ResMgrAsyncContext &context, bool isNumber)
+{
+    napi_value result = nullptr;
+    if (napi_create_array_with_length(env, context.resolved_.size(), &result) != napi_ok) {
+        context.SetErrorMsg("Failed to create array");
+        return nullptr;
+    }
+    for (size_t i = 0; i < context.resolved_.size(); i++) {
+        napi_value value = nullptr;
+        napi_status status;
+        if (!context.resolved_[i]) {
+            status = napi_get_undefined(env, &value);
+        } else if (isNumber) {
+            status = napi_create_double(env, context.numberValues_[i], &value);
+        } else {
+            status = napi_create_string_utf8(env, context.arrayValue_[i].c_str(), NAPI_AUTO_LENGTH, &value);
+        }
+        if (status != napi_ok || napi_set_element(env, result, i, value) != napi_ok) {
+            context.SetErrorMsg("Failed to set element of array");
+            return nullptr;
+        }
+    }
+    return result;
+}
+
+auto getStringsFunc = [](napi_env env, void *data) {
+    ResMgrAsyncContext *asyncContext = static_cast<ResMgrAsyncContext*>(data);
+    std::shared_ptr<ResourceManager> resMgr = asyncContext->addon_->GetResMgr();
+    size_t count = asyncContext->resolved_.size();
+    asyncContext->arrayValue_.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        RState state;
+        if (asyncContext->resIds_[i] != 0) {
+            state = resMgr->GetStringById(asyncContext->resIds_[i], asyncContext->arrayValue_[i]);
+        } else {
+            state = resMgr->GetStringByName(asyncContext->resNames_[i].c_str(), asyncContext->arrayValue_[i]);
+        }
+        asyncContext->resolved_[i] = (state == RState::SUCCESS);
+    }
+    asyncContext->createValueFunc_ = [](napi_env env, ResMgrAsyncContext &context) {
+        return CreateBatchValue(env, context, false);
+    };
+};
+
+napi_value ResourceManagerAddon::GetStrings(napi_env env, napi_callback_info info)
+{
+    return ProcessBatchParam(env, info, "getStrings", getStringsFunc);
+}
+
+napi_value ResourceManagerAddon::GetStringsSync(napi_env env, napi_callback_info info)
+{
+    return ProcessBatchParamSync(env, info, "getStringsSync", getStringsFunc);
+}
+
+auto getNumbersFunc = [](napi_env env, void *data) {
+    ResMgrAsyncContext *asyncContext = static_cast<ResMgrAsyncContext*>(data);
+    std::shared_ptr<ResourceManager> resMgr = asyncContext->addon_->GetResMgr();
+    size_t count = asyncContext->resolved_.size();
+    asyncContext->numberValues_.resize(count, 0);
+    for (size_t i = 0; i < count; i++) {
+        // an integer, else a float
+        int32_t id = asyncContext->resIds_[i];
+        const char *name = asyncContext->resNames_[i].c_str();
+        int iValue = 0;
+        RState state = (id != 0) ? resMgr->GetIntegerById(id, iValue) : resMgr->GetIntegerByName(name, iValue);
+        if (state == RState::SUCCESS) {
+            asyncContext->numberValues_[i] = iValue;
+        } else {
+            float fValue = 0.0f;
+            state = (id != 0) ? resMgr->GetFloatById(id, fValue) : resMgr->GetFloatByName(name, fValue);
+            asyncContext->numberValues_[i] = fValue;
+        }
+        asyncContext->resolved_[i] = (state == RState::SUCCESS);
+    }
+    asyncContext->createValueFunc_ = [](napi_env env, ResMgrAsyncContext &context) {
+        return CreateBatchValue(env, context, true);
+    };
+};
+
+napi_value ResourceManagerAddon::GetNumbers(napi_env env, napi_callback_info info)
+{
+    return ProcessBatchParam(env, info, "getNumbers", getNumbersFunc);
+}
+
+napi_value ResourceManagerAddon::GetNumbersSync(napi_env env, napi_callback_info info)
+{
+    return ProcessBatchParamSync(env, info, "getNumbersSync", getNumbersFunc);
+}
 } // namespace Resource
 } // namespace Global
 } // namespace OHOS
\ No newline at end of file
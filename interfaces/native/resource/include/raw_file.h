@@ -143,7 +143,8 @@ long OH_ResourceManager_GetRawFileOffset(const RawFile *rawFile);
 /**
  * @brief Opens the file descriptor of a raw file based on the int32_t offset and file length.
  *
- * The opened raw file descriptor is used to read the raw file.
+ * The opened raw file descriptor is used to read the raw file. It is not available for a raw file compressed in
+ * the HAP.
  *
  * @param rawFile Indicates the pointer to {@link RawFile}.
  * @param descriptor Indicates the raw file's file descriptor, start position and the length in the HAP.
@@ -165,6 +166,96 @@ bool OH_ResourceManager_GetRawFileDescriptor(const RawFile *rawFile, RawFileDesc
  */
 bool OH_ResourceManager_ReleaseRawFileDescriptor(const RawFileDescriptor &descriptor);
 
+/**
+ * @brief Enumerates the access patterns of a raw file, they are hints for the system to read ahead or not.
+ *
+ * @since 9
+ * @version 1.0
+ */
+typedef enum {
+    /** no special treatment */
+    RAWFILE_ADVICE_NORMAL = 0,
+
+    /** the raw file is read from the start to the end, read ahead aggressively */
+    RAWFILE_ADVICE_SEQUENTIAL = 1,
+
+    /** the raw file is read at random offsets, do not read ahead */
+    RAWFILE_ADVICE_RANDOM = 2,
+
+    /** the raw file will be read soon, start reading it now */
+    RAWFILE_ADVICE_WILLNEED = 3,
+
+    /** the raw file will not be read soon, its cached pages can be dropped */
+    RAWFILE_ADVICE_DONTNEED = 4,
+} RawFileAdvice;
+
+/**
+ * @brief Reads a raw file at the specified offset.
+ *
+ * Unlike {@link OH_ResourceManager_ReadRawFile}, this function does not use or move the current offset, so a raw
+ * file can be read by several threads at the same time.
+ *
+ * @param rawFile Indicates the pointer to {@link RawFile}.
+ * @param buf Indicates the pointer to the buffer for receiving the data read.
+ * @param length Indicates the number of bytes to read.
+ * @param offset Indicates the offset to read from, relative to the start of the raw file.
+ * @return Returns the number of bytes read if any; returns <b>0</b> if the offset reaches the end of file (EOF);
+ * returns <b>-1</b> if an error occurs.
+ * @since 9
+ * @version 1.0
+ */
+long OH_ResourceManager_ReadRawFileAt(const RawFile *rawFile, void *buf, size_t length, long offset);
+
+/**
+ * @brief Maps the content of a raw file into memory.
+ *
+ * The mapped content is read only and stays valid after the raw file is closed, until it is unmapped by
+ * {@link OH_ResourceManager_UnmapRawFile}. It is not available for a raw file compressed in the HAP.
+ *
+ * @param rawFile Indicates the pointer to {@link RawFile}.
+ * @param length Indicates the pointer to receive the length of the mapped content.
+ * @return Returns the start address of the mapped content; returns <b>nullptr</b> if the raw file can not be mapped
+ * or it is empty.
+ * @since 9
+ * @version 1.0
+ */
+const void *OH_ResourceManager_MapRawFile(const RawFile *rawFile, long *length);
+
+/**
+ * @brief Unmaps the content of a raw file mapped by {@link OH_ResourceManager_MapRawFile}.
+ *
+ * @param data Indicates the start address returned by {@link OH_ResourceManager_MapRawFile}.
+ * @param length Indicates the length of the mapped content.
+ * @return Returns true: unmaps successfully, false: unmaps failed.
+ * @since 9
+ * @version 1.0
+ */
+bool OH_ResourceManager_UnmapRawFile(const void *data, long length);
+
+/**
+ * @brief Advises the system how a raw file will be read by {@link OH_ResourceManager_ReadRawFile} or
+ * {@link OH_ResourceManager_ReadRawFileAt}.
+ *
+ * @param rawFile Indicates the pointer to {@link RawFile}.
+ * @param advice Indicates the access pattern, one of {@link RawFileAdvice}.
+ * @return Returns true: the advice is applied, false: the advice failed or the raw file is compressed in the HAP.
+ * @since 9
+ * @version 1.0
+ */
+bool OH_ResourceManager_AdviseRawFile(const RawFile *rawFile, int advice);
+
+/**
+ * @brief Advises the system how the content mapped by {@link OH_ResourceManager_MapRawFile} will be accessed.
+ *
+ * @param data Indicates the start address returned by {@link OH_ResourceManager_MapRawFile}.
+ * @param length Indicates the length of the mapped content.
+ * @param advice Indicates the access pattern, one of {@link RawFileAdvice}.
+ * @return Returns true: the advice is applied, false: the advice failed.
+ * @since 9
+ * @version 1.0
+ */
+bool OH_ResourceManager_AdviseMappedRawFile(const void *data, long length, int advice);
+
 #ifdef __cplusplus
 };
 #endif
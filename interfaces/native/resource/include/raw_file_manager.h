@@ -118,6 +118,100 @@ RawDir *OH_ResourceManager_OpenRawDir(const NativeResourceManager *mgr, const ch
  */
 RawFile *OH_ResourceManager_OpenRawFile(const NativeResourceManager *mgr, const char *fileName);
 
+/**
+ * @brief Describes one read of a raw file batch.
+ *
+ * @since 9
+ * @version 1.0
+ */
+typedef struct {
+    /** the file path relative to the top-level raw file directory */
+    const char *fileName;
+
+    /** the offset to read from, relative to the start of the raw file */
+    long offset;
+
+    /** the number of bytes to read */
+    size_t length;
+
+    /** the buffer receiving the data read, at least <b>length</b> bytes */
+    void *buf;
+
+    /** set when the batch is done: the number of bytes read, <b>0</b> at the end of file, <b>-1</b> if failed */
+    long result;
+} RawFileReadRequest;
+
+struct RawFileBatch;
+
+/**
+ * @brief Provides access to a batch of raw file reads in progress.
+ *
+ * @since 9
+ * @version 1.0
+ */
+typedef struct RawFileBatch RawFileBatch;
+
+/**
+ * @brief Called once all reads of a batch are done, on a worker thread.
+ *
+ * The batch is done when it is called, so it can release the batch by {@link OH_ResourceManager_ReleaseRawFileBatch}.
+ *
+ * @param requests Indicates the requests passed to {@link OH_ResourceManager_SubmitRawFileBatch}.
+ * @param count Indicates the number of requests.
+ * @param userData Indicates the user data passed to {@link OH_ResourceManager_SubmitRawFileBatch}.
+ * @since 9
+ * @version 1.0
+ */
+typedef void (*RawFileBatchCallback)(RawFileReadRequest *requests, size_t count, void *userData);
+
+/**
+ * @brief Submits a batch of raw file reads, they are done in the background.
+ *
+ * The raw files are looked up together, then the reads of different raw files run in parallel. The requests and
+ * their buffers must stay valid until the batch is done and its callback has returned.
+ *
+ * @param mgr Indicates the pointer to {@link NativeResourceManager} obtained by calling
+ * {@link OH_ResourceManager_InitNativeResourceManager}.
+ * @param requests Indicates the reads, their <b>result</b> is set when the batch is done.
+ * @param count Indicates the number of requests.
+ * @param callback Indicates the function called when the batch is done, it can be nullptr.
+ * @param userData Indicates the user data passed to <b>callback</b>.
+ * @return Returns the pointer to {@link RawFileBatch}. After you finish using the pointer, call
+ * {@link OH_ResourceManager_ReleaseRawFileBatch} to release it.
+ * @since 9
+ * @version 1.0
+ */
+RawFileBatch *OH_ResourceManager_SubmitRawFileBatch(const NativeResourceManager *mgr, RawFileReadRequest *requests,
+    size_t count, RawFileBatchCallback callback, void *userData);
+
+/**
+ * @brief Checks whether all reads of a batch are done, without blocking.
+ *
+ * @param batch Indicates the pointer to {@link RawFileBatch}.
+ * @return Returns true if all reads of the batch are done, its callback may be still running.
+ * @since 9
+ * @version 1.0
+ */
+bool OH_ResourceManager_IsRawFileBatchDone(const RawFileBatch *batch);
+
+/**
+ * @brief Waits until all reads of a batch are done.
+ *
+ * @param batch Indicates the pointer to {@link RawFileBatch}.
+ * @since 9
+ * @version 1.0
+ */
+void OH_ResourceManager_WaitRawFileBatch(const RawFileBatch *batch);
+
+/**
+ * @brief Releases a batch, it waits until all reads of the batch are done.
+ *
+ * @param batch Indicates the pointer to {@link RawFileBatch}.
+ * @since 9
+ * @version 1.0
+ */
+void OH_ResourceManager_ReleaseRawFileBatch(RawFileBatch *batch);
+
 #ifdef __cplusplus
 };
 #endif